@@ -25,12 +25,27 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include <math.h>
 #include <string.h>
 
 #include "../../Sensors/bmp280/bmp280.h"
 #include "../../Sensors/bmp280/bmp280_application.h"
 
 #include "../../Sensors/vl6180x/vl6180x_application.h"
+
+#include "../../Sensors/filter/filter.h"
+#include "../../Sensors/filter/filter_benchmark.h"
+#include "../../Sensors/filter/fusion.h"
+
+#include "../../Sensors/common/sensor_cycles.h"
+#include "../../Sensors/common/sensor_format.h"
+#include "../../Sensors/common/sensor_log.h"
+#include "../../Sensors/common/sensor_memory.h"
+#include "../../Sensors/common/sensor_record.h"
+#include "../../Sensors/common/sensor_registry.h"
+
+#include "../../Sensors/console/console.h"
+#include "../../Sensors/console/console_commands.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -69,15 +84,55 @@ void bmp280_loop()
 	bmp280_application_initialize();
 
 	double altitude;
-	uint8_t msg[64];
-	uint16_t msg_len;
+	double humidity;
+	int32_t altitude_filtered_mm;
+	uint32_t timestamp_ms;
+	uint32_t duty_cycle_ppm;
+	uint32_t rate_mHz;
+	uint8_t msg[128];
+	sensor_format_struct format;
+
+	// altitude in mm: reject pressure glitches, then average
+	filter_outlier_struct outlier;
+	filter_moving_average_struct moving_average;
+	filter_outlier_initialize(&outlier, 2000, 2);
+	filter_moving_average_initialize(&moving_average, 8);
+	const filter_stage_struct altitude_filter[] = {filter_stage_outlier(&outlier), filter_stage_moving_average(&moving_average)};
 
 	while(true)
 	{
-		bmp280_application_get_altitude_delta(&altitude);
-
-		msg_len = (uint16_t)sprintf((char*)msg, "BMP280: Altitude: %7.3f cm\r\n", altitude*100);
-		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+		if (bmp280_application_read_measurement(&altitude, &timestamp_ms) == false)
+		{
+			HAL_Delay(2000);
+			continue;
+		}
+		altitude_filtered_mm = filter_pipeline_process(altitude_filter, 2, (int32_t)(altitude * 1000));
+		bmp280_application_get_duty_cycle(&duty_cycle_ppm, &rate_mHz);
+
+		// no float printf: altitude in 1/1000 cm, humidity in 1/100 %RH
+		sensor_format_initialize(&format, (char*)msg, sizeof(msg));
+		sensor_format_text(&format, "BMP280: Altitude: ");
+		sensor_format_fixed(&format, (int32_t)lround(altitude * 100000), 3, 7);
+		sensor_format_text(&format, " cm (filtered: ");
+		sensor_format_int(&format, altitude_filtered_mm, 0);
+		sensor_format_text(&format, " mm) @ ");
+		sensor_format_uint(&format, timestamp_ms, 0);
+		sensor_format_text(&format, " ms | duty: ");
+		sensor_format_uint(&format, duty_cycle_ppm, 0);
+		sensor_format_text(&format, " ppm | dup: ");
+		sensor_format_uint(&format, bmp280_get_duplicate_count(), 0);
+		sensor_format_text(&format, "\r\n");
+		HAL_UART_Transmit(&huart2, msg, format.length, HAL_MAX_DELAY);
+
+		// BME280: humidity came with the same burst
+		if (bmp280_get_humidity(&humidity) == true)
+		{
+			sensor_format_initialize(&format, (char*)msg, sizeof(msg));
+			sensor_format_text(&format, "BME280: Humidity: ");
+			sensor_format_fixed(&format, (int32_t)lround(humidity * 100), 2, 6);
+			sensor_format_text(&format, " %RH\r\n");
+			HAL_UART_Transmit(&huart2, msg, format.length, HAL_MAX_DELAY);
+		}
 		HAL_Delay(2000);
 	}
 
@@ -97,6 +152,13 @@ void vl6180x_loop()
 	uint16_t data_length = 2; //sizeof(data_buffer)/ sizeof(data_buffer[0]);
 	uint16_t device_address = (0x29 << 1);
 
+	// distance in mm: remove spikes, then smooth
+	filter_median_struct median;
+	filter_iir_q31_struct iir;
+	filter_median_initialize(&median, 5);
+	filter_iir_q31_initialize(&iir, 8192);
+	const filter_stage_struct distance_filter[] = {filter_stage_median(&median), filter_stage_iir_q31(&iir)};
+
 
 	retval = HAL_I2C_Mem_Read(&hi2c3, device_address, 0x016, I2C_MEMADD_SIZE_16BIT, data_buffer, data_length, HAL_MAX_DELAY);
 	if (retval == HAL_OK)
@@ -137,12 +199,177 @@ void vl6180x_loop()
 	while(true && (result == true))
 	{
 		vl6180x_application_poll_measurement(&distance_mm);
-		msg_len = (uint16_t)sprintf((char*)msg, "VL6180X: Distance: %dmm\r\n", distance_mm);
+		msg_len = (uint16_t)sprintf((char*)msg, "VL6180X: Distance: %dmm (filtered: %ldmm)\r\n", distance_mm, (long)filter_pipeline_process(distance_filter, 2, distance_mm));
 		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
 
 		HAL_Delay(1000);
 	}
 }
+
+void fusion_loop()
+{
+	bool result;
+	uint8_t msg[92];
+	uint16_t msg_len;
+	vl6180x_range_quality_struct range_quality;
+	double altitude;
+	uint32_t altitude_tick_ms;
+	uint32_t previous_tick_ms;
+	fusion_struct fusion;
+	fusion_estimate_struct estimate;
+
+	// tuning validated with Tools/fusion_replay
+	fusion_initialize(&fusion, 50000, 25000, 4000000, 22500000000);
+
+	result = bmp280_application_initialize();
+	if (result == true)
+	{
+		result = vl6180x_application_initialize_device();
+	}
+	if (result == true)
+	{
+		result = vl6180x_application_set_ranging_profile(VL6180X_RANGING_PROFILE_BALANCED);
+	}
+	previous_tick_ms = HAL_GetTick();
+
+	while (result == true)
+	{
+		// barometer converts in the background and is only read once done
+		bool has_altitude = false;
+		if (bmp280_application_poll_measurement(&altitude, &altitude_tick_ms, &has_altitude) == false)
+		{
+			has_altitude = false;
+		}
+
+		// ToF at the ranging profile rate (~50 Hz) paces the loop, an invalid range only predicts
+		bool has_range = vl6180x_application_poll_range_quality(&range_quality);
+		uint32_t range_tick_ms = HAL_GetTick();
+
+		// updates in time order: the altitude belongs to the centre of its
+		// conversion, at the earliest the time of the previous update
+		if (has_altitude == true)
+		{
+			if ((int32_t)(altitude_tick_ms - previous_tick_ms) < 0)
+			{
+				altitude_tick_ms = previous_tick_ms;
+			}
+			fusion_predict(&fusion, altitude_tick_ms - previous_tick_ms);
+			fusion_update_altitude(&fusion, (int32_t)(altitude * 1e6));
+			previous_tick_ms = altitude_tick_ms;
+		}
+
+		fusion_predict(&fusion, range_tick_ms - previous_tick_ms);
+		previous_tick_ms = range_tick_ms;
+
+		if (has_range == true)
+		{
+			fusion_update_distance(&fusion, (int32_t)range_quality.range.distance_mm * 1000, range_quality.confidence);
+		}
+
+		estimate = fusion_get_estimate(&fusion);
+		msg_len = (uint16_t)sprintf((char*)msg, "FUSION: height: %ld um | variance: %lu mm^2\r\n", (long)estimate.height_um, (unsigned long)(estimate.variance_um2 / 1000000));
+		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+	}
+}
+
+
+void acquisition_print_sample(const sensor_driver_struct *driver, const sensor_sample_struct *sample)
+{
+	uint8_t msg[64];
+	sensor_format_struct format;
+
+	if (SENSOR_LOG_ENABLED(SENSOR_LOG_LEVEL_INFO))
+	{
+		sensor_format_initialize(&format, (char*)msg, sizeof(msg));
+		sensor_format_text(&format, driver->name);
+		sensor_format_text(&format, ": ");
+		sensor_format_int(&format, sample->value, 0);
+		sensor_format_char(&format, ' ');
+		sensor_format_text(&format, driver->unit);
+		sensor_format_text(&format, " @ ");
+		sensor_format_uint(&format, sample->timestamp_ms, 0);
+		sensor_format_text(&format, " ms\r\n");
+		HAL_UART_Transmit(&huart2, msg, format.length, HAL_MAX_DELAY);
+	}
+}
+
+
+void acquisition_loop()
+{
+	uint8_t msg[128];
+	uint16_t msg_len;
+	sensor_registry_stats_struct stats;
+	sensor_memory_usage_struct usage;
+	uint32_t stats_tick_ms = HAL_GetTick();
+	uint32_t memory_tick_ms = HAL_GetTick();
+
+#if SENSOR_RECORD_AT_BOOT
+	sensor_record_start();
+#endif
+
+	// runtime control over the ST-LINK virtual COM port, "help" lists the commands.
+	// Up before the probe, the console stays usable without any sensor.
+	console_commands_initialize();
+
+	// every sensor found on the bus, serviced by one loop
+	if (sensor_registry_probe() == 0)
+	{
+		msg_len = (uint16_t)sprintf((char*)msg, "REGISTRY - no sensor found, console only\r\n");
+		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+	}
+
+	while(true)
+	{
+		sensor_registry_service(&acquisition_print_sample);
+		console_process();
+
+		// periodic report only at INFO and above, "log error" keeps the console readable
+		if (HAL_GetTick() - stats_tick_ms >= 5000 && SENSOR_LOG_ENABLED(SENSOR_LOG_LEVEL_INFO))
+		{
+			stats_tick_ms = HAL_GetTick();
+			for (uint8_t n = 0; sensor_registry_get_stats(n, &stats) == true; n++)
+			{
+				msg_len = (uint16_t)sprintf((char*)msg, "%s - %lu mHz | invalid: %lu | not ready: %lu | errors: %lu | read: %lu %s\r\n",
+						sensor_registry_get_driver(n)->name, (unsigned long)stats.rate_mHz, (unsigned long)stats.invalid_count,
+						(unsigned long)stats.not_ready_count, (unsigned long)stats.error_count, (unsigned long)stats.read_time, SENSOR_CYCLES_UNIT);
+				HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+			}
+			sensor_memory_get_usage(&usage);
+			msg_len = (uint16_t)sprintf((char*)msg, "memory - stack: %lu/%lu | heap: %lu/%lu | headroom: %lu\r\n",
+					(unsigned long)usage.stack_peak, (unsigned long)usage.stack_reserved, (unsigned long)usage.heap_peak,
+					(unsigned long)usage.heap_reserved, (unsigned long)usage.headroom);
+			HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+		}
+
+		// stack about to reach the heap and .bss, reported even at "log error"
+		if (HAL_GetTick() - memory_tick_ms >= 1000 && SENSOR_LOG_ENABLED(SENSOR_LOG_LEVEL_ERROR))
+		{
+			memory_tick_ms = HAL_GetTick();
+			if (sensor_memory_check_headroom() == false)
+			{
+				msg_len = (uint16_t)sprintf((char*)msg, "memory - headroom below %u bytes or heap exhausted\r\n", SENSOR_MEMORY_HEADROOM_MIN);
+				HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+			}
+		}
+	}
+}
+
+
+void benchmark_loop()
+{
+	filter_benchmark_result_struct results[FILTER_BENCHMARK_STAGE_COUNT];
+	uint8_t msg[92];
+	uint16_t msg_len;
+
+	filter_benchmark_run(results);
+
+	for (uint8_t n = 0; n < FILTER_BENCHMARK_STAGE_COUNT; n++)
+	{
+		uint32_t ticks_per_sample_100 = (uint32_t)(((uint64_t)results[n].total_ticks * 100) / results[n].sample_count);
+		msg_len = (uint16_t)sprintf((char*)msg, "filter: %-16s %5lu.%02lu cycles/sample\r\n", results[n].name, (unsigned long)(ticks_per_sample_100 / 100), (unsigned long)(ticks_per_sample_100 % 100));
+		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+	}
+}
 /* USER CODE END 0 */
 
 /**
@@ -198,7 +425,10 @@ int main(void)
   }
 
 //  bmp280_loop();
-  vl6180x_loop();
+//  benchmark_loop();
+//  fusion_loop();
+//  vl6180x_loop();
+  acquisition_loop();
 
   msg_len = (uint16_t)sprintf((char *)msg, "Uh, we're not supposed to come here :/\r\n");
   HAL_UART_Transmit(&huart2, msg, msg_len, 1000);
@@ -29,6 +29,12 @@
  */
 static uint8_t *__sbrk_heap_end = NULL;
 
+/**
+ * Highest heap end so far and number of refused allocations
+ */
+static uint8_t *__sbrk_heap_peak = NULL;
+static uint32_t __sbrk_fail_count = 0;
+
 /**
  * @brief _sbrk() allocates memory to the newlib heap and is used by malloc
  *        and others from the C library
@@ -68,6 +74,7 @@ void *_sbrk(ptrdiff_t incr)
   /* Protect heap from growing into the reserved MSP stack */
   if (__sbrk_heap_end + incr > max_heap)
   {
+    __sbrk_fail_count++;
     errno = ENOMEM;
     return (void *)-1;
   }
@@ -75,5 +82,26 @@ void *_sbrk(ptrdiff_t incr)
   prev_heap_end = __sbrk_heap_end;
   __sbrk_heap_end += incr;
 
+  if (__sbrk_heap_end > __sbrk_heap_peak)
+  {
+    __sbrk_heap_peak = __sbrk_heap_end;
+  }
+
   return (void *)prev_heap_end;
 }
+
+/**
+ * @brief Heap accounting of _sbrk()
+ *
+ * @param used Bytes currently taken from the heap start '_end'
+ * @param peak Highest value of used since reset
+ * @param fail_count Number of requests refused to protect the MSP stack
+ */
+void _sbrk_get_usage(uint32_t *used, uint32_t *peak, uint32_t *fail_count)
+{
+  extern uint8_t _end; /* Symbol defined in the linker script */
+
+  *used = (__sbrk_heap_end == NULL) ? 0 : (uint32_t)(__sbrk_heap_end - &_end);
+  *peak = (__sbrk_heap_peak == NULL) ? 0 : (uint32_t)(__sbrk_heap_peak - &_end);
+  *fail_count = __sbrk_fail_count;
+}
@@ -44,6 +44,17 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start address for the initialization values of the .sram2_text section.
+defined in linker script */
+.word	_sisram2_text
+/* start/end address for the .sram2_text section. defined in linker script */
+.word	_ssram2_text
+.word	_esram2_text
+/* start/end address for the .sram2_bss section. defined in linker script */
+.word	_ssram2_bss
+.word	_esram2_bss
+/* start address of the heap, the heap and stack area is painted from here */
+.word	_end
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -95,6 +106,52 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the SRAM2 code from flash */
+  ldr r0, =_ssram2_text
+  ldr r1, =_esram2_text
+  ldr r2, =_sisram2_text
+  movs r3, #0
+  b LoopCopySram2Text
+
+CopySram2Text:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopySram2Text:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopySram2Text
+
+/* Zero fill the SRAM2 bss segment. */
+  ldr r2, =_ssram2_bss
+  ldr r4, =_esram2_bss
+  movs r3, #0
+  b LoopFillZeroSram2
+
+FillZeroSram2:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroSram2:
+  cmp r2, r4
+  bcc FillZeroSram2
+
+/* Paint the free RAM between heap start and stack pointer with the pattern
+   of SENSOR_MEMORY_PAINT (sensor_memory.h) for the high-watermark query. */
+  ldr r2, =_end
+  mov r4, sp
+  ldr r3, =0xC5C5C5C5
+  b LoopPaintStack
+
+PaintStack:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopPaintStack:
+  cmp r2, r4
+  bcc PaintStack
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -6,10 +6,13 @@
  */
 
 #include <math.h>
+#include <string.h>
 
 #include "bmp280.h"
 #include "usart.h"
 
+#include "../common/sensor_memory.h"
+
 
 //=============================================================================
 //	external functions
@@ -24,10 +27,40 @@ bmp280_sleep_function   *bmp280_sleep;
 //=============================================================================
 
 static bool bmp280_read_trimming_parameters();
+static void bmp280_prepare_coefficients();
 static bool bmp280_read_measurement_registers(uint8_t *measurement_data);
+static bool bmp280_read_new_measurement_registers(uint8_t *measurement_data, bool *is_new_data);
+static double bmp280_calculate_altitude_delta(double pressure);
+static uint32_t bmp280_get_oversampling_count(uint8_t oversampling_code);
 
 static bool bmp280_calculate_Temperature_100(uint8_t *measurement_data, int32_t *Temperature_100, int32_t *t_fine);
 static bool bmp280_calculate_Pressure_256(uint8_t *measurement_data, uint32_t *Pressure_256, int32_t t_fine);
+static bool bmp280_calculate_Humidity_1024(uint8_t *measurement_data, uint32_t *Humidity_1024, int32_t t_fine);
+
+//=============================================================================
+//	types
+//=============================================================================
+
+// trimming products that do not depend on the ADC values, in the order the
+// compensation uses them; set by bmp280_prepare_coefficients()
+typedef struct
+{
+	int32_t T1;
+	int32_t T1_x2;
+	int32_t T2;
+	int32_t T3;
+	int64_t P6;
+	int64_t P5_17;		// dig_P5 << 17
+	int64_t P4_35;		// dig_P4 << 35
+	int64_t P3;
+	int64_t P2_12;		// dig_P2 << 12
+	int64_t P1;
+	int64_t P1_47;		// dig_P1 << 47
+	int64_t P9;
+	int64_t P8;
+	int64_t P7_4;		// dig_P7 << 4
+}bmp280_coefficients_struct;
+
 
 //=============================================================================
 //	variables
@@ -49,10 +82,35 @@ int16_t dig_P7;
 int16_t dig_P8;
 int16_t dig_P9;
 
+// trimming parameters - humidity (BME280)
+uint8_t dig_H1;
+int16_t dig_H2;
+uint8_t dig_H3;
+int16_t dig_H4;
+int16_t dig_H5;
+int8_t dig_H6;
+
+// trimming folded for the compensation, next to the SRAM2 kernels
+static bmp280_coefficients_struct bmp280_coefficients SENSOR_SRAM2_DATA;
+
 // reference parameters
 double pressure_reference;
 double temperature_reference_over_Lb;
 
+// last value written to ctrl_meas, avoids a read-back when triggering forced measurements
+static uint8_t bmp280_measurement_control;
+static uint8_t bmp280_humidity_control;
+
+// BME280: humidity is read in the same burst as P/T
+static bool bmp280_is_bme280 = false;
+static uint16_t bmp280_measurement_length = BMP280_LENGTH_MEASUREMENT_DATA;
+static uint32_t bmp280_humidity_1024;	// %RH in Q22.10, from the last burst
+
+// new data detection
+static uint8_t bmp280_last_measurement_data[BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY];
+static bool bmp280_conversion_pending = false;	// a conversion started after the last read
+static uint32_t bmp280_duplicate_count = 0;
+
 
 //=============================================================================
 //	function definitions
@@ -86,7 +144,17 @@ bool bmp280_initialize(bmp280_memory_operation *bmp280_read, bmp280_memory_opera
 	}
 	if (result == true)
 	{
-		if (chip_id != BMP280_VALUE_ID)
+		if (chip_id == BMP280_VALUE_ID_BME280)
+		{
+			bmp280_is_bme280 = true;
+			bmp280_measurement_length = BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY;
+		}
+		else if (chip_id == BMP280_VALUE_ID)
+		{
+			bmp280_is_bme280 = false;
+			bmp280_measurement_length = BMP280_LENGTH_MEASUREMENT_DATA;
+		}
+		else
 		{
 			result = false;
 		}
@@ -130,13 +198,165 @@ bool bmp280_set_measurement_control(bmp280_temperature_oversampling_enum tempera
 	{
 		result = bmp280_write_registers(BMP280_ADDRESS_MEASUREMENT_CONTROL, &measurement_ctrl_register, 1);
 	}
+	if (result == true)
+	{
+		bmp280_measurement_control = measurement_ctrl_register;
+	}
 	return result;
 }
 
+/******************************************************************************
+ * @brief oversampling last written to ctrl_meas
+*/
+void bmp280_get_oversampling(bmp280_temperature_oversampling_enum *temperature_oversampling, bmp280_pressure_oversampling_enum *pressure_oversampling)
+{
+	*temperature_oversampling = (bmp280_temperature_oversampling_enum)(bmp280_measurement_control & BMP280_TEMPERATURE_OVERSAMPLING_MASK);
+	*pressure_oversampling = (bmp280_pressure_oversampling_enum)(bmp280_measurement_control & BMP280_PRESSURE_OVERSAMPLING_MASK);
+}
+
+/******************************************************************************
+ * @brief BME280 humidity oversampling. The sensor latches ctrl_hum with the
+ * 		  next ctrl_meas write, so call before bmp280_set_measurement_control()
+ * 		  (forced triggers write ctrl_meas as well).
+ * 
+ * @param[out] true if the device is a BME280 and the register was written
+*/
+bool bmp280_set_humidity_control(bmp280_humidity_oversampling_enum humidity_oversampling)
+{
+	bool result = bmp280_is_bme280;
+	uint8_t humidity_ctrl_register = (uint8_t)humidity_oversampling;
+
+	if (result == true)
+	{
+		result = bmp280_write_registers(BMP280_ADDRESS_HUMIDITY_CONTROL, &humidity_ctrl_register, 1);
+	}
+	if (result == true)
+	{
+		bmp280_humidity_control = humidity_ctrl_register;
+	}
+	return result;
+}
+
+bool bmp280_has_humidity()
+{
+	return bmp280_is_bme280;
+}
+
+/******************************************************************************
+ * @brief stop conversions (sleep mode), oversampling settings are kept
+ * 
+ * @param[out] true if the register was written
+*/
+bool bmp280_enter_sleep_mode()
+{
+	bool result = true;
+	uint8_t measurement_ctrl_register = (bmp280_measurement_control & ~BMP280_POWER_MODE_MASK) | (uint8_t)BMP280_POWER_MODE_SLEEP;
+
+	if (result == true)
+	{
+		result = bmp280_write_registers(BMP280_ADDRESS_MEASUREMENT_CONTROL, &measurement_ctrl_register, 1);
+	}
+	if (result == true)
+	{
+		bmp280_measurement_control = measurement_ctrl_register;
+	}
+	return result;
+}
+
+/******************************************************************************
+ * @brief start a single conversion with the current oversampling settings.
+ * 		  The sensor returns to sleep mode once the conversion is done.
+ * 
+ * @param[out] true if the trigger was written
+*/
+bool bmp280_start_forced_measurement()
+{
+	bool result = true;
+	uint8_t measurement_ctrl_register = (bmp280_measurement_control & ~BMP280_POWER_MODE_MASK) | (uint8_t)BMP280_POWER_MODE_FORCED;
+
+	if (result == true)
+	{
+		result = bmp280_write_registers(BMP280_ADDRESS_MEASUREMENT_CONTROL, &measurement_ctrl_register, 1);
+	}
+	if (result == true)
+	{
+		bmp280_measurement_control = measurement_ctrl_register;
+		bmp280_conversion_pending = true;
+	}
+	return result;
+}
+
+bool bmp280_is_measuring(bool *is_measuring)
+{
+	bool result = true;
+	uint8_t status_register;
+
+	if (result == true)
+	{
+		result = bmp280_read_registers(BMP280_ADDRESS_STATUS, &status_register, 1);
+	}
+	if (result == true)
+	{
+		*is_measuring = (status_register & BMP280_STATUS_MEASURING_MASK) != 0;
+	}
+	return result;
+}
+
+/******************************************************************************
+ * @brief poll the status register until the running conversion finished.
+ * 		  Call once the measurement time elapsed, the poll is only a guard
+ * 		  against clock tolerances.
+ * 
+ * @param[out] true if the conversion finished within BMP280_MEASUREMENT_POLL_MAX polls
+*/
+bool bmp280_wait_for_measurement()
+{
+	bool result = true;
+	bool is_measuring = true;
+
+	for (uint8_t n = 0; n < BMP280_MEASUREMENT_POLL_MAX && result == true && is_measuring == true; n++)
+	{
+		result = bmp280_is_measuring(&is_measuring);
+		if (result == true && is_measuring == true)
+		{
+			bmp280_sleep(1);
+		}
+	}
+	if (result == true && is_measuring == true)
+	{
+		result = false;
+	}
+	return result;
+}
+
+/******************************************************************************
+ * @brief maximum conversion time for the current oversampling settings
+ * 
+ * @param[out] time in us, e.g. 43 200 us for T 2x / P 16x
+*/
+uint32_t bmp280_get_measurement_time_us()
+{
+	uint32_t temperature_count = bmp280_get_oversampling_count((bmp280_measurement_control & BMP280_TEMPERATURE_OVERSAMPLING_MASK) >> BMP280_TEMPERATURE_OVERSAMPLING_SHIFT);
+	uint32_t pressure_count = bmp280_get_oversampling_count((bmp280_measurement_control & BMP280_PRESSURE_OVERSAMPLING_MASK) >> BMP280_PRESSURE_OVERSAMPLING_SHIFT);
+	uint32_t measurement_time_us = BMP280_MEASUREMENT_TIME_BASE_US + temperature_count * BMP280_MEASUREMENT_TIME_PER_OVERSAMPLE_US;
+
+	uint32_t humidity_count = bmp280_is_bme280 ? bmp280_get_oversampling_count(bmp280_humidity_control & BMP280_HUMIDITY_OVERSAMPLING_MASK) : 0;
+
+	if (pressure_count > 0)
+	{
+		measurement_time_us += pressure_count * BMP280_MEASUREMENT_TIME_PER_OVERSAMPLE_US + BMP280_MEASUREMENT_TIME_PRESSURE_SETUP_US;
+	}
+	if (humidity_count > 0)
+	{
+		measurement_time_us += humidity_count * BMP280_MEASUREMENT_TIME_PER_OVERSAMPLE_US + BMP280_MEASUREMENT_TIME_HUMIDITY_SETUP_US;
+	}
+	return measurement_time_us;
+}
+
 bool bmp280_get_temperature(double *temperature)
 {
 	bool result = true;
-	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA];
+	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY];
 	int32_t Temperature_100, t_fine;
 
 	// read register data
@@ -177,7 +397,7 @@ bool bmp280_get_pressure(double *pressure)
 bool bmp280_get_temperature_and_pressure(double *temperature, double *pressure)
 {
 	bool result = true;
-	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA];
+	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY];
 	int32_t Temperature_100, t_fine;
 	uint32_t Pressure_256;
 
@@ -199,6 +419,12 @@ bool bmp280_get_temperature_and_pressure(double *temperature, double *pressure)
 		result = bmp280_calculate_Pressure_256(measurement_data, &Pressure_256, t_fine);
 	}
 
+	// calculate H_1024 from the same burst
+	if (result == true && bmp280_is_bme280 == true)
+	{
+		result = bmp280_calculate_Humidity_1024(measurement_data, &bmp280_humidity_1024, t_fine);
+	}
+
 	// if all went well => convert to double
 	if (result == true)
 	{
@@ -209,6 +435,208 @@ bool bmp280_get_temperature_and_pressure(double *temperature, double *pressure)
 	return result;
 }
 
+/******************************************************************************
+ * @brief read temperature and pressure only if a conversion finished since
+ * 		  the last read. Outputs are left untouched otherwise.
+ * 
+ * @param[in] is_new_data false if the data registers still hold the last
+ * 			  sample (counted as duplicate) or the NVM copy is running
+ * @param[out] true if the I2C transfers and the compensation succeeded
+*/
+bool bmp280_get_new_temperature_and_pressure(double *temperature, double *pressure, bool *is_new_data)
+{
+	bool result = true;
+	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY];
+	int32_t Temperature_100, t_fine;
+	uint32_t Pressure_256;
+
+	// read register data
+	if (result == true)
+	{
+		result = bmp280_read_new_measurement_registers(measurement_data, is_new_data);
+	}
+
+	// calculate T_100
+	if (result == true && *is_new_data == true)
+	{
+		result = bmp280_calculate_Temperature_100(measurement_data, &Temperature_100, &t_fine);
+	}
+
+	// calculate P_256
+	if (result == true && *is_new_data == true)
+	{
+		result = bmp280_calculate_Pressure_256(measurement_data, &Pressure_256, t_fine);
+	}
+
+	// calculate H_1024 from the same burst
+	if (result == true && *is_new_data == true && bmp280_is_bme280 == true)
+	{
+		result = bmp280_calculate_Humidity_1024(measurement_data, &bmp280_humidity_1024, t_fine);
+	}
+
+	// if all went well => convert to double, keeping the 1/100 degC and 1/256 Pa resolution
+	if (result == true && *is_new_data == true)
+	{
+		*temperature = Temperature_100 / 100.0;
+		*pressure = Pressure_256 / 256.0;
+	}
+
+	return result;
+}
+
+uint32_t bmp280_get_duplicate_count()
+{
+	return bmp280_duplicate_count;
+}
+
+/******************************************************************************
+ * @brief bus part of bmp280_get_new_altitude_delta(), the raw burst can be
+ * 		  converted later with bmp280_convert_altitude_delta()
+ * 
+ * @param[in] measurement_data at least BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY bytes
+ * @param[in] data_length bytes read (6, 8 on a BME280)
+ * @param[in] is_new_data false if no conversion finished since the last read
+ * @param[out] true if the I2C transfers succeeded
+*/
+bool bmp280_read_raw_measurement(uint8_t *measurement_data, uint8_t *data_length, bool *is_new_data)
+{
+	bool result = true;
+
+	if (result == true)
+	{
+		result = bmp280_read_new_measurement_registers(measurement_data, is_new_data);
+	}
+	if (result == true)
+	{
+		*data_length = (uint8_t)bmp280_measurement_length;
+	}
+
+	return result;
+}
+
+bool bmp280_convert_altitude_delta(uint8_t *measurement_data, double *altitude_delta)
+{
+	bool result = true;
+	int32_t Temperature_100, t_fine;
+	uint32_t Pressure_256;
+
+	// no reference after a failed bmp280_calibrate()
+	result = (pressure_reference > 0);
+
+	// calculate T_100 for t_fine
+	if (result == true)
+	{
+		result = bmp280_calculate_Temperature_100(measurement_data, &Temperature_100, &t_fine);
+	}
+
+	// calculate P_256
+	if (result == true)
+	{
+		result = bmp280_calculate_Pressure_256(measurement_data, &Pressure_256, t_fine);
+	}
+
+	// calculate H_1024 from the same burst
+	if (result == true && bmp280_is_bme280 == true)
+	{
+		result = bmp280_calculate_Humidity_1024(measurement_data, &bmp280_humidity_1024, t_fine);
+	}
+
+	if (result == true)
+	{
+		*altitude_delta = bmp280_calculate_altitude_delta(Pressure_256 / 256.0);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * @brief integer compensation of a raw burst, no bus access
+ * 
+ * @param[out] false if no trimming parameters are loaded
+*/
+SENSOR_RAM_FUNCTION bool bmp280_compensate(uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256)
+{
+	bool result = true;
+	int32_t t_fine;
+
+	if (result == true)
+	{
+		result = bmp280_calculate_Temperature_100(measurement_data, Temperature_100, &t_fine);
+	}
+	if (result == true)
+	{
+		result = bmp280_calculate_Pressure_256(measurement_data, Pressure_256, t_fine);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * @brief trimming parameters of the datasheet example (BMP280 datasheet
+ * 		  3.12), for benchmarks and host runs without a sensor.
+ * 		  adc_T = 519888, adc_P = 415148 give 25.08 degC and ~100653 Pa.
+*/
+void bmp280_load_example_trimming()
+{
+	dig_T1 = 27504;
+	dig_T2 = 26435;
+	dig_T3 = -1000;
+	dig_P1 = 36477;
+	dig_P2 = -10685;
+	dig_P3 = 3024;
+	dig_P4 = 2855;
+	dig_P5 = 140;
+	dig_P6 = -7;
+	dig_P7 = 15500;
+	dig_P8 = -14600;
+	dig_P9 = 6000;
+
+	bmp280_prepare_coefficients();
+}
+
+
+/******************************************************************************
+ * @brief current trimming parameters, e.g. to compare compensation variants
+*/
+void bmp280_get_trimming(bmp280_trimming_struct *trimming)
+{
+	*trimming = (bmp280_trimming_struct){dig_T1, dig_T2, dig_T3, dig_P1, dig_P2, dig_P3, dig_P4, dig_P5, dig_P6, dig_P7, dig_P8, dig_P9};
+}
+
+bool bmp280_get_temperature_pressure_and_humidity(double *temperature, double *pressure, double *humidity)
+{
+	bool result = bmp280_is_bme280;
+
+	if (result == true)
+	{
+		result = bmp280_get_temperature_and_pressure(temperature, pressure);
+	}
+	if (result == true)
+	{
+		result = bmp280_get_humidity(humidity);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * @brief humidity of the last P/T/H burst, no bus transfer
+ * 
+ * @param[in] humidity relative humidity in %
+ * @param[out] true if the device is a BME280
+*/
+bool bmp280_get_humidity(double *humidity)
+{
+	bool result = bmp280_is_bme280;
+
+	if (result == true)
+	{
+		*humidity = bmp280_humidity_1024 / 1024.0;
+	}
+
+	return result;
+}
+
 //=============================================================================
 //	application logic
 //=============================================================================
@@ -216,6 +644,7 @@ bool bmp280_get_temperature_and_pressure(double *temperature, double *pressure)
 bool bmp280_calibrate()
 {
 	bool result = true;
+	bool is_restore_needed = false;
 	uint8_t previous_config;
 	uint8_t previous_measurement_control;
 
@@ -229,17 +658,20 @@ bool bmp280_calibrate()
 
 	bmp280_filter_coefficient_enum filter = BMP280_FILTER_COEFFIENT_16X;
 	bmp280_standby_time_enum standby_time = BMP280_STANDBY_TIME_0_5_MS;
-	bmp280_spi3w_enabled_enum spi3w_enabled = BMP280_SPI3W_DISABLED;
+	bmp280_spi3w_enabled_enum spi3w_enabled;
 
 	// retrieve current values
 	if (result == true)
 	{
 		result = bmp280_read_registers(BMP280_ADDRESS_CONFIG, &previous_config, 1);
 	}
+	// keep the SPI interface mode, or the bus is lost in 3-wire mode
+	spi3w_enabled = (previous_config & BMP280_SPI3W_ENABLED) ? BMP280_SPI3W_ENABLED : BMP280_SPI3W_DISABLED;
 	if (result == true)
 	{
 		result = bmp280_read_registers(BMP280_ADDRESS_MEASUREMENT_CONTROL, &previous_measurement_control, 1);
 	}
+	is_restore_needed = result;
 
 	// set configuration for "indoor navigation"
 	if (result == true)
@@ -257,12 +689,22 @@ bool bmp280_calibrate()
 		result = bmp280_get_temperature_and_pressure(&(temperature_list[0]), &(pressure_list[0]));
 		bmp280_sleep(40);
 	}
-	// use second set of samples
-	for (uint8_t n = 0; n < number_samples && result == true; n++)
+	// use second set of samples, the poll interval is shorter than a conversion => skip duplicates
+	uint8_t sample_count = 0;
+	for (uint16_t n = 0; n < 2 * number_samples && sample_count < number_samples && result == true; n++)
 	{
-		result = bmp280_get_temperature_and_pressure(&(temperature_list[n]), &(pressure_list[n]));
+		bool is_new_data;
+		result = bmp280_get_new_temperature_and_pressure(&(temperature_list[sample_count]), &(pressure_list[sample_count]), &is_new_data);
+		if (result == true && is_new_data == true)
+		{
+			sample_count++;
+		}
 		bmp280_sleep(40);
 	}
+	if (result == true && sample_count < number_samples)
+	{
+		result = false;
+	}
 
 	// average out
 	if (result == true)
@@ -277,15 +719,24 @@ bool bmp280_calibrate()
 		}
 		temperature_reference_over_Lb = (temperature_reference_over_Lb + 273.15) / 6.5e-3;
 	}
-
-	// restore previous settings
-	if (result == true)
+	else
 	{
-		result = bmp280_write_registers(BMP280_ADDRESS_MEASUREMENT_CONTROL, &previous_measurement_control, 1);
+		// no reference, altitudes are rejected until a calibration succeeds
+		pressure_reference = 0;
 	}
-	if (result == true)
+
+	// restore previous settings also after a failure, the sensor would stay in
+	// normal mode with the x16 filter otherwise. The first error is kept.
+	if (is_restore_needed == true)
 	{
-		result = bmp280_write_registers(BMP280_ADDRESS_CONFIG, &previous_config, 1);
+		bool is_restored = bmp280_write_registers(BMP280_ADDRESS_MEASUREMENT_CONTROL, &previous_measurement_control, 1);
+
+		if (is_restored == true)
+		{
+			bmp280_measurement_control = previous_measurement_control;
+		}
+		is_restored = bmp280_write_registers(BMP280_ADDRESS_CONFIG, &previous_config, 1) && is_restored;
+		result = result && is_restored;
 	}
 
 	return result;
@@ -303,7 +754,9 @@ bool bmp280_get_altitude_delta(double *altitude_delta)
 	bool result = true;
 
 	double pressure;
-	const double pow_const = 0.19026643566373183;
+
+	// no reference after a failed bmp280_calibrate()
+	result = (pressure_reference > 0);
 
 	// get current pressure
 	if (result == true)
@@ -314,7 +767,32 @@ bool bmp280_get_altitude_delta(double *altitude_delta)
 	// calculate altitude delta
 	if (result == true)
 	{
-		*altitude_delta = temperature_reference_over_Lb * (1 - pow(pressure / pressure_reference, pow_const));
+		*altitude_delta = bmp280_calculate_altitude_delta(pressure);
+	}
+
+	return result;
+}
+
+bool bmp280_get_new_altitude_delta(double *altitude_delta, bool *is_new_data)
+{
+	bool result = true;
+
+	double temperature;
+	double pressure;
+
+	// no reference after a failed bmp280_calibrate()
+	result = (pressure_reference > 0);
+
+	// get current pressure, if it is a new sample
+	if (result == true)
+	{
+		result = bmp280_get_new_temperature_and_pressure(&temperature, &pressure, is_new_data);
+	}
+
+	// calculate altitude delta
+	if (result == true && *is_new_data == true)
+	{
+		*altitude_delta = bmp280_calculate_altitude_delta(pressure);
 	}
 
 	return result;
@@ -330,10 +808,16 @@ static bool bmp280_read_trimming_parameters()
 
 	uint8_t calibration_data[BMP280_LENGTH_CALIBRATION];
 
+	uint8_t calibration_humidity_data[BMP280_LENGTH_CALIBRATION_HUMIDITY];
+
 	if (result == true)
 	{
 		result = bmp280_read_registers(BMP280_ADDRESS_CALIBRATION_START, calibration_data, BMP280_LENGTH_CALIBRATION);
 	}
+	if (result == true && bmp280_is_bme280 == true)
+	{
+		result = bmp280_read_registers(BMP280_ADDRESS_CALIBRATION_HUMIDITY_START, calibration_humidity_data, BMP280_LENGTH_CALIBRATION_HUMIDITY);
+	}
 
 	// bit manipulation could be a bit more clean
 	if (result == true)
@@ -353,11 +837,50 @@ static bool bmp280_read_trimming_parameters()
 		dig_P7  =  (int16_t)(calibration_data[19] << 8) | (calibration_data[18]);
 		dig_P8  =  (int16_t)(calibration_data[21] << 8) | (calibration_data[20]);
 		dig_P9  =  (int16_t)(calibration_data[23] << 8) | (calibration_data[22]);
+
+		bmp280_prepare_coefficients();
+	}
+
+	if (result == true && bmp280_is_bme280 == true)
+	{
+		// humidity, H4/H5 are 12 bit values sharing 0xE5
+		dig_H1  =  calibration_data[25];
+		dig_H2  =  (int16_t)(calibration_humidity_data[1] << 8) | (calibration_humidity_data[0]);
+		dig_H3  =  calibration_humidity_data[2];
+		dig_H4  =  (int16_t)((int8_t)calibration_humidity_data[3] * 16) | (calibration_humidity_data[4] & 0x0F);
+		dig_H5  =  (int16_t)((int8_t)calibration_humidity_data[5] * 16) | (calibration_humidity_data[4] >> 4);
+		dig_H6  =  (int8_t)calibration_humidity_data[6];
 	}
 
 	return result;
 }
 
+/******************************************************************************
+ * @brief fold the constant sub-expressions of the datasheet compensation,
+ * 		  the results stay bit-exact: (x * P5) << 17 == x * (P5 << 17) and
+ * 		  ((1 << 47) + v) * P1 == (P1 << 47) + v * P1
+*/
+static void bmp280_prepare_coefficients()
+{
+	bmp280_coefficients = (bmp280_coefficients_struct)
+	{
+		.T1 = dig_T1,
+		.T1_x2 = (int32_t)dig_T1 * 2,
+		.T2 = dig_T2,
+		.T3 = dig_T3,
+		.P6 = dig_P6,
+		.P5_17 = (int64_t)dig_P5 * (1LL << 17),
+		.P4_35 = (int64_t)dig_P4 * (1LL << 35),
+		.P3 = dig_P3,
+		.P2_12 = (int64_t)dig_P2 * (1LL << 12),
+		.P1 = dig_P1,
+		.P1_47 = (int64_t)dig_P1 * (1LL << 47),
+		.P9 = dig_P9,
+		.P8 = dig_P8,
+		.P7_4 = (int64_t)dig_P7 * (1LL << 4),
+	};
+}
+
 static bool bmp280_read_measurement_registers(uint8_t *measurement_data)
 {
 	// NOTE: since `measurement_data` is ONLY passed around in internal functions, no DATA_LENGTH checks are made
@@ -366,15 +889,91 @@ static bool bmp280_read_measurement_registers(uint8_t *measurement_data)
 
 	if (result == true)
 	{
-		result = bmp280_read_registers(BMP280_ADDRESS_MEASUREMENT_DATA_START, measurement_data, BMP280_LENGTH_MEASUREMENT_DATA);
+		result = bmp280_read_registers(BMP280_ADDRESS_MEASUREMENT_DATA_START, measurement_data, bmp280_measurement_length);
+	}
+
+	return result;
+}
+
+static uint32_t bmp280_get_oversampling_count(uint8_t oversampling_code)
+{
+	// 0b000 skipped, 0b001..0b101 => 1x..16x, higher codes are 16x as well
+	uint32_t count = 0;
+
+	if (oversampling_code > 0b101)
+	{
+		count = 16;
+	}
+	else if (oversampling_code > 0)
+	{
+		count = 1u << (oversampling_code - 1);
+	}
+	return count;
+}
+
+/******************************************************************************
+ * @brief burst read of the data registers, which the sensor shadows during the
+ * 		  transfer so a sample is never torn. A sample is new if the raw values
+ * 		  changed or if a conversion finished since the last read (identical
+ * 		  consecutive samples are possible at low oversampling).
+ * 		  No read while the trimming parameters are copied from NVM.
+*/
+static bool bmp280_read_new_measurement_registers(uint8_t *measurement_data, bool *is_new_data)
+{
+	bool result = true;
+	uint8_t status_register;
+	bool is_nvm_copy = false;
+	bool is_measuring = false;
+
+	*is_new_data = false;
+
+	if (result == true)
+	{
+		result = bmp280_read_registers(BMP280_ADDRESS_STATUS, &status_register, 1);
+	}
+	if (result == true)
+	{
+		is_nvm_copy = (status_register & BMP280_STATUS_IM_UPDATE_MASK) != 0;
+		is_measuring = (status_register & BMP280_STATUS_MEASURING_MASK) != 0;
+	}
+
+	if (result == true && is_nvm_copy == false)
+	{
+		result = bmp280_read_measurement_registers(measurement_data);
+	}
+	if (result == true && is_nvm_copy == false)
+	{
+		// a running conversion has not updated the data registers yet
+		*is_new_data = (bmp280_conversion_pending == true && is_measuring == false) ||
+					   (memcmp(measurement_data, bmp280_last_measurement_data, bmp280_measurement_length) != 0);
+
+		if (*is_new_data == true)
+		{
+			memcpy(bmp280_last_measurement_data, measurement_data, bmp280_measurement_length);
+			bmp280_conversion_pending = is_measuring;
+		}
+		else
+		{
+			bmp280_conversion_pending |= is_measuring;
+			bmp280_duplicate_count++;
+		}
 	}
 
 	return result;
 }
+
+static double bmp280_calculate_altitude_delta(double pressure)
+{
+	const double pow_const = 0.19026643566373183;
+
+	return temperature_reference_over_Lb * (1 - pow(pressure / pressure_reference, pow_const));
+}
+
 //-----------------------------------------------------------------------------
-//	proprietary code taken from datasheet
+//	proprietary code taken from datasheet, trimming products precomputed in
+//	bmp280_coefficients
 //-----------------------------------------------------------------------------
-static bool bmp280_calculate_Temperature_100(uint8_t *measurement_data, int32_t *Temperature_100, int32_t *t_fine)
+SENSOR_RAM_FUNCTION static bool bmp280_calculate_Temperature_100(uint8_t *measurement_data, int32_t *Temperature_100, int32_t *t_fine)
 {
 	bool result = true;
 
@@ -382,9 +981,11 @@ static bool bmp280_calculate_Temperature_100(uint8_t *measurement_data, int32_t
 
 	if (result == true)
 	{
+		const bmp280_coefficients_struct *c = &bmp280_coefficients;
 		int32_t t_var1, t_var2;
-		t_var1 = ((((ADC_Temperature >> 3) - ((int32_t)dig_T1 << 1))) * ((int32_t)dig_T2)) >> 11;
-		t_var2 = (((((ADC_Temperature >> 4) - ((int32_t)dig_T1)) * ((ADC_Temperature >> 4) - ((int32_t)dig_T1))) >> 12) * ((int32_t)dig_T3)) >> 14;
+		int32_t t_delta = (ADC_Temperature >> 4) - c->T1;
+		t_var1 = (((ADC_Temperature >> 3) - c->T1_x2) * c->T2) >> 11;
+		t_var2 = (((t_delta * t_delta) >> 12) * c->T3) >> 14;
 		*t_fine = t_var1 + t_var2;
 		*Temperature_100 = ((*t_fine) * 5 + 128) >> 8;
 	}
@@ -392,21 +993,21 @@ static bool bmp280_calculate_Temperature_100(uint8_t *measurement_data, int32_t
 	return result;
 }
 
-static bool bmp280_calculate_Pressure_256(uint8_t *measurement_data, uint32_t *Pressure_256, int32_t t_fine)
+SENSOR_RAM_FUNCTION static bool bmp280_calculate_Pressure_256(uint8_t *measurement_data, uint32_t *Pressure_256, int32_t t_fine)
 {
 	bool result = true;
-	int64_t p_var1, p_var2, p_fine;
+	const bmp280_coefficients_struct *c = &bmp280_coefficients;
+	int64_t p_var1, p_var2, p_fine, p_var1_squared;
 
 	int32_t ADC_Pressure = (int32_t) (measurement_data[0] << 12) | (measurement_data[1] << 4) | (measurement_data[2] >> 4);
 
 	if (result == true)
 	{
 		p_var1 = ((int64_t)t_fine) - 128000;
-		p_var2 = p_var1 * p_var1 * (int64_t)dig_P6;
-		p_var2 = p_var2 + ((p_var1 * (int64_t)dig_P5) << 17);
-		p_var2 = p_var2 + (((int64_t)dig_P4) << 35);
-		p_var1 = ((p_var1 * p_var1 * (int64_t)dig_P3) >> 8) + ((p_var1 * (int64_t)dig_P2) << 12);
-		p_var1 = (((((int64_t)1) << 47) + p_var1)) * ((int64_t)dig_P1) >> 33;
+		p_var1_squared = p_var1 * p_var1;
+		p_var2 = p_var1_squared * c->P6 + p_var1 * c->P5_17 + c->P4_35;
+		p_var1 = ((p_var1_squared * c->P3) >> 8) + p_var1 * c->P2_12;
+		p_var1 = (c->P1_47 + p_var1 * c->P1) >> 33;
 
 		// check for devision by zero
 		if (p_var1 == 0)
@@ -419,13 +1020,35 @@ static bool bmp280_calculate_Pressure_256(uint8_t *measurement_data, uint32_t *P
 	{
 		p_fine = 1048576 - ADC_Pressure;
 		p_fine = (((p_fine << 31) - p_var2) * 3125) / p_var1;
-		p_var1 = (((int64_t)dig_P9) * (p_fine >> 13) * (p_fine >> 13)) >> 25;
-		p_var2 = (((int64_t)dig_P8) * p_fine) >> 19;
-		p_fine = ((p_fine + p_var1 + p_var2) >> 8) + (((int64_t)dig_P7) << 4);
+		p_var1 = (c->P9 * (p_fine >> 13) * (p_fine >> 13)) >> 25;
+		p_var2 = (c->P8 * p_fine) >> 19;
+		p_fine = ((p_fine + p_var1 + p_var2) >> 8) + c->P7_4;
 		*Pressure_256 = (uint32_t)p_fine;
 	}
 
 	return result;
 }
 
+SENSOR_RAM_FUNCTION static bool bmp280_calculate_Humidity_1024(uint8_t *measurement_data, uint32_t *Humidity_1024, int32_t t_fine)
+{
+	bool result = true;
+	int32_t h_var;
+
+	int32_t ADC_Humidity = (int32_t) (measurement_data[6] << 8) | measurement_data[7];
+
+	if (result == true)
+	{
+		h_var = t_fine - ((int32_t)76800);
+		h_var = (((((ADC_Humidity << 14) - (((int32_t)dig_H4) << 20) - (((int32_t)dig_H5) * h_var)) + ((int32_t)16384)) >> 15) *
+				(((((((h_var * ((int32_t)dig_H6)) >> 10) * (((h_var * ((int32_t)dig_H3)) >> 11) + ((int32_t)32768))) >> 10) + ((int32_t)2097152)) *
+				((int32_t)dig_H2) + 8192) >> 14));
+		h_var = (h_var - (((((h_var >> 15) * (h_var >> 15)) >> 7) * ((int32_t)dig_H1)) >> 4));
+		h_var = (h_var < 0) ? 0 : h_var;
+		h_var = (h_var > 419430400) ? 419430400 : h_var;
+		*Humidity_1024 = (uint32_t)(h_var >> 12);
+	}
+
+	return result;
+}
+
 
@@ -24,11 +24,31 @@ bool bmp280_calibrate();
 
 bool bmp280_set_configuration(bmp280_standby_time_enum standby_time, bmp280_filter_coefficient_enum filter, bmp280_spi3w_enabled_enum spi3w_enabled);
 bool bmp280_set_measurement_control(bmp280_temperature_oversampling_enum temperature_oversampling, bmp280_pressure_oversampling_enum pressure_oversampling, bmp280_power_mode_enum power_mode);
+void bmp280_get_oversampling(bmp280_temperature_oversampling_enum *temperature_oversampling, bmp280_pressure_oversampling_enum *pressure_oversampling);
+bool bmp280_set_humidity_control(bmp280_humidity_oversampling_enum humidity_oversampling);
+bool bmp280_has_humidity();
+bool bmp280_enter_sleep_mode();
+
+bool bmp280_start_forced_measurement();
+bool bmp280_is_measuring(bool *is_measuring);
+bool bmp280_wait_for_measurement();
+uint32_t bmp280_get_measurement_time_us();
 
 bool bmp280_get_temperature(double *temperature);
 bool bmp280_get_pressure(double *pressure);
 bool bmp280_get_temperature_and_pressure(double *temperature, double *pressure);
+bool bmp280_get_new_temperature_and_pressure(double *temperature, double *pressure, bool *is_new_data);
+uint32_t bmp280_get_duplicate_count();
+bool bmp280_get_temperature_pressure_and_humidity(double *temperature, double *pressure, double *humidity);
+bool bmp280_get_humidity(double *humidity);
+
+bool bmp280_read_raw_measurement(uint8_t *measurement_data, uint8_t *data_length, bool *is_new_data);
+bool bmp280_convert_altitude_delta(uint8_t *measurement_data, double *altitude_delta);
+bool bmp280_compensate(uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256);
+void bmp280_load_example_trimming();
+void bmp280_get_trimming(bmp280_trimming_struct *trimming);
 
 bool bmp280_get_altitude_delta(double *altitude_delta);
+bool bmp280_get_new_altitude_delta(double *altitude_delta, bool *is_new_data);
 
 #endif /* BMP280_BMP280_H_ */
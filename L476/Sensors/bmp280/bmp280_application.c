@@ -6,59 +6,95 @@
  */
 
 
+#include <string.h>
+
 #include "main.h"
 #include "i2c.h"
 #include "usart.h"
 
+#include "../common/sensor_i2c.h"
+#include "../common/sensor_record.h"
+#include "../common/sensor_spi.h"
 
 #include "bmp280_application.h"
 
 
-const uint8_t bm280_device_i2c_address = BMP280_I2C_DEVICE_ADDRESS;
+// forced measurement bookkeeping
+static bool bmp280_measurement_started = false;
+static uint32_t bmp280_trigger_tick_ms;
+static uint32_t bmp280_stats_start_tick_ms;
+static uint64_t bmp280_conversion_time_us;
+static uint32_t bmp280_conversion_count;
 
-bool bmp280_application_read_registers(const uint8_t memory_address, uint8_t *data_buffer, const uint16_t data_length)
+static bool bmp280_sensor_read_raw(sensor_raw_struct *raw, bool *is_ready);
+
+typedef enum
 {
-	bool result = true;
-	uint8_t msg[92];
-	uint16_t msg_len;
+	BMP280_APPLICATION_TRANSPORT_I2C,
+	BMP280_APPLICATION_TRANSPORT_SPI_4WIRE,
+	BMP280_APPLICATION_TRANSPORT_SPI_3WIRE,
+}bmp280_application_transport_enum;
+
+// I2C shares hi2c3 with the VL6180X, SPI2 (DMA) takes the barometer off that
+// bus. Selected at build time, e.g.
+// -DBMP280_APPLICATION_TRANSPORT=BMP280_APPLICATION_TRANSPORT_SPI_4WIRE
+// (CMake: -DL476_BMP280_TRANSPORT=SPI_4WIRE).
+//
+// UNVERIFIED: both SPI variants (4-wire, 3-wire with the series resistor)
+// compile but have not run on a board yet, neither the wiring (CS on PB12)
+// nor the read time. Once wired, the "stats" console command reports the
+// average read_raw time to compare against I2C.
+#ifndef BMP280_APPLICATION_TRANSPORT
+#define BMP280_APPLICATION_TRANSPORT BMP280_APPLICATION_TRANSPORT_I2C
+#endif
+
+static const bmp280_application_transport_enum bmp280_transport = BMP280_APPLICATION_TRANSPORT;
 
-	HAL_StatusTypeDef retval = HAL_I2C_Mem_Read(&hi2c3, bm280_device_i2c_address, memory_address, I2C_MEMADD_SIZE_8BIT, data_buffer, data_length, HAL_MAX_DELAY);
+const sensor_i2c_device_struct bmp280_device =
+{
+	.name           = "BMP280",
+	.i2c_handle     = &hi2c3,
+	.device_address = BMP280_I2C_DEVICE_ADDRESS,
+	.address_width  = SENSOR_I2C_ADDRESS_WIDTH_8BIT,
+};
+
+const sensor_spi_device_struct bmp280_spi_device =
+{
+	.name    = "BMP280",
+	.cs_port = GPIOB,
+	.cs_pin  = GPIO_PIN_12,
+};
+
+bool bmp280_application_read_registers(const uint8_t memory_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	bool result;
 
-	if (retval == HAL_OK)
+	if (bmp280_transport == BMP280_APPLICATION_TRANSPORT_I2C)
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - read registers: addr: 0x%x | len: %2d | result: %d [OK]\r\n", memory_address, data_length,  retval);
+		result = sensor_i2c_read_registers(&bmp280_device, memory_address, data_buffer, data_length);
 	}
 	else
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - read registers: addr: 0x%x | len: %2d | result: %d [FAILED]\r\n", memory_address, data_length, retval);
-		result = false;
+		result = sensor_spi_read_registers(&bmp280_spi_device, memory_address, data_buffer, data_length);
 	}
-
-	HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
-
+	sensor_record_transaction(SENSOR_RECORD_DEVICE_BMP280, false, memory_address, data_buffer, data_length, result);
 	return result;
 }
 
 
 bool bmp280_application_write_registers(const uint8_t memory_address, uint8_t *data_buffer, const uint16_t data_length)
 {
-	bool result = true;
-	uint8_t msg[92];
-	uint16_t msg_len;
-
-	HAL_StatusTypeDef retval = HAL_I2C_Mem_Write(&hi2c3, bm280_device_i2c_address, memory_address, I2C_MEMADD_SIZE_8BIT, data_buffer, data_length, HAL_MAX_DELAY);
+	bool result;
 
-	if (retval == HAL_OK)
+	if (bmp280_transport == BMP280_APPLICATION_TRANSPORT_I2C)
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - write registers: addr: 0x%x | len: %2d | result: %d [OK]\r\n", memory_address, data_length,  retval);
+		result = sensor_i2c_write_registers(&bmp280_device, memory_address, data_buffer, data_length);
 	}
 	else
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - write registers: addr: 0x%x | len: %2d | result: %d [FAILED]\r\n", memory_address, data_length, retval);
-		result = false;
+		result = sensor_spi_write_registers(&bmp280_spi_device, memory_address, data_buffer, data_length);
 	}
-
-	HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+	sensor_record_transaction(SENSOR_RECORD_DEVICE_BMP280, true, memory_address, data_buffer, data_length, result);
 	return result;
 }
 
@@ -69,6 +105,29 @@ bool bmp280_application_sleep(const uint32_t timeout_ms)
 }
 
 
+static bool bmp280_application_initialize_transport()
+{
+	bool result = true;
+
+	if (result == true && bmp280_transport != BMP280_APPLICATION_TRANSPORT_I2C)
+	{
+		result = sensor_spi_initialize();
+	}
+	if (result == true && bmp280_transport != BMP280_APPLICATION_TRANSPORT_I2C)
+	{
+		result = sensor_spi_initialize_device(&bmp280_spi_device);
+	}
+	if (result == true && bmp280_transport == BMP280_APPLICATION_TRANSPORT_SPI_3WIRE)
+	{
+		// the sensor starts in 4-wire mode, writes only use SDI => switch before the first read
+		uint8_t config_register = (uint8_t)BMP280_SPI3W_ENABLED;
+		result = bmp280_application_write_registers(BMP280_ADDRESS_CONFIG, &config_register, 1);
+	}
+
+	return result;
+}
+
+
 bool bmp280_application_initialize()
 {
 	bool result = true;
@@ -76,6 +135,14 @@ bool bmp280_application_initialize()
 	uint8_t msg[64];
 	uint16_t msg_len;
 
+	bmp280_spi3w_enabled_enum spi3w_enabled = (bmp280_transport == BMP280_APPLICATION_TRANSPORT_SPI_3WIRE) ? BMP280_SPI3W_ENABLED : BMP280_SPI3W_DISABLED;
+
+	// bring up the bus
+	if (result == true)
+	{
+		result = bmp280_application_initialize_transport();
+	}
+
 	// initialize
 	if (result == true)
 	{
@@ -83,48 +150,365 @@ bool bmp280_application_initialize()
 	}
 	if (result == true)
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - bmp280_initialize: OK\r\n");
+		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - bmp280_initialize: OK (%s)\r\n", bmp280_has_humidity() ? "BME280" : "BMP280");
 		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
 	}
 
-	// calibrate
+	// calibrate, without a reference no altitude can be converted
 	if (result == true)
 	{
-		bmp280_calibrate();
+		result = bmp280_calibrate();
+	}
+	if (result == false)
+	{
+		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - initialization [FAIL]\r\n");
+		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
 	}
 
-	// sensor configuration
-	bmp280_power_mode_enum power_mode = BMP280_POWER_MODE_NORMAL;
+	// sensor configuration, conversions are triggered on demand (forced mode)
+	bmp280_power_mode_enum power_mode = BMP280_POWER_MODE_SLEEP;
 	bmp280_pressure_oversampling_enum pressure_oversampling = BMP280_PRESSURE_OVERSAMPLING_16X_ULTRA_HIGH_RESOLUTION;
 	bmp280_temperature_oversampling_enum temperature_oversampling = BMP280_TEMPERATURE_OVERSAMPLING_2X;
 
 	bmp280_filter_coefficient_enum filter = BMP280_FILTER_OFF;
 	bmp280_standby_time_enum standby_time = BMP280_STANDBY_TIME_0_5_MS;
-	bmp280_spi3w_enabled_enum spi3w_enabled = BMP280_SPI3W_DISABLED;
 
 	// store configuration values on sensor
 	if (result == true)
 	{
 		result = bmp280_set_configuration(standby_time, filter, spi3w_enabled);
 	}
+	if (result == true && bmp280_has_humidity() == true)
+	{
+		result = bmp280_set_humidity_control(BMP280_HUMIDITY_OVERSAMPLING_1X);
+	}
 	if (result == true)
 	{
 		result = bmp280_set_measurement_control(temperature_oversampling, pressure_oversampling, power_mode);
 	}
+	if (result == true)
+	{
+		msg_len = (uint16_t)sprintf((char*)msg, "BMP280 - forced mode, measurement time: %lu us\r\n", (unsigned long)bmp280_get_measurement_time_us());
+		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+
+		bmp280_measurement_started = false;
+		bmp280_stats_start_tick_ms = HAL_GetTick();
+		bmp280_conversion_time_us = 0;
+		bmp280_conversion_count = 0;
+	}
 
 	return result;
 }
 
+/******************************************************************************
+ * @brief client API to trigger a conversion, e.g. at the start of an
+ * 		  acquisition cycle so it runs while other sensors are serviced
+ * 
+ * @param[out] true if the conversion was started
+*/
+bool bmp280_application_start_measurement()
+{
+	bool result = true;
+
+	if (result == true)
+	{
+		result = bmp280_start_forced_measurement();
+	}
+	if (result == true)
+	{
+		bmp280_trigger_tick_ms = HAL_GetTick();
+		bmp280_measurement_started = true;
+	}
+	return result;
+}
+
+/******************************************************************************
+ * @brief client API to read the conversion started by
+ * 		  bmp280_application_start_measurement(), starts one if none is running.
+ * 		  Sleeps for what is left of the measurement time and reads the data
+ * 		  registers once, a duplicate of the previous sample is not returned.
+ * 
+ * @param[in] altitude_delta altitude relative to calibration in m
+ * @param[in] timestamp_ms tick at the centre of the conversion window
+ * @param[out] true if a new sample was read
+*/
+bool bmp280_application_read_measurement(double *altitude_delta, uint32_t *timestamp_ms)
+{
+	bool result = true;
+	uint32_t measurement_time_us = bmp280_get_measurement_time_us();
+	uint32_t measurement_time_ms = (measurement_time_us + 999) / 1000;
+	uint32_t elapsed_ms;
+	bool is_new_data = false;
+
+	if (bmp280_measurement_started == false)
+	{
+		result = bmp280_application_start_measurement();
+	}
+
+	if (result == true)
+	{
+		elapsed_ms = HAL_GetTick() - bmp280_trigger_tick_ms;
+		if (elapsed_ms < measurement_time_ms)
+		{
+			bmp280_application_sleep(measurement_time_ms - elapsed_ms);
+		}
+		result = bmp280_wait_for_measurement();
+	}
+	if (result == true)
+	{
+		result = bmp280_get_new_altitude_delta(altitude_delta, &is_new_data);
+	}
+	// a finished conversion without new data means the trigger was lost
+	if (result == true && is_new_data == false)
+	{
+		result = false;
+	}
+
+	bmp280_measurement_started = false;
+
+	if (result == true)
+	{
+		*timestamp_ms = bmp280_trigger_tick_ms + measurement_time_us / 2000;
+		bmp280_conversion_time_us += measurement_time_us;
+		bmp280_conversion_count++;
+	}
+	return result;
+}
+
+/******************************************************************************
+ * @brief client API like bmp280_application_read_measurement() that never
+ * 		  waits: starts a conversion if none is running, reads it once its
+ * 		  measurement time elapsed and starts the next one right away.
+ * 		  A failed restart is retried by the next poll.
+ * 
+ * @param[out] altitude_delta altitude relative to calibration in m
+ * @param[out] timestamp_ms tick at the centre of the conversion window
+ * @param[out] is_ready true if a new sample was read
+ * @param[out] true if no bus error occurred
+*/
+bool bmp280_application_poll_measurement(double *altitude_delta, uint32_t *timestamp_ms, bool *is_ready)
+{
+	bool result = true;
+	sensor_raw_struct raw;
+
+	result = bmp280_sensor_read_raw(&raw, is_ready);
+
+	if (result == true && *is_ready == true)
+	{
+		*timestamp_ms = bmp280_trigger_tick_ms + bmp280_get_measurement_time_us() / 2000;
+		result = bmp280_convert_altitude_delta(raw.data, altitude_delta);
+
+		bmp280_application_start_measurement();
+	}
+	return result;
+}
+
 bool bmp280_application_get_altitude_delta(double *altitude_delta)
 {
 	bool result = true;
+	uint32_t timestamp_ms;
 
 	if (result == true)
 	{
-		result = bmp280_get_altitude_delta(altitude_delta);
+		result = bmp280_application_read_measurement(altitude_delta, &timestamp_ms);
 	}
 	return result;
 }
 
+/******************************************************************************
+ * @brief client API for the conversion statistics since initialization
+ * 
+ * @param[in] duty_cycle_ppm share of time the sensor was converting
+ * @param[in] rate_mHz conversions per 1000 s
+*/
+void bmp280_application_get_duty_cycle(uint32_t *duty_cycle_ppm, uint32_t *rate_mHz)
+{
+	uint32_t elapsed_ms = HAL_GetTick() - bmp280_stats_start_tick_ms;
 
+	if (elapsed_ms == 0)
+	{
+		*duty_cycle_ppm = 0;
+		*rate_mHz = 0;
+	}
+	else
+	{
+		*duty_cycle_ppm = (uint32_t)((bmp280_conversion_time_us * 1000) / elapsed_ms);
+		*rate_mHz = (uint32_t)(((uint64_t)bmp280_conversion_count * 1000000) / elapsed_ms);
+	}
+}
+
+
+//=============================================================================
+//	generic sensor interface
+//=============================================================================
+
+static bool bmp280_sensor_probe()
+{
+	bool result = true;
+	uint8_t chip_id = 0;
+
+	if (result == true)
+	{
+		result = bmp280_application_initialize_transport();
+	}
+	if (result == true)
+	{
+		result = bmp280_application_read_registers(BMP280_ADDRESS_ID, &chip_id, 1);
+	}
+	if (result == true)
+	{
+		result = (chip_id == BMP280_VALUE_ID || chip_id == BMP280_VALUE_ID_BME280);
+	}
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief no bus access until the measurement time of the running forced
+ * 		  conversion elapsed. Without a running conversion (the start after
+ * 		  the previous sample failed) a new one is started, so a single
+ * 		  failed start costs one period instead of stopping the sensor.
+ * 		  The trigger can fall anywhere in its 1 ms tick, the measurement
+ * 		  time is rounded up and one tick added so no poll comes early.
+*/
+static bool bmp280_sensor_read_raw(sensor_raw_struct *raw, bool *is_ready)
+{
+	bool result = true;
+	uint32_t measurement_time_us = bmp280_get_measurement_time_us();
+	uint32_t ready_after_ms = (measurement_time_us + 999) / 1000 + 1;
+
+	*is_ready = false;
+
+	if (bmp280_measurement_started == false)
+	{
+		result = bmp280_application_start_measurement();
+	}
+	else if (HAL_GetTick() - bmp280_trigger_tick_ms >= ready_after_ms)
+	{
+		result = bmp280_read_raw_measurement(raw->data, &raw->length, is_ready);
+	}
+	if (result == true && *is_ready == true)
+	{
+		bmp280_measurement_started = false;
+		bmp280_conversion_time_us += measurement_time_us;
+		bmp280_conversion_count++;
+	}
+	return result;
+}
+
+
+static bool bmp280_sensor_convert(const sensor_raw_struct *raw, int32_t *altitude_mm)
+{
+	bool result = true;
+	double altitude_delta;
+
+	if (result == true)
+	{
+		result = bmp280_convert_altitude_delta((uint8_t *)raw->data, &altitude_delta);
+	}
+	// keeps the int32_t conversion defined, NaN fails both comparisons
+	if (result == true)
+	{
+		result = (altitude_delta > -2000000.0 && altitude_delta < 2000000.0);
+	}
+	if (result == true)
+	{
+		*altitude_mm = (int32_t)(altitude_delta * 1000);
+	}
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief keys: osrs_t, osrs_p (oversampling count 1, 2, 4, 8, 16).
+ * 		  0 (skipped) is rejected, the compensation needs both values.
+*/
+static bool bmp280_sensor_set_config(const char *key, int32_t value)
+{
+	bool result = true;
+	bmp280_temperature_oversampling_enum temperature_oversampling;
+	bmp280_pressure_oversampling_enum pressure_oversampling;
+	uint8_t code = 1;
+
+	// count => register code, skipping (code 0) leaves t_fine or the pressure undefined
+	while (code <= 5 && value != (1 << (code - 1)))
+	{
+		code++;
+	}
+	result = (code <= 5);
+
+	bmp280_get_oversampling(&temperature_oversampling, &pressure_oversampling);
+
+	if (result == true && strcmp(key, "osrs_t") == 0)
+	{
+		temperature_oversampling = (bmp280_temperature_oversampling_enum)(code << BMP280_TEMPERATURE_OVERSAMPLING_SHIFT);
+	}
+	else if (result == true && strcmp(key, "osrs_p") == 0)
+	{
+		pressure_oversampling = (bmp280_pressure_oversampling_enum)(code << BMP280_PRESSURE_OVERSAMPLING_SHIFT);
+	}
+	else
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		result = bmp280_set_measurement_control(temperature_oversampling, pressure_oversampling, BMP280_POWER_MODE_SLEEP);
+	}
+	// the write aborted a running forced conversion
+	if (result == true && bmp280_measurement_started == true)
+	{
+		result = bmp280_application_start_measurement();
+	}
+	return result;
+}
+
+
+static bool bmp280_sensor_get_config(const char *key, int32_t *value)
+{
+	bool result = true;
+	bmp280_temperature_oversampling_enum temperature_oversampling;
+	bmp280_pressure_oversampling_enum pressure_oversampling;
+	uint8_t code = 0;
+
+	bmp280_get_oversampling(&temperature_oversampling, &pressure_oversampling);
+
+	if (strcmp(key, "osrs_t") == 0)
+	{
+		code = (uint8_t)temperature_oversampling >> BMP280_TEMPERATURE_OVERSAMPLING_SHIFT;
+	}
+	else if (strcmp(key, "osrs_p") == 0)
+	{
+		code = (uint8_t)pressure_oversampling >> BMP280_PRESSURE_OVERSAMPLING_SHIFT;
+	}
+	else
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		*value = (code == 0) ? 0 : (1 << (((code > 5) ? 5 : code) - 1));
+	}
+	return result;
+}
+
+
+// forced conversions, re-triggered after every read
+const sensor_driver_struct bmp280_sensor_driver =
+{
+	.name           = "BMP280",
+	.unit           = "mm",
+	.period_ms      = 100,
+	.is_single_shot = true,
 
+	.probe          = &bmp280_sensor_probe,
+	.initialize     = &bmp280_application_initialize,
+	.start          = &bmp280_application_start_measurement,
+	.read_raw       = &bmp280_sensor_read_raw,
+	.convert        = &bmp280_sensor_convert,
+	.sleep          = &bmp280_enter_sleep_mode,
+	.set_config     = &bmp280_sensor_set_config,
+	.get_config     = &bmp280_sensor_get_config,
+};
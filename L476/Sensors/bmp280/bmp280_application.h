@@ -9,8 +9,16 @@
 #define BMP280_BMP280_APPLICATION_H_
 
 #include "bmp280.h"
+#include "../common/sensor_driver.h"
+
+extern const sensor_driver_struct bmp280_sensor_driver;
 
 bool bmp280_application_initialize();
 bool bmp280_application_get_altitude_delta(double *altitude_delta);
 
+bool bmp280_application_start_measurement();
+bool bmp280_application_read_measurement(double *altitude_delta, uint32_t *timestamp_ms);
+bool bmp280_application_poll_measurement(double *altitude_delta, uint32_t *timestamp_ms, bool *is_ready);
+void bmp280_application_get_duty_cycle(uint32_t *duty_cycle_ppm, uint32_t *rate_mHz);
+
 #endif /* BMP280_BMP280_APPLICATION_H_ */
@@ -0,0 +1,357 @@
+/*
+ * bmp280_benchmark.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <string.h>
+
+#include "bmp280.h"
+#include "bmp280_benchmark.h"
+
+#include "../common/sensor_cycles.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+
+// exactness sweep: temperatures every 16384 adc_T counts inside the
+// operating range, pressure inside 300..1100 hPa
+#define BMP280_BENCHMARK_TEMPERATURE_STEP		(16384)
+#define BMP280_BENCHMARK_TEMPERATURE_MIN_100	(-4000)
+#define BMP280_BENCHMARK_TEMPERATURE_MAX_100	(8500)
+#define BMP280_BENCHMARK_PRESSURE_MIN_256		(30000UL * 256)
+#define BMP280_BENCHMARK_PRESSURE_MAX_256		(110000UL * 256)
+
+
+//=============================================================================
+//	types
+//=============================================================================
+
+// one variant, results in the reference units
+typedef bool (bmp280_benchmark_function)(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256);
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static bool bmp280_benchmark_reference_64bit(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256);
+static bool bmp280_benchmark_datasheet_32bit(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256);
+static bool bmp280_benchmark_float(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256);
+static bool bmp280_benchmark_precomputed(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256);
+static void bmp280_benchmark_prepare();
+static void bmp280_benchmark_put_adc(uint8_t *measurement_data, uint32_t adc_T, uint32_t adc_P);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static bmp280_benchmark_function *const bmp280_benchmark_functions[BMP280_BENCHMARK_COUNT] =
+{
+	[BMP280_BENCHMARK_REFERENCE_64BIT] = &bmp280_benchmark_reference_64bit,
+	[BMP280_BENCHMARK_DATASHEET_32BIT] = &bmp280_benchmark_datasheet_32bit,
+	[BMP280_BENCHMARK_FLOAT]           = &bmp280_benchmark_float,
+	[BMP280_BENCHMARK_PRECOMPUTED]     = &bmp280_benchmark_precomputed,
+};
+
+static const char *const bmp280_benchmark_names[BMP280_BENCHMARK_COUNT] =
+{
+	"reference_64bit", "datasheet_32bit", "float", "precomputed",
+};
+
+static bmp280_trimming_struct bmp280_benchmark_trimming;
+static uint8_t bmp280_benchmark_bursts[BMP280_BENCHMARK_SAMPLE_COUNT][BMP280_LENGTH_MEASUREMENT_DATA];
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief time every compensation variant on the same raw bursts around the
+ * 		  datasheet example, with the trimming of the probed sensor or the
+ * 		  datasheet example trimming without one
+ * 
+ * @param[out] results one entry per bmp280_benchmark_variant_enum
+*/
+void bmp280_benchmark_run(bmp280_benchmark_result_struct results[BMP280_BENCHMARK_COUNT])
+{
+	uint32_t random = 12345;
+	int32_t Temperature_100;
+	uint32_t Pressure_256;
+	uint32_t start;
+
+	sensor_cycles_initialize();
+	bmp280_benchmark_prepare();
+
+	for (uint32_t n = 0; n < BMP280_BENCHMARK_SAMPLE_COUNT; n++)
+	{
+		random = random * 1664525 + 1013904223;
+		bmp280_benchmark_put_adc(bmp280_benchmark_bursts[n], 519888 + ((random >> 8) & 0xFF), 415148 + ((random >> 20) & 0x3FF));
+	}
+
+	for (uint8_t variant = 0; variant < BMP280_BENCHMARK_COUNT; variant++)
+	{
+		bmp280_benchmark_function *function = bmp280_benchmark_functions[variant];
+		int32_t checksum = 0;
+
+		start = sensor_cycles_now();
+		for (uint32_t n = 0; n < BMP280_BENCHMARK_SAMPLE_COUNT; n++)
+		{
+			function(bmp280_benchmark_bursts[n], &Temperature_100, &Pressure_256);
+			checksum += Temperature_100 + (int32_t)Pressure_256;
+		}
+
+		results[variant] = (bmp280_benchmark_result_struct){bmp280_benchmark_names[variant], sensor_cycles_now() - start,
+															BMP280_BENCHMARK_SAMPLE_COUNT, checksum};
+	}
+}
+
+
+/******************************************************************************
+ * @brief compare every variant with the reference: all temperatures of the
+ * 		  operating range in BMP280_BENCHMARK_TEMPERATURE_STEP, adc_P in
+ * 		  `pressure_step` (1 = exhaustive) where the reference is in range
+ * 
+ * @param[out] results one entry per bmp280_benchmark_variant_enum
+ * @param[in] pressure_step adc_P increment, at least 1
+*/
+void bmp280_benchmark_check_exactness(bmp280_benchmark_exactness_struct results[BMP280_BENCHMARK_COUNT], uint32_t pressure_step)
+{
+	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA];
+	int32_t reference_Temperature_100;
+	uint32_t reference_Pressure_256;
+	int32_t Temperature_100;
+	uint32_t Pressure_256;
+
+	bmp280_benchmark_prepare();
+	memset(results, 0, sizeof(bmp280_benchmark_exactness_struct) * BMP280_BENCHMARK_COUNT);
+	for (uint8_t variant = 0; variant < BMP280_BENCHMARK_COUNT; variant++)
+	{
+		results[variant].name = bmp280_benchmark_names[variant];
+	}
+	pressure_step = (pressure_step == 0) ? 1 : pressure_step;
+
+	for (uint32_t adc_T = 0; adc_T < (1UL << 20); adc_T += BMP280_BENCHMARK_TEMPERATURE_STEP)
+	{
+		bmp280_benchmark_put_adc(measurement_data, adc_T, 415148);
+		if (bmp280_benchmark_reference_64bit(measurement_data, &reference_Temperature_100, &reference_Pressure_256) == false ||
+			reference_Temperature_100 < BMP280_BENCHMARK_TEMPERATURE_MIN_100 || reference_Temperature_100 > BMP280_BENCHMARK_TEMPERATURE_MAX_100)
+		{
+			continue;
+		}
+
+		for (uint32_t adc_P = 0; adc_P < (1UL << 20); adc_P += pressure_step)
+		{
+			bmp280_benchmark_put_adc(measurement_data, adc_T, adc_P);
+			if (bmp280_benchmark_reference_64bit(measurement_data, &reference_Temperature_100, &reference_Pressure_256) == false ||
+				reference_Pressure_256 < BMP280_BENCHMARK_PRESSURE_MIN_256 || reference_Pressure_256 > BMP280_BENCHMARK_PRESSURE_MAX_256)
+			{
+				continue;
+			}
+
+			for (uint8_t variant = 0; variant < BMP280_BENCHMARK_COUNT; variant++)
+			{
+				bmp280_benchmark_exactness_struct *result = &results[variant];
+				bool is_valid = bmp280_benchmark_functions[variant](measurement_data, &Temperature_100, &Pressure_256);
+				uint32_t temperature_error = (uint32_t)((Temperature_100 > reference_Temperature_100) ? Temperature_100 - reference_Temperature_100 : reference_Temperature_100 - Temperature_100);
+				uint32_t pressure_error = (Pressure_256 > reference_Pressure_256) ? Pressure_256 - reference_Pressure_256 : reference_Pressure_256 - Pressure_256;
+
+				// a failed compensation counts as a full scale error
+				if (is_valid == false)
+				{
+					temperature_error = UINT32_MAX;
+					pressure_error = UINT32_MAX;
+				}
+
+				result->sample_count++;
+				result->mismatch_count += (temperature_error != 0 || pressure_error != 0) ? 1 : 0;
+				result->max_temperature_error_100 = (temperature_error > result->max_temperature_error_100) ? temperature_error : result->max_temperature_error_100;
+				result->max_pressure_error_256 = (pressure_error > result->max_pressure_error_256) ? pressure_error : result->max_pressure_error_256;
+			}
+		}
+	}
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief BMP280 datasheet 8.2 bmp280_compensate_P_int64(), as the driver had
+ * 		  it before the trimming products were precomputed
+*/
+static bool bmp280_benchmark_reference_64bit(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256)
+{
+	const bmp280_trimming_struct *trimming = &bmp280_benchmark_trimming;
+	bool result = true;
+	int32_t adc_T = (int32_t)((measurement_data[3] << 12) | (measurement_data[4] << 4) | (measurement_data[5] >> 4));
+	int32_t adc_P = (int32_t)((measurement_data[0] << 12) | (measurement_data[1] << 4) | (measurement_data[2] >> 4));
+	int32_t t_var1, t_var2, t_fine;
+	int64_t var1, var2, p;
+
+	t_var1 = ((((adc_T >> 3) - ((int32_t)trimming->dig_T1 << 1))) * ((int32_t)trimming->dig_T2)) >> 11;
+	t_var2 = (((((adc_T >> 4) - ((int32_t)trimming->dig_T1)) * ((adc_T >> 4) - ((int32_t)trimming->dig_T1))) >> 12) * ((int32_t)trimming->dig_T3)) >> 14;
+	t_fine = t_var1 + t_var2;
+	*Temperature_100 = (t_fine * 5 + 128) >> 8;
+
+	var1 = ((int64_t)t_fine) - 128000;
+	var2 = var1 * var1 * (int64_t)trimming->dig_P6;
+	var2 = var2 + ((var1 * (int64_t)trimming->dig_P5) << 17);
+	var2 = var2 + (((int64_t)trimming->dig_P4) << 35);
+	var1 = ((var1 * var1 * (int64_t)trimming->dig_P3) >> 8) + ((var1 * (int64_t)trimming->dig_P2) << 12);
+	var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)trimming->dig_P1) >> 33;
+
+	if (var1 == 0)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		p = 1048576 - adc_P;
+		p = (((p << 31) - var2) * 3125) / var1;
+		var1 = (((int64_t)trimming->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+		var2 = (((int64_t)trimming->dig_P8) * p) >> 19;
+		p = ((p + var1 + var2) >> 8) + (((int64_t)trimming->dig_P7) << 4);
+		*Pressure_256 = (uint32_t)p;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief BMP280 datasheet 8.2 bmp280_compensate_P_int32(), pressure in Pa
+*/
+static bool bmp280_benchmark_datasheet_32bit(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256)
+{
+	const bmp280_trimming_struct *trimming = &bmp280_benchmark_trimming;
+	bool result = true;
+	int32_t adc_T = (int32_t)((measurement_data[3] << 12) | (measurement_data[4] << 4) | (measurement_data[5] >> 4));
+	int32_t adc_P = (int32_t)((measurement_data[0] << 12) | (measurement_data[1] << 4) | (measurement_data[2] >> 4));
+	int32_t var1, var2, t_fine;
+	uint32_t p;
+
+	var1 = ((((adc_T >> 3) - ((int32_t)trimming->dig_T1 << 1))) * ((int32_t)trimming->dig_T2)) >> 11;
+	var2 = (((((adc_T >> 4) - ((int32_t)trimming->dig_T1)) * ((adc_T >> 4) - ((int32_t)trimming->dig_T1))) >> 12) * ((int32_t)trimming->dig_T3)) >> 14;
+	t_fine = var1 + var2;
+	*Temperature_100 = (t_fine * 5 + 128) >> 8;
+
+	var1 = (t_fine >> 1) - (int32_t)64000;
+	var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)trimming->dig_P6);
+	var2 = var2 + ((var1 * ((int32_t)trimming->dig_P5)) << 1);
+	var2 = (var2 >> 2) + (((int32_t)trimming->dig_P4) << 16);
+	var1 = (((trimming->dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)trimming->dig_P2) * var1) >> 1)) >> 18;
+	var1 = ((((32768 + var1)) * ((int32_t)trimming->dig_P1)) >> 15);
+
+	if (var1 == 0)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		p = (((uint32_t)(((int32_t)1048576) - adc_P) - (uint32_t)(var2 >> 12))) * 3125;
+		if (p < 0x80000000)
+		{
+			p = (p << 1) / ((uint32_t)var1);
+		}
+		else
+		{
+			p = (p / (uint32_t)var1) * 2;
+		}
+		var1 = (((int32_t)trimming->dig_P9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+		var2 = (((int32_t)(p >> 2)) * ((int32_t)trimming->dig_P8)) >> 13;
+		p = (uint32_t)((int32_t)p + ((var1 + var2 + trimming->dig_P7) >> 4));
+		*Pressure_256 = p << 8;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief BMP280 datasheet 8.1 (double) in float, single precision FPU on the
+ * 		  Cortex-M4
+*/
+static bool bmp280_benchmark_float(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256)
+{
+	const bmp280_trimming_struct *trimming = &bmp280_benchmark_trimming;
+	bool result = true;
+	float adc_T = (float)((measurement_data[3] << 12) | (measurement_data[4] << 4) | (measurement_data[5] >> 4));
+	float adc_P = (float)((measurement_data[0] << 12) | (measurement_data[1] << 4) | (measurement_data[2] >> 4));
+	float var1, var2, t_fine, p;
+
+	var1 = (adc_T / 16384.0f - (float)trimming->dig_T1 / 1024.0f) * (float)trimming->dig_T2;
+	var2 = (adc_T / 131072.0f - (float)trimming->dig_T1 / 8192.0f);
+	var2 = var2 * var2 * (float)trimming->dig_T3;
+	t_fine = (float)(int32_t)(var1 + var2);
+	*Temperature_100 = (int32_t)((var1 + var2) / 51.2f + ((var1 + var2 >= 0.0f) ? 0.5f : -0.5f));
+
+	var1 = t_fine / 2.0f - 64000.0f;
+	var2 = var1 * var1 * (float)trimming->dig_P6 / 32768.0f;
+	var2 = var2 + var1 * (float)trimming->dig_P5 * 2.0f;
+	var2 = var2 / 4.0f + (float)trimming->dig_P4 * 65536.0f;
+	var1 = ((float)trimming->dig_P3 * var1 * var1 / 524288.0f + (float)trimming->dig_P2 * var1) / 524288.0f;
+	var1 = (1.0f + var1 / 32768.0f) * (float)trimming->dig_P1;
+
+	if (var1 == 0.0f)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		p = 1048576.0f - adc_P;
+		p = (p - var2 / 4096.0f) * 6250.0f / var1;
+		var1 = (float)trimming->dig_P9 * p * p / 2147483648.0f;
+		var2 = p * (float)trimming->dig_P8 / 32768.0f;
+		p = p + (var1 + var2 + (float)trimming->dig_P7) / 16.0f;
+		*Pressure_256 = (uint32_t)(p * 256.0f + 0.5f);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief the driver, trimming products folded by bmp280_prepare_coefficients()
+*/
+static bool bmp280_benchmark_precomputed(const uint8_t *measurement_data, int32_t *Temperature_100, uint32_t *Pressure_256)
+{
+	return bmp280_compensate((uint8_t *)measurement_data, Temperature_100, Pressure_256);
+}
+
+
+/******************************************************************************
+ * @brief copy the driver's trimming for the local variants
+*/
+static void bmp280_benchmark_prepare()
+{
+	int32_t Temperature_100;
+	uint32_t Pressure_256;
+	uint8_t measurement_data[BMP280_LENGTH_MEASUREMENT_DATA];
+
+	// a probed sensor keeps its own trimming
+	bmp280_benchmark_put_adc(measurement_data, 519888, 415148);
+	if (bmp280_compensate(measurement_data, &Temperature_100, &Pressure_256) == false)
+	{
+		bmp280_load_example_trimming();
+	}
+	bmp280_get_trimming(&bmp280_benchmark_trimming);
+}
+
+
+static void bmp280_benchmark_put_adc(uint8_t *measurement_data, uint32_t adc_T, uint32_t adc_P)
+{
+	measurement_data[0] = (uint8_t)(adc_P >> 12);
+	measurement_data[1] = (uint8_t)(adc_P >> 4);
+	measurement_data[2] = (uint8_t)(adc_P << 4);
+	measurement_data[3] = (uint8_t)(adc_T >> 12);
+	measurement_data[4] = (uint8_t)(adc_T >> 4);
+	measurement_data[5] = (uint8_t)(adc_T << 4);
+}
@@ -0,0 +1,55 @@
+/*
+ * bmp280_benchmark.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef BMP280_BMP280_BENCHMARK_H_
+#define BMP280_BMP280_BENCHMARK_H_
+
+#include <stdint.h>
+
+#define BMP280_BENCHMARK_SAMPLE_COUNT (1024)
+
+// adc_P step of the exactness sweep, every value on the host
+#ifndef BMP280_BENCHMARK_PRESSURE_STEP
+#if defined(STM32L476xx)
+#define BMP280_BENCHMARK_PRESSURE_STEP	(257)
+#else
+#define BMP280_BENCHMARK_PRESSURE_STEP	(1)
+#endif
+#endif
+
+// temperature/pressure compensation variants, all with the driver's trimming
+typedef enum
+{
+	BMP280_BENCHMARK_REFERENCE_64BIT,	// datasheet 64 bit integer
+	BMP280_BENCHMARK_DATASHEET_32BIT,	// datasheet 32 bit integer, 1 Pa resolution
+	BMP280_BENCHMARK_FLOAT,				// datasheet floating point formula in single precision
+	BMP280_BENCHMARK_PRECOMPUTED,		// bmp280_compensate(), trimming products folded at init
+	BMP280_BENCHMARK_COUNT,
+}bmp280_benchmark_variant_enum;
+
+typedef struct
+{
+	const char *name;
+	uint32_t total_ticks;		// SENSOR_CYCLES_UNIT
+	uint32_t sample_count;
+	int32_t checksum;			// keeps the work observable
+}bmp280_benchmark_result_struct;
+
+// error against the reference, over -40..85 degC and 300..1100 hPa
+typedef struct
+{
+	const char *name;
+	uint32_t sample_count;
+	uint32_t mismatch_count;				// temperature or pressure not bit-exact
+	uint32_t max_temperature_error_100;		// 0.01 degC
+	uint32_t max_pressure_error_256;		// 1/256 Pa
+}bmp280_benchmark_exactness_struct;
+
+void bmp280_benchmark_run(bmp280_benchmark_result_struct results[BMP280_BENCHMARK_COUNT]);
+void bmp280_benchmark_check_exactness(bmp280_benchmark_exactness_struct results[BMP280_BENCHMARK_COUNT], uint32_t pressure_step);
+
+#endif /* BMP280_BMP280_BENCHMARK_H_ */
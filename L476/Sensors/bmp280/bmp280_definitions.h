@@ -21,14 +21,19 @@
 //=============================================================================
 
 #define BMP280_ADDRESS_MEASUREMENT_DATA_START	0xF7
+#define BMP280_ADDRESS_HUMIDITY_CONTROL			0xF2	// BME280 only
 #define BMP280_ADDRESS_MEASUREMENT_CONTROL 		0xF4
+#define BMP280_ADDRESS_STATUS					0xF3
 #define BMP280_ADDRESS_CONFIG					0xF5
 #define BMP280_ADDRESS_RESET					0xE0
 #define BMP280_ADDRESS_ID						0xD0
 #define BMP280_ADDRESS_CALIBRATION_START		0x88
+#define BMP280_ADDRESS_CALIBRATION_HUMIDITY_START	0xE1	// BME280 only, H1 (0xA1) is part of the first block
 
 #define BMP280_LENGTH_MEASUREMENT_DATA			6
+#define BMP280_LENGTH_MEASUREMENT_DATA_HUMIDITY	8		// P/T/H in one burst
 #define BMP280_LENGTH_CALIBRATION				26
+#define BMP280_LENGTH_CALIBRATION_HUMIDITY		7
 
 //=============================================================================
 //	predefined values
@@ -36,6 +41,26 @@
 
 #define BMP280_VALUE_MEASUREMENT_RESET		0x80
 #define BMP280_VALUE_ID						0x58
+#define BMP280_VALUE_ID_BME280				0x60
+
+//=============================================================================
+//	status
+//=============================================================================
+
+#define BMP280_STATUS_MEASURING_MASK		(0b1 << 3)	// conversion running
+#define BMP280_STATUS_IM_UPDATE_MASK		(0b1 << 0)	// NVM data being copied
+
+//=============================================================================
+//	measurement time (datasheet 3.8.1, maximum values)
+//=============================================================================
+
+#define BMP280_MEASUREMENT_TIME_BASE_US				1250
+#define BMP280_MEASUREMENT_TIME_PER_OVERSAMPLE_US	2300
+#define BMP280_MEASUREMENT_TIME_PRESSURE_SETUP_US	575
+#define BMP280_MEASUREMENT_TIME_HUMIDITY_SETUP_US	575
+
+// status polls (1 ms apart) after the measurement time elapsed
+#define BMP280_MEASUREMENT_POLL_MAX					10
 
 //=============================================================================
 // Measurement control
@@ -50,6 +75,8 @@ typedef enum
 	BMP280_PRESSURE_OVERSAMPLING_8X_HIGH_RESOLUTION = (0b100 << 2),
 	BMP280_PRESSURE_OVERSAMPLING_16X_ULTRA_HIGH_RESOLUTION = (0b101 << 2),
 }bmp280_pressure_oversampling_enum;
+#define BMP280_PRESSURE_OVERSAMPLING_MASK		(0b111 << 2)
+#define BMP280_PRESSURE_OVERSAMPLING_SHIFT		2
 
 typedef enum
 {
@@ -60,6 +87,8 @@ typedef enum
 	BMP280_TEMPERATURE_OVERSAMPLING_8X = (0b100 << 5),
 	BMP280_TEMPERATURE_OVERSAMPLING_16X = (0b101 << 5),
 }bmp280_temperature_oversampling_enum;
+#define BMP280_TEMPERATURE_OVERSAMPLING_MASK	(0b111 << 5)
+#define BMP280_TEMPERATURE_OVERSAMPLING_SHIFT	5
 
 
 typedef enum
@@ -68,6 +97,19 @@ typedef enum
 	BMP280_POWER_MODE_FORCED = 0b01,
 	BMP280_POWER_MODE_NORMAL = 0b11,
 }bmp280_power_mode_enum;
+#define BMP280_POWER_MODE_MASK					(0b11 << 0)
+
+// BME280 only, takes effect with the next write to ctrl_meas
+typedef enum
+{
+	BMP280_HUMIDITY_OVERSAMPLING_MEASUREMENT_OFF = 0b000,
+	BMP280_HUMIDITY_OVERSAMPLING_1X = 0b001,
+	BMP280_HUMIDITY_OVERSAMPLING_2X = 0b010,
+	BMP280_HUMIDITY_OVERSAMPLING_4X = 0b011,
+	BMP280_HUMIDITY_OVERSAMPLING_8X = 0b100,
+	BMP280_HUMIDITY_OVERSAMPLING_16X = 0b101,
+}bmp280_humidity_oversampling_enum;
+#define BMP280_HUMIDITY_OVERSAMPLING_MASK		(0b111 << 0)
 
 
 //=============================================================================
@@ -101,6 +143,23 @@ typedef enum
 	BMP280_SPI3W_ENABLED = 0b1,
 }bmp280_spi3w_enabled_enum;
 
+// temperature and pressure trimming parameters as read from the PROM
+typedef struct
+{
+	uint16_t dig_T1;
+	int16_t dig_T2;
+	int16_t dig_T3;
+	uint16_t dig_P1;
+	int16_t dig_P2;
+	int16_t dig_P3;
+	int16_t dig_P4;
+	int16_t dig_P5;
+	int16_t dig_P6;
+	int16_t dig_P7;
+	int16_t dig_P8;
+	int16_t dig_P9;
+}bmp280_trimming_struct;
+
 
 
 
@@ -0,0 +1,414 @@
+/*
+ * sensor_clock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <strings.h>
+
+#include "main.h"
+#include "i2c.h"
+#include "tim.h"
+
+#include "sensor_clock.h"
+#include "sensor_cycles.h"
+#include "sensor_memory.h"
+#include "sensor_spi.h"
+
+#include "../console/console_uart.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+
+// I2C standard mode (100 kHz) bus timing, tr = 1000 ns, tf = 300 ns
+#define SENSOR_CLOCK_I2C_LOW_NS			5000	// tLOW >= 4700
+#define SENSOR_CLOCK_I2C_HIGH_NS		4000	// tHIGH >= 4000
+#define SENSOR_CLOCK_I2C_SETUP_NS		1250	// tr + tSU;DAT
+#define SENSOR_CLOCK_I2C_HOLD_NS		250		// tf - tAF(min)
+
+// TIM2 counts at this rate in every profile (80 MHz / 2000 in MX_TIM2_Init)
+#define SENSOR_CLOCK_TIM2_TICK_HZ		40000
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	const char *name;
+	uint32_t sysclk_hz;
+	uint32_t voltage_scaling;	// PWR_REGULATOR_VOLTAGE_SCALEx
+	uint32_t flash_latency;		// FLASH_LATENCY_x
+	uint32_t msi_range;			// RCC_MSIRANGE_x, unused with the PLL
+	bool is_pll;
+	bool is_low_power_run;
+	uint32_t current_uA;
+}sensor_clock_profile_struct;
+
+// peripheral whose timing is derived from PCLK1
+typedef struct
+{
+	const char *name;
+	bool (*update)();
+}sensor_clock_dependant_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static bool sensor_clock_apply(const sensor_clock_profile_struct *profile);
+static bool sensor_clock_update_i2c();
+static bool sensor_clock_update_spi();
+static bool sensor_clock_update_tim();
+static uint32_t sensor_clock_ns_to_ticks(uint32_t ns, uint32_t tick_hz);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// run currents are approximate datasheet typicals (flash, ART on, 25 °C)
+static const sensor_clock_profile_struct sensor_clock_profiles[SENSOR_CLOCK_PROFILE_COUNT] =
+{
+	[SENSOR_CLOCK_PROFILE_BOOST]     = {"boost",    80000000, PWR_REGULATOR_VOLTAGE_SCALE1, FLASH_LATENCY_4, 0,               true,  false, 10200},
+	[SENSOR_CLOCK_PROFILE_RUN]       = {"run",      24000000, PWR_REGULATOR_VOLTAGE_SCALE2, FLASH_LATENCY_3, RCC_MSIRANGE_9, false, false, 2600},
+	[SENSOR_CLOCK_PROFILE_LOW_POWER] = {"lowpower",  2000000, PWR_REGULATOR_VOLTAGE_SCALE2, FLASH_LATENCY_0, RCC_MSIRANGE_5, false, true,  250},
+};
+
+static const sensor_clock_dependant_struct sensor_clock_dependants[] =
+{
+	{"i2c3",   &sensor_clock_update_i2c},
+	{"usart2", &console_uart_reconfigure},
+	{"spi2",   &sensor_clock_update_spi},
+	{"tim2",   &sensor_clock_update_tim},
+};
+
+#define SENSOR_CLOCK_DEPENDANT_COUNT (sizeof(sensor_clock_dependants) / sizeof(sensor_clock_dependants[0]))
+
+// SystemClock_Config() starts in the BOOST configuration
+static sensor_clock_profile_enum sensor_clock_profile = SENSOR_CLOCK_PROFILE_BOOST;
+static uint32_t sensor_clock_entered_ms = 0;
+static sensor_clock_stats_struct sensor_clock_stats[SENSOR_CLOCK_PROFILE_COUNT];
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief switch the system clock and re-derive every PCLK1 dependant
+ * 		  peripheral. Outstanding UART output is finished by the blocking
+ * 		  transmit before the switch.
+ * 
+ * @param[out] true if switched, false restores the previous profile
+*/
+bool sensor_clock_set_profile(sensor_clock_profile_enum profile)
+{
+	bool result = (profile < SENSOR_CLOCK_PROFILE_COUNT);
+
+	if (result == true && profile != sensor_clock_profile)
+	{
+		sensor_clock_stats_struct *stats = &sensor_clock_stats[profile];
+		uint32_t now_ms = HAL_GetTick();
+		uint32_t old_hz = SystemCoreClock;
+		uint32_t start;
+		uint32_t switched;
+		uint32_t end;
+
+		sensor_clock_stats[sensor_clock_profile].residency_ms += now_ms - sensor_clock_entered_ms;
+
+		if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+		{
+			sensor_cycles_initialize();
+		}
+
+		// the cycle counter follows SYSCLK: the oscillator part is converted
+		// at the mean of old and new clock, the peripheral part at the new one
+		start = sensor_cycles_now();
+		result = sensor_clock_apply(&sensor_clock_profiles[profile]);
+		switched = sensor_cycles_now();
+		for (uint8_t n = 0; n < SENSOR_CLOCK_DEPENDANT_COUNT && result == true; n++)
+		{
+			result = sensor_clock_dependants[n].update();
+		}
+		end = sensor_cycles_now();
+
+		if (result == true)
+		{
+			uint32_t switch_us = (uint32_t)(((uint64_t)(switched - start) * 1000000) / ((old_hz + SystemCoreClock) / 2) +
+										   ((uint64_t)(end - switched) * 1000000) / SystemCoreClock);
+
+			stats->switch_count++;
+			stats->last_switch_us = switch_us;
+			stats->max_switch_us = (switch_us > stats->max_switch_us) ? switch_us : stats->max_switch_us;
+			sensor_clock_profile = profile;
+		}
+		else
+		{
+			sensor_clock_apply(&sensor_clock_profiles[sensor_clock_profile]);
+			for (uint8_t n = 0; n < SENSOR_CLOCK_DEPENDANT_COUNT; n++)
+			{
+				sensor_clock_dependants[n].update();
+			}
+		}
+
+		sensor_clock_entered_ms = HAL_GetTick();
+	}
+
+	return result;
+}
+
+
+sensor_clock_profile_enum sensor_clock_get_profile()
+{
+	return sensor_clock_profile;
+}
+
+
+bool sensor_clock_find_profile(const char *name, sensor_clock_profile_enum *profile)
+{
+	bool result = false;
+
+	for (uint8_t n = 0; n < SENSOR_CLOCK_PROFILE_COUNT && result == false; n++)
+	{
+		if (strcasecmp(name, sensor_clock_profiles[n].name) == 0)
+		{
+			*profile = (sensor_clock_profile_enum)n;
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief switch counters and residency of `profile`, the current profile
+ * 		  includes the time since it was entered
+*/
+bool sensor_clock_get_stats(sensor_clock_profile_enum profile, sensor_clock_stats_struct *stats)
+{
+	bool result = (profile < SENSOR_CLOCK_PROFILE_COUNT);
+
+	if (result == true)
+	{
+		*stats = sensor_clock_stats[profile];
+		stats->name = sensor_clock_profiles[profile].name;
+		stats->sysclk_hz = sensor_clock_profiles[profile].sysclk_hz;
+		stats->current_uA = sensor_clock_profiles[profile].current_uA;
+		if (profile == sensor_clock_profile)
+		{
+			stats->residency_ms += HAL_GetTick() - sensor_clock_entered_ms;
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief residency weighted run current of all profiles since reset
+*/
+uint32_t sensor_clock_get_average_current_uA()
+{
+	uint64_t charge = 0;
+	uint32_t total_ms = 0;
+	sensor_clock_stats_struct stats;
+
+	for (uint8_t n = 0; n < SENSOR_CLOCK_PROFILE_COUNT; n++)
+	{
+		sensor_clock_get_stats((sensor_clock_profile_enum)n, &stats);
+		charge += (uint64_t)stats.residency_ms * stats.current_uA;
+		total_ms += stats.residency_ms;
+	}
+
+	return (total_ms == 0) ? sensor_clock_profiles[sensor_clock_profile].current_uA : (uint32_t)(charge / total_ms);
+}
+
+
+/******************************************************************************
+ * @brief I2C TIMINGR for standard mode at `i2c_clock_hz`, smallest prescaler
+ * 		  that fits all fields (RM0351 I2C timings, no digital filter)
+ * 
+ * @param[out] TIMINGR value, 0 if the clock is too slow or too fast
+*/
+uint32_t sensor_clock_get_i2c_timing(uint32_t i2c_clock_hz)
+{
+	uint32_t timing = 0;
+	uint32_t i2c_clock_ns = 1000000000 / i2c_clock_hz;
+
+	for (uint32_t prescaler = 0; prescaler < 16 && timing == 0; prescaler++)
+	{
+		uint32_t tick_hz = i2c_clock_hz / (prescaler + 1);
+		uint32_t scl_low = sensor_clock_ns_to_ticks(SENSOR_CLOCK_I2C_LOW_NS, tick_hz);
+		uint32_t scl_high = sensor_clock_ns_to_ticks(SENSOR_CLOCK_I2C_HIGH_NS, tick_hz);
+		uint32_t scl_delay = sensor_clock_ns_to_ticks(SENSOR_CLOCK_I2C_SETUP_NS, tick_hz);
+		// the analog filter and 3 kernel clocks already delay SDA
+		uint32_t sda_delay = (SENSOR_CLOCK_I2C_HOLD_NS > 3 * i2c_clock_ns) ? sensor_clock_ns_to_ticks(SENSOR_CLOCK_I2C_HOLD_NS - 3 * i2c_clock_ns, tick_hz) : 0;
+
+		if (scl_low <= 256 && scl_high <= 256 && scl_delay <= 16 && sda_delay <= 15)
+		{
+			timing = (prescaler << I2C_TIMINGR_PRESC_Pos) | ((scl_delay - 1) << I2C_TIMINGR_SCLDEL_Pos) | (sda_delay << I2C_TIMINGR_SDADEL_Pos) |
+					 ((scl_high - 1) << I2C_TIMINGR_SCLH_Pos) | ((scl_low - 1) << I2C_TIMINGR_SCLL_Pos);
+		}
+	}
+
+	return timing;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief oscillator, regulator and SYSCLK part of a switch. The regulator is
+ * 		  raised before and lowered after the clock change, unused
+ * 		  oscillators are stopped.
+*/
+static bool sensor_clock_apply(const sensor_clock_profile_struct *profile)
+{
+	RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+	RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+	bool result = true;
+
+	if (READ_BIT(PWR->CR1, PWR_CR1_LPR) != 0)
+	{
+		result = (HAL_PWREx_DisableLowPowerRunMode() == HAL_OK);
+	}
+	if (result == true && profile->voltage_scaling == PWR_REGULATOR_VOLTAGE_SCALE1)
+	{
+		result = (HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1) == HAL_OK);
+	}
+
+	if (result == true)
+	{
+		if (profile->is_pll == true)
+		{
+			// same PLL as SystemClock_Config(): HSI16 / 1 * 10 / 2 = 80 MHz
+			RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+			RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+			RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+			RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+			RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+			RCC_OscInitStruct.PLL.PLLM = 1;
+			RCC_OscInitStruct.PLL.PLLN = 10;
+			RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV7;
+			RCC_OscInitStruct.PLL.PLLQ = RCC_PLLQ_DIV2;
+			RCC_OscInitStruct.PLL.PLLR = RCC_PLLR_DIV2;
+		}
+		else
+		{
+			RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_MSI;
+			RCC_OscInitStruct.MSIState = RCC_MSI_ON;
+			RCC_OscInitStruct.MSICalibrationValue = RCC_MSICALIBRATION_DEFAULT;
+			RCC_OscInitStruct.MSIClockRange = profile->msi_range;
+			RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+		}
+		result = (HAL_RCC_OscConfig(&RCC_OscInitStruct) == HAL_OK);
+	}
+
+	if (result == true)
+	{
+		RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
+									|RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
+		RCC_ClkInitStruct.SYSCLKSource = (profile->is_pll == true) ? RCC_SYSCLKSOURCE_PLLCLK : RCC_SYSCLKSOURCE_MSI;
+		RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+		RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+		RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+
+		// also updates SystemCoreClock and reprograms SysTick for 1 ms
+		result = (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, profile->flash_latency) == HAL_OK);
+	}
+	if (result == true)
+	{
+		// prefetching only hides wait states, without them it only costs current
+		sensor_memory_accelerator_struct accelerator;
+
+		sensor_memory_get_accelerator(&accelerator);
+		accelerator.is_prefetch = (profile->flash_latency != FLASH_LATENCY_0);
+		sensor_memory_set_accelerator(&accelerator);
+	}
+
+	if (result == true)
+	{
+		RCC_OscInitStruct = (RCC_OscInitTypeDef){0};
+		if (profile->is_pll == true)
+		{
+			RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_MSI;
+			RCC_OscInitStruct.MSIState = RCC_MSI_OFF;
+			RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+		}
+		else
+		{
+			RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+			RCC_OscInitStruct.HSIState = RCC_HSI_OFF;
+			RCC_OscInitStruct.PLL.PLLState = RCC_PLL_OFF;
+		}
+		result = (HAL_RCC_OscConfig(&RCC_OscInitStruct) == HAL_OK);
+	}
+
+	if (result == true && profile->voltage_scaling == PWR_REGULATOR_VOLTAGE_SCALE2)
+	{
+		result = (HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE2) == HAL_OK);
+	}
+	if (result == true && profile->is_low_power_run == true)
+	{
+		HAL_PWREx_EnableLowPowerRunMode();
+	}
+
+	return result;
+}
+
+
+static bool sensor_clock_update_i2c()
+{
+	uint32_t timing = sensor_clock_get_i2c_timing(HAL_RCC_GetPCLK1Freq());
+	bool result = (timing != 0);
+
+	// as MX_I2C3_Init(), only the timing differs
+	if (result == true)
+	{
+		hi2c3.Init.Timing = timing;
+		result = (HAL_I2C_Init(&hi2c3) == HAL_OK);
+	}
+	if (result == true)
+	{
+		result = (HAL_I2CEx_ConfigAnalogFilter(&hi2c3, I2C_ANALOGFILTER_ENABLE) == HAL_OK) &&
+				 (HAL_I2CEx_ConfigDigitalFilter(&hi2c3, 0) == HAL_OK);
+	}
+
+	return result;
+}
+
+
+// only if the SPI transport is in use
+static bool sensor_clock_update_spi()
+{
+	return (__HAL_RCC_SPI2_IS_CLK_ENABLED() == 0) || sensor_spi_initialize();
+}
+
+
+// keep the PWM period, the new prescaler loads on the next update event
+static bool sensor_clock_update_tim()
+{
+	uint32_t prescaler = HAL_RCC_GetPCLK1Freq() / SENSOR_CLOCK_TIM2_TICK_HZ;
+	bool result = (prescaler >= 1 && prescaler <= 0x10000);
+
+	if (result == true)
+	{
+		htim2.Init.Prescaler = prescaler - 1;
+		__HAL_TIM_SET_PRESCALER(&htim2, prescaler - 1);
+	}
+
+	return result;
+}
+
+
+static uint32_t sensor_clock_ns_to_ticks(uint32_t ns, uint32_t tick_hz)
+{
+	return (uint32_t)(((uint64_t)ns * tick_hz + 999999999) / 1000000000);
+}
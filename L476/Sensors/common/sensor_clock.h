@@ -0,0 +1,58 @@
+/*
+ * sensor_clock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_CLOCK_H_
+#define COMMON_SENSOR_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	clock profiles
+//=============================================================================
+// Run-time switch between system clock profiles. Everything derived from
+// PCLK1 follows a switch: I2C3 timing, USART2 divider, SPI2 prescaler and the
+// TIM2 prescaler (sensor_clock.c). SysTick is re-derived by
+// HAL_RCC_ClockConfig(), HAL_GetTick() keeps counting milliseconds.
+//
+// profile      source        SYSCLK   regulator  flash WS
+// BOOST        HSI16 + PLL   80 MHz   range 1    4
+// RUN          MSI           24 MHz   range 2    3
+// LOW_POWER    MSI           2 MHz    range 2    0, low-power run
+//
+// A profile whose PCLK1 cannot serve a peripheral (e.g. 921600 baud at
+// 2 MHz) is rejected and the previous profile restored.
+
+typedef enum
+{
+	SENSOR_CLOCK_PROFILE_BOOST = 0,
+	SENSOR_CLOCK_PROFILE_RUN,
+	SENSOR_CLOCK_PROFILE_LOW_POWER,
+	SENSOR_CLOCK_PROFILE_COUNT,
+}sensor_clock_profile_enum;
+
+typedef struct
+{
+	const char *name;
+	uint32_t sysclk_hz;
+	uint32_t switch_count;
+	uint32_t last_switch_us;	// switch into this profile incl. peripheral re-derivation
+	uint32_t max_switch_us;
+	uint32_t residency_ms;		// time spent in this profile
+	uint32_t current_uA;		// datasheet typical run current, the power proxy
+}sensor_clock_stats_struct;
+
+bool sensor_clock_set_profile(sensor_clock_profile_enum profile);
+sensor_clock_profile_enum sensor_clock_get_profile();
+bool sensor_clock_find_profile(const char *name, sensor_clock_profile_enum *profile);
+
+bool sensor_clock_get_stats(sensor_clock_profile_enum profile, sensor_clock_stats_struct *stats);
+uint32_t sensor_clock_get_average_current_uA();
+
+uint32_t sensor_clock_get_i2c_timing(uint32_t i2c_clock_hz);
+
+#endif /* COMMON_SENSOR_CLOCK_H_ */
@@ -0,0 +1,56 @@
+/*
+ * sensor_cycles.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_CYCLES_H_
+#define COMMON_SENSOR_CYCLES_H_
+
+#include <stdint.h>
+
+//=============================================================================
+//	cycle counter for benchmarks
+//=============================================================================
+// target: DWT cycle counter (core clock cycles)
+// host:   monotonic clock (nanoseconds)
+
+#if defined(STM32L476xx)
+
+#include "main.h"
+
+#define SENSOR_CYCLES_UNIT "cycles"
+
+static inline void sensor_cycles_initialize(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t sensor_cycles_now(void)
+{
+	return DWT->CYCCNT;
+}
+
+#else
+
+#include <time.h>
+
+#define SENSOR_CYCLES_UNIT "ns"
+
+static inline void sensor_cycles_initialize(void)
+{
+}
+
+static inline uint32_t sensor_cycles_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+#endif
+
+#endif /* COMMON_SENSOR_CYCLES_H_ */
@@ -0,0 +1,55 @@
+/*
+ * sensor_driver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_DRIVER_H_
+#define COMMON_SENSOR_DRIVER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	generic sensor interface
+//=============================================================================
+// Every sensor application exposes one const sensor_driver_struct, the
+// registry (sensor_registry.c) probes, starts and services them without
+// knowing the device. Bus I/O happens in read_raw only, convert is pure math
+// on the raw bytes and can be deferred.
+
+#define SENSOR_RAW_MAX_LENGTH	8
+
+typedef struct
+{
+	uint8_t data[SENSOR_RAW_MAX_LENGTH];
+	uint8_t length;
+}sensor_raw_struct;
+
+typedef struct
+{
+	int32_t value;			// in sensor_driver_struct.unit
+	uint32_t timestamp_ms;	// tick when read_raw returned the data
+}sensor_sample_struct;
+
+typedef struct
+{
+	const char *name;
+	const char *unit;
+	uint32_t period_ms;		// minimum time between two reads, 0 = poll every pass
+	bool is_single_shot;	// start() is needed again after every read
+
+	bool (*probe)();										// device answers with the expected ID
+	bool (*initialize)();									// configure, leaves the device idle
+	bool (*start)();										// start continuous or single conversion
+	bool (*read_raw)(sensor_raw_struct *raw, bool *is_ready);	// is_ready false if no new data yet
+	bool (*convert)(const sensor_raw_struct *raw, int32_t *value);	// false for invalid samples
+	bool (*sleep)();										// lowest power state, start() resumes
+
+	// optional runtime configuration by key, NULL if the sensor has none
+	bool (*set_config)(const char *key, int32_t value);
+	bool (*get_config)(const char *key, int32_t *value);
+}sensor_driver_struct;
+
+#endif /* COMMON_SENSOR_DRIVER_H_ */
@@ -0,0 +1,42 @@
+/*
+ * sensor_endian.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_ENDIAN_H_
+#define COMMON_SENSOR_ENDIAN_H_
+
+#include <stdint.h>
+
+//=============================================================================
+//	big-endian helpers
+//=============================================================================
+// multi-byte registers on the VL6180X are stored MSB first at the lowest address
+
+static inline uint16_t sensor_endian_get_u16_be(const uint8_t *data)
+{
+	return (uint16_t)(((uint16_t)data[0] << 8) | (uint16_t)data[1]);
+}
+
+static inline uint32_t sensor_endian_get_u32_be(const uint8_t *data)
+{
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+static inline void sensor_endian_put_u16_be(uint8_t *data, const uint16_t value)
+{
+	data[0] = (uint8_t)(value >> 8);
+	data[1] = (uint8_t)(value);
+}
+
+static inline void sensor_endian_put_u32_be(uint8_t *data, const uint32_t value)
+{
+	data[0] = (uint8_t)(value >> 24);
+	data[1] = (uint8_t)(value >> 16);
+	data[2] = (uint8_t)(value >> 8);
+	data[3] = (uint8_t)(value);
+}
+
+#endif /* COMMON_SENSOR_ENDIAN_H_ */
@@ -0,0 +1,141 @@
+/*
+ * sensor_format.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "sensor_format.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+#define SENSOR_FORMAT_MAX_DIGITS	(12)	// 4294967295 plus a fixed-point "0."
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void sensor_format_number(sensor_format_struct *format, bool is_negative, uint32_t magnitude, uint8_t scale, uint8_t width);
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+void sensor_format_initialize(sensor_format_struct *format, char *buffer, uint16_t size)
+{
+	format->buffer = buffer;
+	format->size = size;
+	format->length = 0;
+	format->is_truncated = (size == 0);
+
+	if (size > 0)
+	{
+		buffer[0] = '\0';
+	}
+}
+
+
+void sensor_format_text(sensor_format_struct *format, const char *text)
+{
+	while (*text != '\0')
+	{
+		sensor_format_char(format, *text++);
+	}
+}
+
+
+void sensor_format_char(sensor_format_struct *format, char character)
+{
+	if (format->length + 1 < format->size)
+	{
+		format->buffer[format->length++] = character;
+		format->buffer[format->length] = '\0';
+	}
+	else
+	{
+		format->is_truncated = true;
+	}
+}
+
+
+void sensor_format_uint(sensor_format_struct *format, uint32_t value, uint8_t width)
+{
+	sensor_format_number(format, false, value, 0, width);
+}
+
+
+void sensor_format_int(sensor_format_struct *format, int32_t value, uint8_t width)
+{
+	// magnitude via unsigned negation, INT32_MIN has no positive counterpart
+	sensor_format_number(format, (value < 0), (value < 0) ? 0U - (uint32_t)value : (uint32_t)value, 0, width);
+}
+
+
+/******************************************************************************
+ * @brief upper case hex with exactly `digits` digits (1..8), no "0x"
+*/
+void sensor_format_hex(sensor_format_struct *format, uint32_t value, uint8_t digits)
+{
+	static const char hex_digits[] = "0123456789ABCDEF";
+
+	for (int8_t n = (int8_t)((digits > 8) ? 8 : digits) - 1; n >= 0; n--)
+	{
+		sensor_format_char(format, hex_digits[(value >> (n * 4)) & 0x0F]);
+	}
+}
+
+
+void sensor_format_fixed(sensor_format_struct *format, int32_t value, uint8_t scale, uint8_t width)
+{
+	sensor_format_number(format, (value < 0), (value < 0) ? 0U - (uint32_t)value : (uint32_t)value, scale, width);
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief digits are produced backwards into a local buffer, then padded and
+ * 		  copied. At least scale + 1 digits so 5 with scale 2 reads "0.05".
+*/
+static void sensor_format_number(sensor_format_struct *format, bool is_negative, uint32_t magnitude, uint8_t scale, uint8_t width)
+{
+	char digits[SENSOR_FORMAT_MAX_DIGITS];
+	uint8_t digit_count = 0;
+	uint8_t length;
+
+	if (scale > SENSOR_FORMAT_MAX_DIGITS - 2)
+	{
+		scale = SENSOR_FORMAT_MAX_DIGITS - 2;
+	}
+
+	do
+	{
+		digits[digit_count++] = (char)('0' + (magnitude % 10));
+		magnitude /= 10;
+	}
+	while (magnitude != 0 || digit_count <= scale);
+
+	length = digit_count + ((scale > 0) ? 1 : 0) + ((is_negative == true) ? 1 : 0);
+	for (; width > length; width--)
+	{
+		sensor_format_char(format, ' ');
+	}
+
+	if (is_negative == true)
+	{
+		sensor_format_char(format, '-');
+	}
+	while (digit_count > 0)
+	{
+		if (digit_count == scale)
+		{
+			sensor_format_char(format, '.');
+		}
+		sensor_format_char(format, digits[--digit_count]);
+	}
+}
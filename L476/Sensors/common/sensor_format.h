@@ -0,0 +1,48 @@
+/*
+ * sensor_format.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_FORMAT_H_
+#define COMMON_SENSOR_FORMAT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	integer-only line formatter
+//=============================================================================
+// Appends text, integers and fixed-point decimals to a caller supplied
+// buffer: no float, no heap, no shared state, so it is reentrant and safe in
+// interrupts. The buffer always stays NUL terminated, output that does not fit
+// is dropped and flagged. Replaces sprintf() on the sample paths, e.g.
+//
+//   sprintf(msg, "%7.3f cm", altitude_cm)
+//   sensor_format_fixed(&format, altitude_cm_1000, 3, 7); sensor_format_text(&format, " cm");
+//
+// With no "%f" left the float printf support (nanoprintffloat) is off.
+
+typedef struct
+{
+	char *buffer;
+	uint16_t size;
+	uint16_t length;		// without the NUL
+	bool is_truncated;
+}sensor_format_struct;
+
+void sensor_format_initialize(sensor_format_struct *format, char *buffer, uint16_t size);
+
+void sensor_format_text(sensor_format_struct *format, const char *text);
+void sensor_format_char(sensor_format_struct *format, char character);
+
+// width pads with leading spaces like "%*d", 0 for none
+void sensor_format_uint(sensor_format_struct *format, uint32_t value, uint8_t width);
+void sensor_format_int(sensor_format_struct *format, int32_t value, uint8_t width);
+void sensor_format_hex(sensor_format_struct *format, uint32_t value, uint8_t digits);
+
+// value / 10^scale with scale decimals, (12345, 3) -> "12.345", (-5, 2) -> "-0.05"
+void sensor_format_fixed(sensor_format_struct *format, int32_t value, uint8_t scale, uint8_t width);
+
+#endif /* COMMON_SENSOR_FORMAT_H_ */
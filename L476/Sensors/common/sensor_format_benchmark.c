@@ -0,0 +1,163 @@
+/*
+ * sensor_format_benchmark.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sensor_cycles.h"
+#include "sensor_format.h"
+#include "sensor_format_benchmark.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+#define SENSOR_FORMAT_BENCHMARK_LINE_LENGTH	(128)
+
+
+//=============================================================================
+//	types
+//=============================================================================
+
+// fields of the BMP280 sample line in main.c
+typedef struct
+{
+	int32_t altitude_cm_1000;
+	int32_t altitude_filtered_mm;
+	uint32_t timestamp_ms;
+	uint32_t duty_cycle_ppm;
+	uint32_t duplicate_count;
+}sensor_format_benchmark_line_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void sensor_format_benchmark_generate_input();
+static uint16_t sensor_format_benchmark_format(char *line, const sensor_format_benchmark_line_struct *input);
+static uint16_t sensor_format_benchmark_sprintf(char *line, const sensor_format_benchmark_line_struct *input);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static sensor_format_benchmark_line_struct sensor_format_benchmark_input[SENSOR_FORMAT_BENCHMARK_LINE_COUNT];
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief cycles per BMP280 sample line with sensor_format and with sprintf().
+ * 		  With SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT both must produce the same
+ * 		  characters, mismatch_count counts the lines that do not.
+ * 
+ * @param[out] results one entry per sensor_format_benchmark_enum
+*/
+void sensor_format_benchmark_run(sensor_format_benchmark_result_struct results[SENSOR_FORMAT_BENCHMARK_COUNT])
+{
+	char line[SENSOR_FORMAT_BENCHMARK_LINE_LENGTH];
+	char reference[SENSOR_FORMAT_BENCHMARK_LINE_LENGTH];
+	uint32_t start;
+
+	sensor_cycles_initialize();
+	sensor_format_benchmark_generate_input();
+	memset(results, 0, sizeof(sensor_format_benchmark_result_struct) * SENSOR_FORMAT_BENCHMARK_COUNT);
+	results[SENSOR_FORMAT_BENCHMARK_FORMATTER].name = "sensor_format";
+	results[SENSOR_FORMAT_BENCHMARK_SPRINTF].name = (SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT == 1) ? "sprintf %f" : "sprintf %ld";
+
+	start = sensor_cycles_now();
+	for (uint32_t n = 0; n < SENSOR_FORMAT_BENCHMARK_LINE_COUNT; n++)
+	{
+		results[SENSOR_FORMAT_BENCHMARK_FORMATTER].character_count += sensor_format_benchmark_format(line, &sensor_format_benchmark_input[n]);
+	}
+	results[SENSOR_FORMAT_BENCHMARK_FORMATTER].total_ticks = sensor_cycles_now() - start;
+
+	start = sensor_cycles_now();
+	for (uint32_t n = 0; n < SENSOR_FORMAT_BENCHMARK_LINE_COUNT; n++)
+	{
+		results[SENSOR_FORMAT_BENCHMARK_SPRINTF].character_count += sensor_format_benchmark_sprintf(line, &sensor_format_benchmark_input[n]);
+	}
+	results[SENSOR_FORMAT_BENCHMARK_SPRINTF].total_ticks = sensor_cycles_now() - start;
+
+	// exactness outside the timed loops
+	for (uint32_t n = 0; n < SENSOR_FORMAT_BENCHMARK_LINE_COUNT && SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT == 1; n++)
+	{
+		sensor_format_benchmark_format(line, &sensor_format_benchmark_input[n]);
+		sensor_format_benchmark_sprintf(reference, &sensor_format_benchmark_input[n]);
+		if (strcmp(line, reference) != 0)
+		{
+			results[SENSOR_FORMAT_BENCHMARK_FORMATTER].mismatch_count++;
+		}
+	}
+
+	for (uint8_t n = 0; n < SENSOR_FORMAT_BENCHMARK_COUNT; n++)
+	{
+		results[n].line_count = SENSOR_FORMAT_BENCHMARK_LINE_COUNT;
+	}
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief altitudes from -50 m to 2 km and counters of every magnitude
+*/
+static void sensor_format_benchmark_generate_input()
+{
+	uint32_t random = 12345;
+
+	for (uint32_t n = 0; n < SENSOR_FORMAT_BENCHMARK_LINE_COUNT; n++)
+	{
+		sensor_format_benchmark_line_struct *input = &sensor_format_benchmark_input[n];
+
+		random = random * 1664525 + 1013904223;
+		input->altitude_cm_1000 = (int32_t)(random % 205000000) - 5000000;
+		input->altitude_filtered_mm = input->altitude_cm_1000 / 100;
+		input->timestamp_ms = random >> (n % 24);
+		input->duty_cycle_ppm = random % 1000001;
+		input->duplicate_count = n;
+	}
+}
+
+
+static uint16_t sensor_format_benchmark_format(char *line, const sensor_format_benchmark_line_struct *input)
+{
+	sensor_format_struct format;
+
+	sensor_format_initialize(&format, line, SENSOR_FORMAT_BENCHMARK_LINE_LENGTH);
+	sensor_format_text(&format, "BMP280: Altitude: ");
+	sensor_format_fixed(&format, input->altitude_cm_1000, 3, 7);
+	sensor_format_text(&format, " cm (filtered: ");
+	sensor_format_int(&format, input->altitude_filtered_mm, 0);
+	sensor_format_text(&format, " mm) @ ");
+	sensor_format_uint(&format, input->timestamp_ms, 0);
+	sensor_format_text(&format, " ms | duty: ");
+	sensor_format_uint(&format, input->duty_cycle_ppm, 0);
+	sensor_format_text(&format, " ppm | dup: ");
+	sensor_format_uint(&format, input->duplicate_count, 0);
+	sensor_format_text(&format, "\r\n");
+
+	return format.length;
+}
+
+
+static uint16_t sensor_format_benchmark_sprintf(char *line, const sensor_format_benchmark_line_struct *input)
+{
+#if (SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT == 1)
+	return (uint16_t)sprintf(line, "BMP280: Altitude: %7.3f cm (filtered: %ld mm) @ %lu ms | duty: %lu ppm | dup: %lu\r\n",
+			(double)input->altitude_cm_1000 / 1000, (long)input->altitude_filtered_mm, (unsigned long)input->timestamp_ms,
+			(unsigned long)input->duty_cycle_ppm, (unsigned long)input->duplicate_count);
+#else
+	return (uint16_t)sprintf(line, "BMP280: Altitude: %7ld cm (filtered: %ld mm) @ %lu ms | duty: %lu ppm | dup: %lu\r\n",
+			(long)input->altitude_cm_1000, (long)input->altitude_filtered_mm, (unsigned long)input->timestamp_ms,
+			(unsigned long)input->duty_cycle_ppm, (unsigned long)input->duplicate_count);
+#endif
+}
@@ -0,0 +1,43 @@
+/*
+ * sensor_format_benchmark.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_FORMAT_BENCHMARK_H_
+#define COMMON_SENSOR_FORMAT_BENCHMARK_H_
+
+#include <stdint.h>
+
+#define SENSOR_FORMAT_BENCHMARK_LINE_COUNT (256)
+
+// sprintf() reference with "%7.3f" (1) or integer fields only (0), the float
+// one needs the float printf support linked in (nanoprintffloat)
+#ifndef SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT
+#if defined(STM32L476xx)
+#define SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT	0
+#else
+#define SENSOR_FORMAT_BENCHMARK_PRINTF_FLOAT	1
+#endif
+#endif
+
+typedef enum
+{
+	SENSOR_FORMAT_BENCHMARK_FORMATTER,
+	SENSOR_FORMAT_BENCHMARK_SPRINTF,
+	SENSOR_FORMAT_BENCHMARK_COUNT,
+}sensor_format_benchmark_enum;
+
+typedef struct
+{
+	const char *name;
+	uint32_t total_ticks;		// SENSOR_CYCLES_UNIT
+	uint32_t line_count;
+	uint32_t character_count;	// keeps the work observable
+	uint32_t mismatch_count;	// lines differing from the float sprintf() reference
+}sensor_format_benchmark_result_struct;
+
+void sensor_format_benchmark_run(sensor_format_benchmark_result_struct results[SENSOR_FORMAT_BENCHMARK_COUNT]);
+
+#endif /* COMMON_SENSOR_FORMAT_BENCHMARK_H_ */
@@ -0,0 +1,122 @@
+/*
+ * sensor_i2c.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "sensor_i2c.h"
+#include "sensor_trace.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static bool sensor_i2c_is_valid_address(const sensor_i2c_device_struct *device, const uint16_t register_address);
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief read consecutive registers starting at `register_address`
+ * 
+ * @param[in] device           bus, device address and register address width
+ * @param[in] register_address first register, must fit the address width
+ * @param[in] data_buffer
+ * @param[in] data_length
+ * 
+ * @param[out] true if succeeds
+*/
+bool sensor_i2c_read_registers(const sensor_i2c_device_struct *device, const uint16_t register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	bool result = true;
+	HAL_StatusTypeDef retval = HAL_ERROR;
+
+	result = sensor_i2c_is_valid_address(device, register_address);
+
+	if (result == true)
+	{
+		retval = HAL_I2C_Mem_Read(device->i2c_handle, device->device_address, register_address, (uint16_t)device->address_width, data_buffer, data_length, HAL_MAX_DELAY);
+	}
+
+	// deferred: only the trace ID and the raw values go over the UART
+	if (retval == HAL_OK)
+	{
+		SENSOR_TRACE(SENSOR_LOG_LEVEL_TRACE, "%s - read registers: addr: 0x%03x | len: %2d | data[0]: %d [OK]\r\n",
+				SENSOR_TRACE_STRING(device->name), register_address, data_length, *data_buffer);
+	}
+	else
+	{
+		SENSOR_TRACE(SENSOR_LOG_LEVEL_ERROR, "%s - read registers: addr: 0x%03x | len: %2d | result: %d [FAILED]\r\n",
+				SENSOR_TRACE_STRING((device != NULL) ? device->name : "I2C"), register_address, data_length, retval);
+		result = false;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief write consecutive registers starting at `register_address`
+ * 
+ * @param[in] device           bus, device address and register address width
+ * @param[in] register_address first register, must fit the address width
+ * @param[in] data_buffer
+ * @param[in] data_length
+ * 
+ * @param[out] true if succeeds
+*/
+bool sensor_i2c_write_registers(const sensor_i2c_device_struct *device, const uint16_t register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	bool result = true;
+	HAL_StatusTypeDef retval = HAL_ERROR;
+
+	result = sensor_i2c_is_valid_address(device, register_address);
+
+	if (result == true)
+	{
+		retval = HAL_I2C_Mem_Write(device->i2c_handle, device->device_address, register_address, (uint16_t)device->address_width, data_buffer, data_length, HAL_MAX_DELAY);
+	}
+
+	if (retval == HAL_OK)
+	{
+		SENSOR_TRACE(SENSOR_LOG_LEVEL_TRACE, "%s - write registers: addr: 0x%03x | len: %2d | result: %d [OK]\r\n",
+				SENSOR_TRACE_STRING(device->name), register_address, data_length, retval);
+	}
+	else
+	{
+		SENSOR_TRACE(SENSOR_LOG_LEVEL_ERROR, "%s - write registers: addr: 0x%03x | len: %2d | result: %d [FAILED]\r\n",
+				SENSOR_TRACE_STRING((device != NULL) ? device->name : "I2C"), register_address, data_length, retval);
+		result = false;
+	}
+
+	return result;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief reject addresses that would be truncated by the device address width
+ * 
+ * @param[out] true if `register_address` can be sent as-is
+*/
+static bool sensor_i2c_is_valid_address(const sensor_i2c_device_struct *device, const uint16_t register_address)
+{
+	bool result = true;
+
+	if (device == NULL || device->i2c_handle == NULL)
+	{
+		result = false;
+	}
+	else if (device->address_width == SENSOR_I2C_ADDRESS_WIDTH_8BIT && register_address > 0xFF)
+	{
+		result = false;
+	}
+
+	return result;
+}
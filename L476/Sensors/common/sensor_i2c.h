@@ -0,0 +1,40 @@
+/*
+ * sensor_i2c.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_I2C_H_
+#define COMMON_SENSOR_I2C_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "i2c.h"
+
+//=============================================================================
+//	register transport
+//=============================================================================
+// Shared register read/write path for all sensors on an I2C bus. The register
+// address width is part of the device description, so a 16-bit device (VL6180X)
+// and an 8-bit device (BMP280) use the same code without casting addresses.
+
+typedef enum
+{
+	SENSOR_I2C_ADDRESS_WIDTH_8BIT  = I2C_MEMADD_SIZE_8BIT,
+	SENSOR_I2C_ADDRESS_WIDTH_16BIT = I2C_MEMADD_SIZE_16BIT,
+}sensor_i2c_address_width_enum;
+
+typedef struct
+{
+	const char *name;
+	I2C_HandleTypeDef *i2c_handle;
+	uint16_t device_address;
+	sensor_i2c_address_width_enum address_width;
+}sensor_i2c_device_struct;
+
+bool sensor_i2c_read_registers(const sensor_i2c_device_struct *device, const uint16_t register_address, uint8_t *data_buffer, const uint16_t data_length);
+bool sensor_i2c_write_registers(const sensor_i2c_device_struct *device, const uint16_t register_address, uint8_t *data_buffer, const uint16_t data_length);
+
+#endif /* COMMON_SENSOR_I2C_H_ */
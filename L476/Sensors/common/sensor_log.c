@@ -0,0 +1,10 @@
+/*
+ * sensor_log.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "sensor_log.h"
+
+volatile sensor_log_level_enum sensor_log_level = SENSOR_LOG_LEVEL_TRACE;
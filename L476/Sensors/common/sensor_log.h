@@ -0,0 +1,29 @@
+/*
+ * sensor_log.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_LOG_H_
+#define COMMON_SENSOR_LOG_H_
+
+//=============================================================================
+//	UART trace verbosity
+//=============================================================================
+// Runtime switch for the bus traces, e.g. set from the console. TRACE prints
+// every register transfer (the previous, unconditional behaviour).
+
+typedef enum
+{
+	SENSOR_LOG_LEVEL_OFF   = 0,
+	SENSOR_LOG_LEVEL_ERROR = 1,
+	SENSOR_LOG_LEVEL_INFO  = 2,
+	SENSOR_LOG_LEVEL_TRACE = 3,
+}sensor_log_level_enum;
+
+extern volatile sensor_log_level_enum sensor_log_level;
+
+#define SENSOR_LOG_ENABLED(level) (sensor_log_level >= (level))
+
+#endif /* COMMON_SENSOR_LOG_H_ */
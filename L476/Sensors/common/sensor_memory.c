@@ -0,0 +1,138 @@
+/*
+ * sensor_memory.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "main.h"
+
+#include "sensor_memory.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+
+// Core/Src/sysmem.c
+void _sbrk_get_usage(uint32_t *used, uint32_t *peak, uint32_t *fail_count);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// linker script symbols
+extern uint8_t _end;
+extern uint8_t _estack;
+extern uint8_t _Min_Heap_Size;
+extern uint8_t _Min_Stack_Size;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief apply the ART/prefetch settings, caches are flushed when turned on
+ * 		  so no stale lines survive a configuration change
+*/
+void sensor_memory_set_accelerator(const sensor_memory_accelerator_struct *accelerator)
+{
+	__HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+	__HAL_FLASH_DATA_CACHE_DISABLE();
+
+	if (accelerator->is_instruction_cache == true)
+	{
+		__HAL_FLASH_INSTRUCTION_CACHE_RESET();
+		__HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+	}
+	if (accelerator->is_data_cache == true)
+	{
+		__HAL_FLASH_DATA_CACHE_RESET();
+		__HAL_FLASH_DATA_CACHE_ENABLE();
+	}
+
+	if (accelerator->is_prefetch == true)
+	{
+		__HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+	}
+	else
+	{
+		__HAL_FLASH_PREFETCH_BUFFER_DISABLE();
+	}
+}
+
+
+void sensor_memory_get_accelerator(sensor_memory_accelerator_struct *accelerator)
+{
+	accelerator->is_prefetch = (READ_BIT(FLASH->ACR, FLASH_ACR_PRFTEN) != 0);
+	accelerator->is_instruction_cache = (READ_BIT(FLASH->ACR, FLASH_ACR_ICEN) != 0);
+	accelerator->is_data_cache = (READ_BIT(FLASH->ACR, FLASH_ACR_DCEN) != 0);
+}
+
+
+/******************************************************************************
+ * @brief memory a function or buffer lives in, for benchmark reports
+*/
+const char *sensor_memory_get_region(const void *address)
+{
+	uint32_t value = (uint32_t)(uintptr_t)address;
+	const char *region = "other";
+
+	if (value >= FLASH_BASE && value < FLASH_BASE + FLASH_SIZE)
+	{
+		region = "flash";
+	}
+	else if (value >= SRAM2_BASE && value < SRAM2_BASE + SRAM2_SIZE)
+	{
+		region = "sram2";
+	}
+	else if (value >= SRAM1_BASE && value < SRAM1_BASE + SRAM1_SIZE_MAX)
+	{
+		region = "sram1";
+	}
+
+	return region;
+}
+
+
+/******************************************************************************
+ * @brief stack high-water mark from the startup paint and the _sbrk() heap
+ * 		  accounting. The scan starts at the heap break and stops at the
+ * 		  first overwritten word, its cost grows with the headroom.
+*/
+void sensor_memory_get_usage(sensor_memory_usage_struct *usage)
+{
+	uintptr_t heap_end;
+	const uint32_t *word;
+
+	_sbrk_get_usage(&usage->heap_used, &usage->heap_peak, &usage->heap_fail_count);
+
+	// malloc() may leave parts of its blocks untouched, start above the peak
+	heap_end = ((uintptr_t)&_end + usage->heap_peak + 3) & ~(uintptr_t)3;
+	word = (const uint32_t *)heap_end;
+	while ((uintptr_t)word < (uintptr_t)&_estack && *word == SENSOR_MEMORY_PAINT)
+	{
+		word++;
+	}
+
+	usage->stack_reserved = (uint32_t)(uintptr_t)&_Min_Stack_Size;
+	usage->stack_peak = (uint32_t)((uintptr_t)&_estack - (uintptr_t)word);
+	usage->heap_reserved = (uint32_t)(uintptr_t)&_Min_Heap_Size;
+	usage->headroom = (uint32_t)((uintptr_t)word - heap_end);
+}
+
+
+/******************************************************************************
+ * @brief false once stack and heap came closer than SENSOR_MEMORY_HEADROOM_MIN
+ * 		  or the heap refused an allocation
+*/
+bool sensor_memory_check_headroom()
+{
+	sensor_memory_usage_struct usage;
+
+	sensor_memory_get_usage(&usage);
+
+	return (usage.headroom >= SENSOR_MEMORY_HEADROOM_MIN) && (usage.heap_fail_count == 0);
+}
@@ -0,0 +1,92 @@
+/*
+ * sensor_memory.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_MEMORY_H_
+#define COMMON_SENSOR_MEMORY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	code and buffer placement
+//=============================================================================
+// SENSOR_RAM_FUNCTION    runs from SRAM2 (0x10000000, I-Code/D-Code bus, no
+//                        flash wait states), copied there by the startup code
+// SENSOR_SRAM2_DATA      zero initialized buffer in SRAM2, keeps DMA traffic
+//                        off the SRAM1 bank used by stack and .data
+//
+// The interrupt handlers in stm32l4xx_it.c are placed in SRAM2 by the linker
+// script. Build with SENSOR_MEMORY_RAM_FUNCTIONS=0 to keep all code in flash,
+// e.g. to compare both with sensor_memory_benchmark_run().
+
+#ifndef SENSOR_MEMORY_RAM_FUNCTIONS
+#define SENSOR_MEMORY_RAM_FUNCTIONS	1
+#endif
+
+#if defined(STM32L476xx) && (SENSOR_MEMORY_RAM_FUNCTIONS == 1)
+#define SENSOR_RAM_FUNCTION		__attribute__((section(".sram2_text"), noinline))
+#else
+#define SENSOR_RAM_FUNCTION
+#endif
+
+#if defined(STM32L476xx)
+#define SENSOR_SRAM2_DATA		__attribute__((section(".sram2_bss"), aligned(4)))
+#else
+#define SENSOR_SRAM2_DATA
+#endif
+
+//=============================================================================
+//	flash accelerator
+//=============================================================================
+// ART instruction/data caches and the prefetch buffer (FLASH_ACR). The caches
+// stay on in every clock profile, the prefetch buffer only pays off with
+// flash wait states and costs current otherwise (sensor_clock.c).
+
+typedef struct
+{
+	bool is_prefetch;
+	bool is_instruction_cache;
+	bool is_data_cache;
+}sensor_memory_accelerator_struct;
+
+void sensor_memory_set_accelerator(const sensor_memory_accelerator_struct *accelerator);
+void sensor_memory_get_accelerator(sensor_memory_accelerator_struct *accelerator);
+const char *sensor_memory_get_region(const void *address);
+
+//=============================================================================
+//	stack and heap usage
+//=============================================================================
+// The startup code paints the RAM between the heap start (_end) and the stack
+// pointer with SENSOR_MEMORY_PAINT, the deepest stack use since reset is the
+// lowest word above the heap that lost the pattern. The heap is accounted by
+// _sbrk() in sysmem.c.
+//
+//  _end           heap break                deepest stack          _estack
+//   | heap in use  |   painted, never touched  |    stack high-water  |
+//                  |<-------- headroom ------->|
+//
+// The headroom shrinking below SENSOR_MEMORY_HEADROOM_MIN means stack and heap
+// are about to meet, i.e. before the stack runs into .bss sample buffers.
+
+#define SENSOR_MEMORY_PAINT			(0xC5C5C5C5)	// also in startup_stm32l476rgtx.s
+#define SENSOR_MEMORY_HEADROOM_MIN	(512)
+
+typedef struct
+{
+	uint32_t stack_reserved;	// _Min_Stack_Size
+	uint32_t stack_peak;		// deepest use since reset
+	uint32_t heap_reserved;		// _Min_Heap_Size
+	uint32_t heap_used;			// _sbrk() break above _end
+	uint32_t heap_peak;
+	uint32_t heap_fail_count;	// _sbrk() refused, would reach the stack reserve
+	uint32_t headroom;			// painted RAM between heap break and deepest stack
+}sensor_memory_usage_struct;
+
+void sensor_memory_get_usage(sensor_memory_usage_struct *usage);
+bool sensor_memory_check_headroom();
+
+#endif /* COMMON_SENSOR_MEMORY_H_ */
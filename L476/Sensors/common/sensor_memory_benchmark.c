@@ -0,0 +1,161 @@
+/*
+ * sensor_memory_benchmark.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "sensor_cycles.h"
+#include "sensor_memory.h"
+#include "sensor_memory_benchmark.h"
+
+#include "../bmp280/bmp280.h"
+#include "../filter/filter.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void sensor_memory_benchmark_generate_input();
+static void sensor_memory_benchmark_measure(sensor_memory_benchmark_result_struct *result, const char *name);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// accelerator settings in sensor_memory_benchmark_enum order
+static const sensor_memory_accelerator_struct sensor_memory_benchmark_accelerators[SENSOR_MEMORY_BENCHMARK_COUNT] =
+{
+	[SENSOR_MEMORY_BENCHMARK_ART_PREFETCH] = {true,  true,  true},
+	[SENSOR_MEMORY_BENCHMARK_ART]          = {false, true,  true},
+	[SENSOR_MEMORY_BENCHMARK_PREFETCH]     = {true,  false, false},
+	[SENSOR_MEMORY_BENCHMARK_NONE]         = {false, false, false},
+};
+
+static const char *const sensor_memory_benchmark_names[SENSOR_MEMORY_BENCHMARK_COUNT] =
+{
+	"art+prefetch", "art", "prefetch", "none",
+};
+
+// raw BMP280 bursts and range samples, SRAM2 like the live sample buffers
+static uint8_t sensor_memory_benchmark_bursts[SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT][6] SENSOR_SRAM2_DATA;
+static int32_t sensor_memory_benchmark_samples[SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT] SENSOR_SRAM2_DATA;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief time the BMP280 compensation and a filter pipeline under every flash
+ * 		  accelerator setting. With the kernels in SRAM2 the settings should
+ * 		  not matter, build with SENSOR_MEMORY_RAM_FUNCTIONS=0 for the flash
+ * 		  numbers. The previous accelerator setting is restored.
+ * 
+ * @param[out] results one entry per sensor_memory_benchmark_enum
+*/
+void sensor_memory_benchmark_run(sensor_memory_benchmark_result_struct results[SENSOR_MEMORY_BENCHMARK_COUNT])
+{
+	sensor_memory_accelerator_struct accelerator;
+
+	sensor_memory_get_accelerator(&accelerator);
+	sensor_cycles_initialize();
+	sensor_memory_benchmark_generate_input();
+
+	for (uint8_t n = 0; n < SENSOR_MEMORY_BENCHMARK_COUNT; n++)
+	{
+		sensor_memory_set_accelerator(&sensor_memory_benchmark_accelerators[n]);
+		sensor_memory_benchmark_measure(&results[n], sensor_memory_benchmark_names[n]);
+	}
+
+	sensor_memory_set_accelerator(&accelerator);
+}
+
+
+const char *sensor_memory_benchmark_get_compensation_region()
+{
+	return sensor_memory_get_region((const void *)&bmp280_compensate);
+}
+
+
+const char *sensor_memory_benchmark_get_filter_region()
+{
+	return sensor_memory_get_region((const void *)&filter_pipeline_process);
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief raw bursts around the datasheet example (adc_T 519888, adc_P
+ * 		  415148), range samples as in filter_benchmark.c
+*/
+static void sensor_memory_benchmark_generate_input()
+{
+	uint32_t random = 12345;
+	int32_t Temperature_100;
+	uint32_t Pressure_256;
+
+	for (uint32_t n = 0; n < SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT; n++)
+	{
+		random = random * 1664525 + 1013904223;
+
+		uint32_t adc_P = 415148 + ((random >> 20) & 0x3FF);
+		uint32_t adc_T = 519888 + ((random >> 8) & 0xFF);
+		uint8_t *burst = sensor_memory_benchmark_bursts[n];
+
+		burst[0] = (uint8_t)(adc_P >> 12);
+		burst[1] = (uint8_t)(adc_P >> 4);
+		burst[2] = (uint8_t)(adc_P << 4);
+		burst[3] = (uint8_t)(adc_T >> 12);
+		burst[4] = (uint8_t)(adc_T >> 4);
+		burst[5] = (uint8_t)(adc_T << 4);
+
+		sensor_memory_benchmark_samples[n] = 50 + (int32_t)(n / 8) + (int32_t)((random >> 24) & 0x0F) - 8;
+	}
+
+	// a probed sensor keeps its own trimming
+	if (bmp280_compensate(sensor_memory_benchmark_bursts[0], &Temperature_100, &Pressure_256) == false)
+	{
+		bmp280_load_example_trimming();
+	}
+}
+
+
+static void sensor_memory_benchmark_measure(sensor_memory_benchmark_result_struct *result, const char *name)
+{
+	filter_outlier_struct outlier;
+	filter_median_struct median;
+	filter_iir_q31_struct iir;
+	int32_t checksum = 0;
+	int32_t Temperature_100;
+	uint32_t Pressure_256;
+	uint32_t start;
+
+	filter_outlier_initialize(&outlier, 20, 3);
+	filter_median_initialize(&median, 5);
+	filter_iir_q31_initialize(&iir, 8192);
+	const filter_stage_struct pipeline[] = {filter_stage_outlier(&outlier), filter_stage_median(&median), filter_stage_iir_q31(&iir)};
+
+	start = sensor_cycles_now();
+	for (uint32_t n = 0; n < SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT; n++)
+	{
+		bmp280_compensate(sensor_memory_benchmark_bursts[n], &Temperature_100, &Pressure_256);
+		checksum += Temperature_100 + (int32_t)Pressure_256;
+	}
+	result->compensation_ticks = sensor_cycles_now() - start;
+
+	start = sensor_cycles_now();
+	for (uint32_t n = 0; n < SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT; n++)
+	{
+		checksum += filter_pipeline_process(pipeline, sizeof(pipeline) / sizeof(pipeline[0]), sensor_memory_benchmark_samples[n]);
+	}
+	result->filter_ticks = sensor_cycles_now() - start;
+
+	result->name = name;
+	result->sample_count = SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT;
+	result->checksum = checksum;
+}
@@ -0,0 +1,38 @@
+/*
+ * sensor_memory_benchmark.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_MEMORY_BENCHMARK_H_
+#define COMMON_SENSOR_MEMORY_BENCHMARK_H_
+
+#include <stdint.h>
+
+#define SENSOR_MEMORY_BENCHMARK_SAMPLE_COUNT (512)
+
+// flash accelerator settings the kernels are timed with
+typedef enum
+{
+	SENSOR_MEMORY_BENCHMARK_ART_PREFETCH,
+	SENSOR_MEMORY_BENCHMARK_ART,
+	SENSOR_MEMORY_BENCHMARK_PREFETCH,
+	SENSOR_MEMORY_BENCHMARK_NONE,
+	SENSOR_MEMORY_BENCHMARK_COUNT,
+}sensor_memory_benchmark_enum;
+
+typedef struct
+{
+	const char *name;
+	uint32_t compensation_ticks;	// SENSOR_CYCLES_UNIT, BMP280 T + P compensation
+	uint32_t filter_ticks;			// outlier -> median 5 -> IIR pipeline
+	uint32_t sample_count;
+	int32_t checksum;				// keeps the work observable
+}sensor_memory_benchmark_result_struct;
+
+void sensor_memory_benchmark_run(sensor_memory_benchmark_result_struct results[SENSOR_MEMORY_BENCHMARK_COUNT]);
+const char *sensor_memory_benchmark_get_compensation_region();
+const char *sensor_memory_benchmark_get_filter_region();
+
+#endif /* COMMON_SENSOR_MEMORY_BENCHMARK_H_ */
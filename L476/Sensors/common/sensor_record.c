@@ -0,0 +1,179 @@
+/*
+ * sensor_record.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <string.h>
+
+#include "main.h"
+
+#include "sensor_cycles.h"
+#include "sensor_record.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static uint32_t sensor_record_get_delta_us();
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static uint8_t sensor_record_buffer[SENSOR_RECORD_BUFFER_SIZE];
+static uint32_t sensor_record_length = 0;
+static bool sensor_record_is_recording = false;
+static uint32_t sensor_record_transaction_count = 0;
+static uint32_t sensor_record_dropped_count = 0;
+
+// timestamps: cycle counter for resolution, tick for gaps it cannot span
+static uint32_t sensor_record_last_cycles;
+static uint32_t sensor_record_start_tick_ms;
+static uint32_t sensor_record_cycle_remainder;
+static uint32_t sensor_record_duration_us;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief discard the buffer and record from now on, the first transaction
+ * 		  gets delta 0
+*/
+void sensor_record_start()
+{
+	sensor_cycles_initialize();
+
+	memcpy(sensor_record_buffer, SENSOR_RECORD_MAGIC, 4);
+	sensor_record_buffer[4] = SENSOR_RECORD_VERSION;
+	memset(&sensor_record_buffer[5], 0, SENSOR_RECORD_HEADER_LENGTH - 5);
+
+	sensor_record_length = SENSOR_RECORD_HEADER_LENGTH;
+	sensor_record_transaction_count = 0;
+	sensor_record_dropped_count = 0;
+	sensor_record_duration_us = 0;
+	sensor_record_cycle_remainder = 0;
+	sensor_record_last_cycles = sensor_cycles_now();
+	sensor_record_start_tick_ms = HAL_GetTick();
+	sensor_record_is_recording = true;
+}
+
+
+void sensor_record_stop()
+{
+	sensor_record_is_recording = false;
+}
+
+
+/******************************************************************************
+ * @brief append one transaction, called by the register callbacks after the
+ * 		  transfer. Costs one branch while not recording.
+ * 
+ * @param[in] data_buffer data written or read, ignored if result is false
+ * @param[in] result the transfer's result
+*/
+void sensor_record_transaction(sensor_record_device_enum device, bool is_write, uint16_t register_address,
+							   const uint8_t *data_buffer, uint16_t data_length, bool result)
+{
+	uint8_t header[10];
+	uint8_t header_length = 0;
+
+	if (sensor_record_is_recording == false)
+	{
+		return;
+	}
+
+	uint32_t delta_us = sensor_record_get_delta_us();
+	uint16_t length = (result == true) ? data_length : 0;
+
+	header[header_length++] = ((uint8_t)device & SENSOR_RECORD_FLAG_DEVICE_MASK) | ((is_write == true) ? SENSOR_RECORD_FLAG_WRITE : 0) |
+							  ((result == false) ? SENSOR_RECORD_FLAG_FAILED : 0);
+	do
+	{
+		header[header_length++] = (uint8_t)((delta_us & 0x7F) | ((delta_us > 0x7F) ? 0x80 : 0));
+		delta_us >>= 7;
+	}
+	while (delta_us != 0);
+	header[header_length++] = (uint8_t)(register_address);
+	header[header_length++] = (uint8_t)(register_address >> 8);
+	header[header_length++] = (uint8_t)data_length;
+
+	// a transaction that does not fit ends the trace
+	if (data_length > SENSOR_RECORD_MAX_DATA_LENGTH || sensor_record_length + header_length + length > SENSOR_RECORD_BUFFER_SIZE)
+	{
+		sensor_record_dropped_count++;
+		sensor_record_is_recording = false;
+		return;
+	}
+
+	memcpy(&sensor_record_buffer[sensor_record_length], header, header_length);
+	memcpy(&sensor_record_buffer[sensor_record_length + header_length], data_buffer, length);
+	sensor_record_length += header_length + length;
+	sensor_record_transaction_count++;
+}
+
+
+/******************************************************************************
+ * @brief the trace recorded so far, valid until the next sensor_record_start()
+*/
+const uint8_t *sensor_record_get_buffer(uint32_t *length)
+{
+	*length = sensor_record_length;
+
+	return sensor_record_buffer;
+}
+
+
+void sensor_record_get_stats(sensor_record_stats_struct *stats)
+{
+	stats->is_recording = sensor_record_is_recording;
+	stats->length = sensor_record_length;
+	stats->transaction_count = sensor_record_transaction_count;
+	stats->dropped_count = sensor_record_dropped_count;
+	stats->duration_us = sensor_record_duration_us;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief microseconds since the last transaction. The cycle counter wraps
+ * 		  after 53 s at 80 MHz (4 s in ns on the host) and does not see the
+ * 		  virtual tick of the simulated HAL, so whenever the recorded time
+ * 		  falls behind the millisecond tick since the start, the tick is
+ * 		  taken instead. Comparing against the start and not the previous
+ * 		  transaction also keeps 1 ms steps of the virtual tick.
+*/
+static uint32_t sensor_record_get_delta_us()
+{
+	uint32_t cycles = sensor_cycles_now();
+	uint32_t tick_us = (HAL_GetTick() - sensor_record_start_tick_ms) * 1000;
+	uint32_t delta_cycles = cycles - sensor_record_last_cycles + sensor_record_cycle_remainder;
+	uint32_t delta_us;
+
+#if defined(STM32L476xx)
+	uint32_t cycles_per_us = SystemCoreClock / 1000000;
+#else
+	uint32_t cycles_per_us = 1000;
+#endif
+
+	delta_us = delta_cycles / cycles_per_us;
+	sensor_record_cycle_remainder = delta_cycles % cycles_per_us;
+
+	// one tick of slack, the two counters are not sampled at the same instant
+	if (tick_us > sensor_record_duration_us + delta_us + 1000)
+	{
+		delta_us = tick_us - sensor_record_duration_us;
+		sensor_record_cycle_remainder = 0;
+	}
+
+	sensor_record_last_cycles = cycles;
+	sensor_record_duration_us += delta_us;
+
+	return delta_us;
+}
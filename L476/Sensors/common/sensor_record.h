@@ -0,0 +1,72 @@
+/*
+ * sensor_record.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_RECORD_H_
+#define COMMON_SENSOR_RECORD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	register transaction recorder
+//=============================================================================
+// Captures every transaction at the driver seam (bmp280_memory_operation,
+// vl6180x_register_operation) into a RAM buffer while recording is on. The
+// buffer is a trace file as is, Tools/i2c_replay feeds it back into the
+// drivers on the host. Little endian:
+//
+//   header  "I2CR" | version | 3 reserved bytes
+//   record  flags | delta_us (LEB128) | register (LE16) | length | data
+//
+// flags hold the device (bits 0..2), write (bit 3) and failed (bit 4). data
+// is what the driver wrote or got back, a failed transaction has none. The
+// buffer is linear: when full, recording stops and later transactions only
+// count as dropped, so a trace never has holes.
+
+#define SENSOR_RECORD_MAGIC				"I2CR"
+#define SENSOR_RECORD_VERSION			(1)
+#define SENSOR_RECORD_HEADER_LENGTH		(8)
+#define SENSOR_RECORD_MAX_DATA_LENGTH	(255)
+
+#define SENSOR_RECORD_FLAG_DEVICE_MASK	(0x07)
+#define SENSOR_RECORD_FLAG_WRITE		(0x08)
+#define SENSOR_RECORD_FLAG_FAILED		(0x10)
+
+#ifndef SENSOR_RECORD_BUFFER_SIZE
+#define SENSOR_RECORD_BUFFER_SIZE		(8192)
+#endif
+
+// start recording before the sensors are probed, a replay needs the trimming
+// and configuration transactions of the initialization
+#ifndef SENSOR_RECORD_AT_BOOT
+#define SENSOR_RECORD_AT_BOOT			(0)
+#endif
+
+typedef enum
+{
+	SENSOR_RECORD_DEVICE_BMP280 = 0,
+	SENSOR_RECORD_DEVICE_VL6180X,
+	SENSOR_RECORD_DEVICE_COUNT,
+}sensor_record_device_enum;
+
+typedef struct
+{
+	bool is_recording;
+	uint32_t length;				// bytes in the buffer incl. header
+	uint32_t transaction_count;
+	uint32_t dropped_count;			// after the buffer filled up
+	uint32_t duration_us;
+}sensor_record_stats_struct;
+
+void sensor_record_start();
+void sensor_record_stop();
+void sensor_record_transaction(sensor_record_device_enum device, bool is_write, uint16_t register_address,
+							   const uint8_t *data_buffer, uint16_t data_length, bool result);
+const uint8_t *sensor_record_get_buffer(uint32_t *length);
+void sensor_record_get_stats(sensor_record_stats_struct *stats);
+
+#endif /* COMMON_SENSOR_RECORD_H_ */
@@ -0,0 +1,314 @@
+/*
+ * sensor_registry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include "main.h"
+#include "usart.h"
+
+#include "sensor_cycles.h"
+#include "sensor_registry.h"
+
+#include "../bmp280/bmp280_application.h"
+#include "../vl6180x/vl6180x_application.h"
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	const sensor_driver_struct *driver;
+	bool is_running;
+	uint32_t period_ms;
+	uint32_t last_read_tick_ms;
+	uint32_t start_tick_ms;
+	uint64_t read_time_total;
+	uint32_t read_count;
+	sensor_registry_stats_struct stats;
+}sensor_registry_entry_struct;
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// known drivers, probed in this order
+static const sensor_driver_struct *const sensor_registry_drivers[] =
+{
+	&bmp280_sensor_driver,
+	&vl6180x_sensor_driver,
+};
+
+#define SENSOR_REGISTRY_DRIVER_COUNT (sizeof(sensor_registry_drivers) / sizeof(sensor_registry_drivers[0]))
+
+// discovered sensors
+static sensor_registry_entry_struct sensor_registry_entries[SENSOR_REGISTRY_DRIVER_COUNT];
+static uint8_t sensor_registry_entry_count = 0;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief probe all known drivers, initialize and start the ones that answer
+ * 
+ * @param[out] number of sensors ready for sensor_registry_service()
+*/
+uint8_t sensor_registry_probe()
+{
+	uint8_t msg[92];
+	uint16_t msg_len;
+
+	sensor_cycles_initialize();
+	sensor_registry_entry_count = 0;
+
+	for (uint8_t n = 0; n < SENSOR_REGISTRY_DRIVER_COUNT; n++)
+	{
+		const sensor_driver_struct *driver = sensor_registry_drivers[n];
+		bool result = driver->probe();
+		const char *state = "not found";
+
+		if (result == true)
+		{
+			result = driver->initialize();
+			state = (result == true) ? "initialized" : "initialization failed";
+		}
+		if (result == true)
+		{
+			result = driver->start();
+			state = (result == true) ? "started" : "start failed";
+		}
+		if (result == true)
+		{
+			sensor_registry_entry_struct *entry = &sensor_registry_entries[sensor_registry_entry_count++];
+
+			*entry = (sensor_registry_entry_struct){0};
+			entry->driver = driver;
+			entry->is_running = true;
+			entry->period_ms = driver->period_ms;
+			entry->start_tick_ms = HAL_GetTick();
+			entry->last_read_tick_ms = entry->start_tick_ms;
+		}
+
+		msg_len = (uint16_t)sprintf((char*)msg, "REGISTRY - %s: %s\r\n", driver->name, state);
+		HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
+	}
+
+	return sensor_registry_entry_count;
+}
+
+
+/******************************************************************************
+ * @brief one acquisition pass: poll every sensor whose period elapsed and
+ * 		  hand valid samples to `handler`. Never waits for a conversion.
+ * 
+ * @param[out] true if no bus error occurred
+*/
+bool sensor_registry_service(sensor_registry_sample_handler *handler)
+{
+	bool result = true;
+
+	for (uint8_t n = 0; n < sensor_registry_entry_count; n++)
+	{
+		sensor_registry_entry_struct *entry = &sensor_registry_entries[n];
+		const sensor_driver_struct *driver = entry->driver;
+		uint32_t now_ms = HAL_GetTick();
+		sensor_raw_struct raw;
+		sensor_sample_struct sample;
+		bool is_ready = false;
+		bool is_ok;
+
+		if (entry->is_running == false || now_ms - entry->last_read_tick_ms < entry->period_ms)
+		{
+			continue;
+		}
+
+		uint32_t start = sensor_cycles_now();
+		is_ok = driver->read_raw(&raw, &is_ready);
+		entry->read_time_total += sensor_cycles_now() - start;
+		entry->read_count++;
+
+		if (is_ok == false)
+		{
+			entry->stats.error_count++;
+			result = false;
+		}
+		else if (is_ready == false)
+		{
+			entry->stats.not_ready_count++;
+		}
+		else
+		{
+			entry->last_read_tick_ms = now_ms;
+			sample.timestamp_ms = now_ms;
+
+			if (driver->convert(&raw, &sample.value) == true)
+			{
+				entry->stats.sample_count++;
+				if (handler != NULL)
+				{
+					handler(driver, &sample);
+				}
+			}
+			else
+			{
+				entry->stats.invalid_count++;
+			}
+
+			if (driver->is_single_shot == true && driver->start() == false)
+			{
+				entry->stats.error_count++;
+				result = false;
+			}
+		}
+	}
+
+	return result;
+}
+
+
+void sensor_registry_sleep()
+{
+	for (uint8_t n = 0; n < sensor_registry_entry_count; n++)
+	{
+		sensor_registry_stop(n);
+	}
+}
+
+
+uint8_t sensor_registry_get_count()
+{
+	return sensor_registry_entry_count;
+}
+
+
+const sensor_driver_struct *sensor_registry_get_driver(uint8_t index)
+{
+	return (index < sensor_registry_entry_count) ? sensor_registry_entries[index].driver : NULL;
+}
+
+
+/******************************************************************************
+ * @brief look up a discovered sensor by name, case insensitive
+ * 
+ * @param[out] true if found
+*/
+bool sensor_registry_find(const char *name, uint8_t *index)
+{
+	bool result = false;
+
+	for (uint8_t n = 0; n < sensor_registry_entry_count && result == false; n++)
+	{
+		const char *a = name;
+		const char *b = sensor_registry_entries[n].driver->name;
+
+		while (*a != '\0' && tolower((unsigned char)*a) == tolower((unsigned char)*b))
+		{
+			a++;
+			b++;
+		}
+		if (*a == '\0' && *b == '\0')
+		{
+			*index = n;
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief resume a stopped sensor, statistics restart
+*/
+bool sensor_registry_start(uint8_t index)
+{
+	bool result = (index < sensor_registry_entry_count);
+
+	if (result == true && sensor_registry_entries[index].is_running == false)
+	{
+		sensor_registry_entry_struct *entry = &sensor_registry_entries[index];
+
+		result = entry->driver->start();
+		if (result == true)
+		{
+			entry->is_running = true;
+			entry->start_tick_ms = HAL_GetTick();
+			entry->last_read_tick_ms = entry->start_tick_ms;
+			entry->read_time_total = 0;
+			entry->read_count = 0;
+			entry->stats = (sensor_registry_stats_struct){0};
+		}
+	}
+
+	return result;
+}
+
+
+bool sensor_registry_stop(uint8_t index)
+{
+	bool result = (index < sensor_registry_entry_count);
+
+	if (result == true && sensor_registry_entries[index].is_running == true)
+	{
+		result = sensor_registry_entries[index].driver->sleep();
+		sensor_registry_entries[index].is_running = false;
+	}
+
+	return result;
+}
+
+
+bool sensor_registry_is_running(uint8_t index)
+{
+	return (index < sensor_registry_entry_count) && sensor_registry_entries[index].is_running;
+}
+
+
+bool sensor_registry_set_period(uint8_t index, uint32_t period_ms)
+{
+	bool result = (index < sensor_registry_entry_count);
+
+	if (result == true)
+	{
+		sensor_registry_entries[index].period_ms = period_ms;
+	}
+
+	return result;
+}
+
+
+uint32_t sensor_registry_get_period(uint8_t index)
+{
+	return (index < sensor_registry_entry_count) ? sensor_registry_entries[index].period_ms : 0;
+}
+
+
+/******************************************************************************
+ * @brief throughput of a discovered sensor since it was started
+ * 
+ * @param[out] true if `index` is a discovered sensor
+*/
+bool sensor_registry_get_stats(uint8_t index, sensor_registry_stats_struct *stats)
+{
+	bool result = (index < sensor_registry_entry_count);
+
+	if (result == true)
+	{
+		const sensor_registry_entry_struct *entry = &sensor_registry_entries[index];
+		uint32_t elapsed_ms = HAL_GetTick() - entry->start_tick_ms;
+
+		*stats = entry->stats;
+		stats->rate_mHz = (elapsed_ms == 0) ? 0 : (uint32_t)(((uint64_t)entry->stats.sample_count * 1000000) / elapsed_ms);
+		stats->read_time = (entry->read_count == 0) ? 0 : (uint32_t)(entry->read_time_total / entry->read_count);
+	}
+
+	return result;
+}
@@ -0,0 +1,49 @@
+/*
+ * sensor_registry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_REGISTRY_H_
+#define COMMON_SENSOR_REGISTRY_H_
+
+#include "sensor_driver.h"
+
+//=============================================================================
+//	sensor registry
+//=============================================================================
+// Static table of all known sensor drivers. sensor_registry_probe() keeps the
+// ones that answer on the bus, sensor_registry_service() runs one
+// non-blocking acquisition pass over them. A new sensor only needs its
+// driver added to the table in sensor_registry.c.
+
+typedef void (sensor_registry_sample_handler)(const sensor_driver_struct *driver, const sensor_sample_struct *sample);
+
+typedef struct
+{
+	uint32_t sample_count;
+	uint32_t invalid_count;		// convert() rejected the sample
+	uint32_t not_ready_count;	// polls without new data
+	uint32_t error_count;		// bus errors
+	uint32_t rate_mHz;			// valid samples per 1000 s
+	uint32_t read_time;			// average read_raw duration in SENSOR_CYCLES_UNIT
+}sensor_registry_stats_struct;
+
+uint8_t sensor_registry_probe();
+bool sensor_registry_service(sensor_registry_sample_handler *handler);
+void sensor_registry_sleep();
+
+uint8_t sensor_registry_get_count();
+const sensor_driver_struct *sensor_registry_get_driver(uint8_t index);
+bool sensor_registry_find(const char *name, uint8_t *index);
+bool sensor_registry_get_stats(uint8_t index, sensor_registry_stats_struct *stats);
+
+// runtime control, e.g. from the console
+bool sensor_registry_start(uint8_t index);
+bool sensor_registry_stop(uint8_t index);
+bool sensor_registry_is_running(uint8_t index);
+bool sensor_registry_set_period(uint8_t index, uint32_t period_ms);
+uint32_t sensor_registry_get_period(uint8_t index);
+
+#endif /* COMMON_SENSOR_REGISTRY_H_ */
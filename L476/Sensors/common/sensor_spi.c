@@ -0,0 +1,292 @@
+/*
+ * sensor_spi.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <string.h>
+
+#include "sensor_spi.h"
+#include "sensor_memory.h"
+#include "sensor_trace.h"
+
+// The HAL SPI driver is not part of this project, the bus is driven through
+// the CMSIS registers (RM0351 40.4.9 "Communication using DMA").
+
+//=============================================================================
+//	defines
+//=============================================================================
+
+#define SENSOR_SPI_INSTANCE			SPI2
+#define SENSOR_SPI_GPIO_PORT		GPIOB
+#define SENSOR_SPI_GPIO_PINS		(GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15)
+
+#define SENSOR_SPI_DMA_RX			DMA1_Channel4
+#define SENSOR_SPI_DMA_TX			DMA1_Channel5
+#define SENSOR_SPI_DMA_REQUEST		1		// CSELR request number of SPI2 on channel 4 and 5
+
+#define SENSOR_SPI_READ_FLAG		0x80
+#define SENSOR_SPI_DUMMY_BYTE		0xFF
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static bool sensor_spi_transfer(const sensor_spi_device_struct *device, const uint16_t transfer_length);
+static void sensor_spi_print_failure(const sensor_spi_device_struct *device, const char *operation, const uint8_t register_address, const uint16_t data_length);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// DMA buffers, a transfer is [address, data...] for reads and [address, data]* for writes
+static uint8_t sensor_spi_tx_buffer[SENSOR_SPI_MAX_TRANSFER] SENSOR_SRAM2_DATA;
+static uint8_t sensor_spi_rx_buffer[SENSOR_SPI_MAX_TRANSFER] SENSOR_SRAM2_DATA;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief configure pins, DMA channels and SPI2 as master, mode 3, 8 bit.
+ * 		  The prescaler is derived from the current PCLK1, call again after
+ * 		  a clock change.
+ * 
+ * @param[out] true if PCLK1 allows a clock <= SENSOR_SPI_MAX_CLOCK_HZ
+*/
+bool sensor_spi_initialize()
+{
+	bool result = true;
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	uint32_t pclk_hz = HAL_RCC_GetPCLK1Freq();
+	uint32_t prescaler = 0;
+
+	// f_SCK = PCLK / 2^(BR + 1)
+	while (prescaler < 7 && (pclk_hz >> (prescaler + 1)) > SENSOR_SPI_MAX_CLOCK_HZ)
+	{
+		prescaler++;
+	}
+	if ((pclk_hz >> (prescaler + 1)) > SENSOR_SPI_MAX_CLOCK_HZ)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		__HAL_RCC_GPIOB_CLK_ENABLE();
+		__HAL_RCC_SPI2_CLK_ENABLE();
+		__HAL_RCC_DMA1_CLK_ENABLE();
+
+		GPIO_InitStruct.Pin = SENSOR_SPI_GPIO_PINS;
+		GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+		GPIO_InitStruct.Pull = GPIO_NOPULL;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+		GPIO_InitStruct.Alternate = GPIO_AF5_SPI2;
+		HAL_GPIO_Init(SENSOR_SPI_GPIO_PORT, &GPIO_InitStruct);
+
+		// route SPI2 requests to channel 4 (RX) and 5 (TX)
+		DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~(DMA_CSELR_C4S | DMA_CSELR_C5S)) |
+							(SENSOR_SPI_DMA_REQUEST << DMA_CSELR_C4S_Pos) | (SENSOR_SPI_DMA_REQUEST << DMA_CSELR_C5S_Pos);
+
+		SENSOR_SPI_DMA_RX->CCR = 0;
+		SENSOR_SPI_DMA_RX->CPAR = (uint32_t)(uintptr_t)&SENSOR_SPI_INSTANCE->DR;
+		SENSOR_SPI_DMA_RX->CMAR = (uint32_t)(uintptr_t)sensor_spi_rx_buffer;
+
+		SENSOR_SPI_DMA_TX->CCR = 0;
+		SENSOR_SPI_DMA_TX->CPAR = (uint32_t)(uintptr_t)&SENSOR_SPI_INSTANCE->DR;
+		SENSOR_SPI_DMA_TX->CMAR = (uint32_t)(uintptr_t)sensor_spi_tx_buffer;
+
+		// master, software NSS, CPOL = CPHA = 1, 8 bit frames, RXNE at 8 bit
+		SENSOR_SPI_INSTANCE->CR1 = 0;
+		SENSOR_SPI_INSTANCE->CR2 = (0b0111 << SPI_CR2_DS_Pos) | SPI_CR2_FRXTH;
+		SENSOR_SPI_INSTANCE->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | SPI_CR1_CPOL | SPI_CR1_CPHA | (prescaler << SPI_CR1_BR_Pos);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief configure the chip select pin of `device` (idle high)
+ * 
+ * @param[out] true if succeeds
+*/
+bool sensor_spi_initialize_device(const sensor_spi_device_struct *device)
+{
+	bool result = true;
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	if (device == NULL || device->cs_port == NULL)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		HAL_GPIO_WritePin(device->cs_port, device->cs_pin, GPIO_PIN_SET);
+
+		GPIO_InitStruct.Pin = device->cs_pin;
+		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+		GPIO_InitStruct.Pull = GPIO_NOPULL;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+		HAL_GPIO_Init(device->cs_port, &GPIO_InitStruct);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief read consecutive registers starting at `register_address` in one
+ * 		  DMA burst
+ * 
+ * @param[in] device           chip select of the device
+ * @param[in] register_address first register
+ * @param[in] data_buffer
+ * @param[in] data_length      at most SENSOR_SPI_MAX_TRANSFER - 1
+ * 
+ * @param[out] true if succeeds
+*/
+bool sensor_spi_read_registers(const sensor_spi_device_struct *device, const uint8_t register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	bool result = true;
+
+	if (device == NULL || data_length == 0 || data_length >= SENSOR_SPI_MAX_TRANSFER)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		sensor_spi_tx_buffer[0] = register_address | SENSOR_SPI_READ_FLAG;
+		memset(&sensor_spi_tx_buffer[1], SENSOR_SPI_DUMMY_BYTE, data_length);
+
+		result = sensor_spi_transfer(device, data_length + 1);
+	}
+
+	if (result == true)
+	{
+		memcpy(data_buffer, &sensor_spi_rx_buffer[1], data_length);
+	}
+	else
+	{
+		// no trace on success, printing would take longer than the transfer
+		sensor_spi_print_failure(device, "read", register_address, data_length);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief write consecutive registers starting at `register_address`,
+ * 		  each data byte is sent with its own address
+ * 
+ * @param[in] device           chip select of the device
+ * @param[in] register_address first register
+ * @param[in] data_buffer
+ * @param[in] data_length      at most SENSOR_SPI_MAX_TRANSFER / 2
+ * 
+ * @param[out] true if succeeds
+*/
+bool sensor_spi_write_registers(const sensor_spi_device_struct *device, const uint8_t register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	bool result = true;
+
+	if (device == NULL || data_length == 0 || data_length > SENSOR_SPI_MAX_TRANSFER / 2)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		for (uint16_t n = 0; n < data_length; n++)
+		{
+			sensor_spi_tx_buffer[2 * n] = (uint8_t)(register_address + n) & ~SENSOR_SPI_READ_FLAG;
+			sensor_spi_tx_buffer[2 * n + 1] = data_buffer[n];
+		}
+
+		result = sensor_spi_transfer(device, 2 * data_length);
+	}
+
+	if (result == false)
+	{
+		sensor_spi_print_failure(device, "write", register_address, data_length);
+	}
+
+	return result;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief full duplex DMA transfer of `transfer_length` bytes from the TX
+ * 		  buffer into the RX buffer with the chip select held low
+ * 
+ * @param[out] true if the RX channel completed within SENSOR_SPI_TIMEOUT_MS
+*/
+static bool sensor_spi_transfer(const sensor_spi_device_struct *device, const uint16_t transfer_length)
+{
+	bool result = true;
+	uint32_t start_tick_ms;
+
+	HAL_GPIO_WritePin(device->cs_port, device->cs_pin, GPIO_PIN_RESET);
+
+	// RX first so no byte is lost, then TX, then the peripheral
+	DMA1->IFCR = DMA_IFCR_CGIF4 | DMA_IFCR_CGIF5;
+	SENSOR_SPI_INSTANCE->CR2 |= SPI_CR2_RXDMAEN;
+
+	SENSOR_SPI_DMA_RX->CNDTR = transfer_length;
+	SENSOR_SPI_DMA_RX->CCR = DMA_CCR_MINC | DMA_CCR_PL_1 | DMA_CCR_EN;
+	SENSOR_SPI_DMA_TX->CNDTR = transfer_length;
+	SENSOR_SPI_DMA_TX->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+
+	SENSOR_SPI_INSTANCE->CR2 |= SPI_CR2_TXDMAEN;
+	SENSOR_SPI_INSTANCE->CR1 |= SPI_CR1_SPE;
+
+	start_tick_ms = HAL_GetTick();
+	while ((DMA1->ISR & (DMA_ISR_TCIF4 | DMA_ISR_TEIF4 | DMA_ISR_TEIF5)) == 0 && result == true)
+	{
+		if (HAL_GetTick() - start_tick_ms > SENSOR_SPI_TIMEOUT_MS)
+		{
+			result = false;
+		}
+	}
+	if ((DMA1->ISR & (DMA_ISR_TEIF4 | DMA_ISR_TEIF5)) != 0)
+	{
+		result = false;
+	}
+
+	// the last RX byte implies the bus is idle, BSY is checked for the timeout case
+	start_tick_ms = HAL_GetTick();
+	while ((SENSOR_SPI_INSTANCE->SR & SPI_SR_BSY) != 0 && HAL_GetTick() - start_tick_ms <= SENSOR_SPI_TIMEOUT_MS);
+
+	SENSOR_SPI_DMA_TX->CCR = 0;
+	SENSOR_SPI_DMA_RX->CCR = 0;
+	SENSOR_SPI_INSTANCE->CR1 &= ~SPI_CR1_SPE;
+	SENSOR_SPI_INSTANCE->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+	DMA1->IFCR = DMA_IFCR_CGIF4 | DMA_IFCR_CGIF5;
+
+	// drain the RX FIFO after an aborted transfer
+	while ((SENSOR_SPI_INSTANCE->SR & SPI_SR_FRLVL) != 0)
+	{
+		(void)*(volatile uint8_t *)&SENSOR_SPI_INSTANCE->DR;
+	}
+
+	HAL_GPIO_WritePin(device->cs_port, device->cs_pin, GPIO_PIN_SET);
+
+	return result;
+}
+
+
+static void sensor_spi_print_failure(const sensor_spi_device_struct *device, const char *operation, const uint8_t register_address, const uint16_t data_length)
+{
+	SENSOR_TRACE(SENSOR_LOG_LEVEL_ERROR, "%s - %s registers: addr: 0x%03x | len: %2d [FAILED]\r\n",
+			SENSOR_TRACE_STRING((device != NULL) ? device->name : "SPI"), SENSOR_TRACE_STRING(operation), register_address, data_length);
+}
@@ -0,0 +1,48 @@
+/*
+ * sensor_spi.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_SPI_H_
+#define COMMON_SENSOR_SPI_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "main.h"
+
+//=============================================================================
+//	register transport
+//=============================================================================
+// Register read/write path for sensors on the SPI bus, same seam as
+// sensor_i2c. Transfers run on DMA, the CPU only waits for completion.
+//
+// bus:      SPI2, PB13 (SCK) / PB14 (MISO) / PB15 (MOSI), mode 3, <= 10 MHz
+// DMA:      DMA1 channel 4 (SPI2_RX) / channel 5 (SPI2_TX)
+// protocol: Bosch style, bit 7 of the register address set for reads, one
+//           address byte per data byte for writes
+//
+// 3-wire devices (SDI/SDO shared) use the same transfers: MOSI drives the
+// shared line through a series resistor (~1k) and MISO reads it directly,
+// the device overrides the 0xFF dummy bytes while it answers.
+
+#define SENSOR_SPI_MAX_CLOCK_HZ		10000000
+#define SENSOR_SPI_MAX_TRANSFER		32		// bytes on the wire, incl. address bytes
+#define SENSOR_SPI_TIMEOUT_MS		5
+
+typedef struct
+{
+	const char *name;
+	GPIO_TypeDef *cs_port;
+	uint16_t cs_pin;
+}sensor_spi_device_struct;
+
+bool sensor_spi_initialize();
+bool sensor_spi_initialize_device(const sensor_spi_device_struct *device);
+
+bool sensor_spi_read_registers(const sensor_spi_device_struct *device, const uint8_t register_address, uint8_t *data_buffer, const uint16_t data_length);
+bool sensor_spi_write_registers(const sensor_spi_device_struct *device, const uint8_t register_address, uint8_t *data_buffer, const uint16_t data_length);
+
+#endif /* COMMON_SENSOR_SPI_H_ */
@@ -0,0 +1,58 @@
+/*
+ * sensor_trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "usart.h"
+
+#include "sensor_trace.h"
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static uint32_t sensor_trace_frame_count = 0;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief send one trace frame, called by SENSOR_TRACE() only. Arguments
+ * 		  beyond SENSOR_TRACE_MAX_ARGUMENTS are dropped, the count in the frame
+ * 		  tells the decoder.
+*/
+void sensor_trace_emit(uint16_t id, const uint32_t *arguments, uint8_t argument_count)
+{
+	uint8_t frame[4 + SENSOR_TRACE_MAX_ARGUMENTS * 4];
+	uint16_t frame_length = 0;
+
+	if (argument_count > SENSOR_TRACE_MAX_ARGUMENTS)
+	{
+		argument_count = SENSOR_TRACE_MAX_ARGUMENTS;
+	}
+
+	frame[frame_length++] = SENSOR_TRACE_FRAME_START;
+	frame[frame_length++] = (uint8_t)(id);
+	frame[frame_length++] = (uint8_t)(id >> 8);
+	frame[frame_length++] = argument_count;
+	for (uint8_t n = 0; n < argument_count; n++)
+	{
+		frame[frame_length++] = (uint8_t)(arguments[n]);
+		frame[frame_length++] = (uint8_t)(arguments[n] >> 8);
+		frame[frame_length++] = (uint8_t)(arguments[n] >> 16);
+		frame[frame_length++] = (uint8_t)(arguments[n] >> 24);
+	}
+
+	HAL_UART_Transmit(&huart2, frame, frame_length, HAL_MAX_DELAY);
+	sensor_trace_frame_count++;
+}
+
+
+uint32_t sensor_trace_get_frame_count()
+{
+	return sensor_trace_frame_count;
+}
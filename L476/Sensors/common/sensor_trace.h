@@ -0,0 +1,53 @@
+/*
+ * sensor_trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef COMMON_SENSOR_TRACE_H_
+#define COMMON_SENSOR_TRACE_H_
+
+#include <stdint.h>
+
+#include "sensor_log.h"
+
+//=============================================================================
+//	deferred trace logging
+//=============================================================================
+// A trace site keeps its printf format string in the .sensor_trace ELF
+// section, which the linker script never loads into flash. The string's
+// address in that section is the site's 16 bit ID, the MCU only sends the ID
+// and the raw 32 bit arguments:
+//
+//   0x1E | ID (LE16) | argument count | arguments (LE32 each)
+//
+// Tools/trace_decode looks the ID up in the firmware ELF and formats the
+// text on the host, plain console text on the same UART passes through.
+// "%s" arguments must point to constant strings in flash, the decoder reads
+// them from the ELF as well.
+//
+//   SENSOR_TRACE(SENSOR_LOG_LEVEL_TRACE, "%s - read: addr: 0x%03x", SENSOR_TRACE_STRING(name), address);
+
+#define SENSOR_TRACE_FRAME_START	(0x1E)	// ASCII record separator, never in console text
+#define SENSOR_TRACE_MAX_ARGUMENTS	(6)
+
+#define SENSOR_TRACE_STRING(text)	((uint32_t)(uintptr_t)(text))
+
+#define SENSOR_TRACE(level, format, ...) \
+	do \
+	{ \
+		if (SENSOR_LOG_ENABLED(level)) \
+		{ \
+			static const char sensor_trace_format[] __attribute__((section(".sensor_trace"), used)) = format; \
+			const uint32_t sensor_trace_arguments[] = {0, __VA_ARGS__}; \
+			sensor_trace_emit((uint16_t)(uintptr_t)sensor_trace_format, &sensor_trace_arguments[1], \
+					(uint8_t)(sizeof(sensor_trace_arguments) / sizeof(sensor_trace_arguments[0]) - 1)); \
+		} \
+	} \
+	while (0)
+
+void sensor_trace_emit(uint16_t id, const uint32_t *arguments, uint8_t argument_count);
+uint32_t sensor_trace_get_frame_count();
+
+#endif /* COMMON_SENSOR_TRACE_H_ */
@@ -0,0 +1,238 @@
+/*
+ * console.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "console.h"
+
+#include "../common/sensor_memory.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void console_execute(char *line);
+static uint8_t console_tokenize(char *line, char *argv[]);
+static void console_print_help();
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// command table and output, set once by console_initialize()
+static const console_command_struct *console_commands = NULL;
+static uint8_t console_command_count = 0;
+static console_write_function *console_write = NULL;
+
+// RX queue, head written by the interrupt, tail by console_process()
+static volatile uint8_t console_rx_buffer[CONSOLE_RX_BUFFER_SIZE] SENSOR_SRAM2_DATA;
+static volatile uint16_t console_rx_head = 0;
+static volatile uint16_t console_rx_tail = 0;
+static volatile uint32_t console_rx_overflow_count = 0;
+
+// line being edited
+static char console_line[CONSOLE_LINE_LENGTH];
+static uint8_t console_line_length = 0;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+void console_initialize(const console_command_struct *commands, uint8_t command_count, console_write_function *write_fn)
+{
+	console_commands = commands;
+	console_command_count = command_count;
+	console_write = write_fn;
+
+	console_rx_tail = console_rx_head;
+	console_line_length = 0;
+
+	console_printf("\r\n> ");
+}
+
+
+/******************************************************************************
+ * @brief queue one received byte, safe to call from the RX interrupt.
+ * 		  Bytes are dropped (and counted) while the queue is full.
+*/
+SENSOR_RAM_FUNCTION void console_receive_byte(uint8_t byte)
+{
+	uint16_t next_head = (console_rx_head + 1) & (CONSOLE_RX_BUFFER_SIZE - 1);
+
+	if (next_head != console_rx_tail)
+	{
+		console_rx_buffer[console_rx_head] = byte;
+		console_rx_head = next_head;
+	}
+	else
+	{
+		console_rx_overflow_count++;
+	}
+}
+
+
+/******************************************************************************
+ * @brief drain the RX queue: echo, line editing (backspace) and execution
+ * 		  of completed lines. Call from the main loop, never from an interrupt.
+*/
+void console_process()
+{
+	while (console_rx_tail != console_rx_head)
+	{
+		char character = (char)console_rx_buffer[console_rx_tail];
+		console_rx_tail = (console_rx_tail + 1) & (CONSOLE_RX_BUFFER_SIZE - 1);
+
+		if (character == '\r' || character == '\n')
+		{
+			if (console_line_length > 0)
+			{
+				console_line[console_line_length] = '\0';
+				console_line_length = 0;
+
+				console_printf("\r\n");
+				console_execute(console_line);
+				console_printf("> ");
+			}
+		}
+		else if (character == '\b' || character == 0x7F)
+		{
+			if (console_line_length > 0)
+			{
+				console_line_length--;
+				console_printf("\b \b");
+			}
+		}
+		else if (character >= ' ' && character <= '~' && console_line_length < CONSOLE_LINE_LENGTH - 1)
+		{
+			console_line[console_line_length++] = character;
+			console_printf("%c", character);
+		}
+	}
+}
+
+
+void console_printf(const char *format, ...)
+{
+	char output[CONSOLE_OUTPUT_LENGTH];
+	va_list arguments;
+	int length;
+
+	if (console_write != NULL)
+	{
+		va_start(arguments, format);
+		length = vsnprintf(output, sizeof(output), format, arguments);
+		va_end(arguments);
+
+		if (length > 0)
+		{
+			console_write(output, (length < (int)sizeof(output)) ? (uint16_t)length : (uint16_t)(sizeof(output) - 1));
+		}
+	}
+}
+
+
+/******************************************************************************
+ * @brief decimal or 0x-prefixed hexadecimal integer
+ * 
+ * @param[out] true if the whole text is a number
+*/
+bool console_parse_int(const char *text, int32_t *value)
+{
+	char *end;
+	long parsed = strtol(text, &end, 0);
+	bool result = (end != text && *end == '\0');
+
+	if (result == true)
+	{
+		*value = (int32_t)parsed;
+	}
+	return result;
+}
+
+
+uint32_t console_get_overflow_count()
+{
+	return console_rx_overflow_count;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static void console_execute(char *line)
+{
+	char *argv[CONSOLE_MAX_ARGUMENTS];
+	uint8_t argc = console_tokenize(line, argv);
+	bool is_found = (argc == 0);	// blank line
+
+	if (is_found == false && strcmp(argv[0], "help") == 0)
+	{
+		console_print_help();
+		is_found = true;
+	}
+
+	for (uint8_t n = 0; n < console_command_count && is_found == false; n++)
+	{
+		if (strcmp(argv[0], console_commands[n].name) == 0)
+		{
+			is_found = true;
+			if (console_commands[n].handler(argc, argv) == false)
+			{
+				console_printf("usage: %s %s\r\n", console_commands[n].name, console_commands[n].usage);
+			}
+		}
+	}
+
+	if (is_found == false)
+	{
+		console_printf("unknown command '%s', try help\r\n", argv[0]);
+	}
+}
+
+
+/******************************************************************************
+ * @brief split `line` in place at spaces, extra arguments are ignored
+*/
+static uint8_t console_tokenize(char *line, char *argv[])
+{
+	uint8_t argc = 0;
+	char *cursor = line;
+
+	while (*cursor != '\0' && argc < CONSOLE_MAX_ARGUMENTS)
+	{
+		while (*cursor == ' ')
+		{
+			*cursor++ = '\0';
+		}
+		if (*cursor != '\0')
+		{
+			argv[argc++] = cursor;
+		}
+		while (*cursor != ' ' && *cursor != '\0')
+		{
+			cursor++;
+		}
+	}
+
+	return argc;
+}
+
+
+static void console_print_help()
+{
+	console_printf("help\r\n");
+	for (uint8_t n = 0; n < console_command_count; n++)
+	{
+		console_printf("%s %s\r\n", console_commands[n].name, console_commands[n].usage);
+	}
+}
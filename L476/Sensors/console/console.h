@@ -0,0 +1,45 @@
+/*
+ * console.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef CONSOLE_CONSOLE_H_
+#define CONSOLE_CONSOLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	line console
+//=============================================================================
+// HAL-free command line: the RX interrupt only queues bytes with
+// console_receive_byte(), console_process() assembles and executes lines from
+// the main loop. Lines are tokenized in place, nothing is allocated.
+
+#define CONSOLE_RX_BUFFER_SIZE		128		// power of two
+#define CONSOLE_LINE_LENGTH			64
+#define CONSOLE_MAX_ARGUMENTS		6
+#define CONSOLE_OUTPUT_LENGTH		128
+
+// argv[0] is the command name, return false to print the usage
+typedef bool (console_command_function)(uint8_t argc, char *argv[]);
+typedef void (console_write_function)(const char *text, uint16_t length);
+
+typedef struct
+{
+	const char *name;
+	const char *usage;
+	console_command_function *handler;
+}console_command_struct;
+
+void console_initialize(const console_command_struct *commands, uint8_t command_count, console_write_function *write_fn);
+void console_receive_byte(uint8_t byte);
+void console_process();
+
+void console_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+bool console_parse_int(const char *text, int32_t *value);
+uint32_t console_get_overflow_count();
+
+#endif /* CONSOLE_CONSOLE_H_ */
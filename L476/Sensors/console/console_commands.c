@@ -0,0 +1,545 @@
+/*
+ * console_commands.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <string.h>
+#include <strings.h>
+
+#include "console_commands.h"
+#include "console_uart.h"
+
+#include "../common/sensor_clock.h"
+#include "../common/sensor_cycles.h"
+#include "../common/sensor_format.h"
+#include "../common/sensor_format_benchmark.h"
+#include "../common/sensor_log.h"
+#include "../common/sensor_memory.h"
+#include "../common/sensor_memory_benchmark.h"
+#include "../common/sensor_record.h"
+#include "../common/sensor_registry.h"
+#include "../common/sensor_trace.h"
+#include "../bmp280/bmp280.h"
+#include "../bmp280/bmp280_application.h"
+#include "../bmp280/bmp280_benchmark.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static bool console_commands_sensors(uint8_t argc, char *argv[]);
+static bool console_commands_get(uint8_t argc, char *argv[]);
+static bool console_commands_set(uint8_t argc, char *argv[]);
+static bool console_commands_start(uint8_t argc, char *argv[]);
+static bool console_commands_stop(uint8_t argc, char *argv[]);
+static bool console_commands_stats(uint8_t argc, char *argv[]);
+static bool console_commands_log(uint8_t argc, char *argv[]);
+static bool console_commands_baud(uint8_t argc, char *argv[]);
+static bool console_commands_uarttest(uint8_t argc, char *argv[]);
+static bool console_commands_clock(uint8_t argc, char *argv[]);
+static bool console_commands_membench(uint8_t argc, char *argv[]);
+static bool console_commands_fmtbench(uint8_t argc, char *argv[]);
+static bool console_commands_compbench(uint8_t argc, char *argv[]);
+static bool console_commands_record(uint8_t argc, char *argv[]);
+
+static bool console_commands_find_sensor(const char *name, uint8_t *index);
+static bool console_commands_run_control(const char *name, bool (*control)(uint8_t index));
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static const console_command_struct console_commands_table[] =
+{
+	{"sensors", "",                              &console_commands_sensors},
+	{"get",     "<sensor> <period|key>",         &console_commands_get},
+	{"set",     "<sensor> <period|key> <value>", &console_commands_set},
+	{"start",   "<sensor|all>",                  &console_commands_start},
+	{"stop",    "<sensor|all>",                  &console_commands_stop},
+	{"stats",   "",                              &console_commands_stats},
+	{"log",     "[off|error|info|trace]",        &console_commands_log},
+	{"baud",    "[<rate>|auto]",                 &console_commands_baud},
+	{"uarttest", "",                             &console_commands_uarttest},
+	{"clock",   "[boost|run|lowpower]",          &console_commands_clock},
+	{"membench", "",                             &console_commands_membench},
+	{"fmtbench", "",                             &console_commands_fmtbench},
+	{"compbench", "[exact]",                     &console_commands_compbench},
+	{"record",  "[start|stop|dump]",             &console_commands_record},
+};
+
+static const char *const console_commands_log_levels[] = {"off", "error", "info", "trace"};
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool console_commands_initialize()
+{
+	return console_uart_initialize(console_commands_table, sizeof(console_commands_table) / sizeof(console_commands_table[0]));
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static bool console_commands_sensors(uint8_t argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	for (uint8_t n = 0; n < sensor_registry_get_count(); n++)
+	{
+		const sensor_driver_struct *driver = sensor_registry_get_driver(n);
+
+		console_printf("%-8s %-4s period %lu ms, %s\r\n", driver->name, driver->unit,
+				(unsigned long)sensor_registry_get_period(n),
+				(sensor_registry_is_running(n) == true) ? "running" : "stopped");
+	}
+
+	return true;
+}
+
+
+static bool console_commands_get(uint8_t argc, char *argv[])
+{
+	bool result = (argc == 3);
+	uint8_t index = 0;
+	int32_t value = 0;
+
+	if (result == true)
+	{
+		result = console_commands_find_sensor(argv[1], &index);
+	}
+	if (result == true)
+	{
+		const sensor_driver_struct *driver = sensor_registry_get_driver(index);
+		bool is_known = true;
+
+		if (strcasecmp(argv[2], "period") == 0)
+		{
+			value = (int32_t)sensor_registry_get_period(index);
+		}
+		else
+		{
+			is_known = (driver->get_config != NULL) && driver->get_config(argv[2], &value);
+		}
+
+		if (is_known == true)
+		{
+			console_printf("%s %s = %ld\r\n", driver->name, argv[2], (long)value);
+		}
+		else
+		{
+			console_printf("%s: unknown key '%s'\r\n", driver->name, argv[2]);
+		}
+	}
+
+	return result;
+}
+
+
+static bool console_commands_set(uint8_t argc, char *argv[])
+{
+	bool result = (argc == 4);
+	uint8_t index = 0;
+	int32_t value = 0;
+
+	if (result == true)
+	{
+		result = console_parse_int(argv[3], &value);
+	}
+	if (result == true)
+	{
+		result = console_commands_find_sensor(argv[1], &index);
+	}
+	if (result == true)
+	{
+		const sensor_driver_struct *driver = sensor_registry_get_driver(index);
+		bool is_set;
+
+		if (strcasecmp(argv[2], "period") == 0)
+		{
+			is_set = (value >= 0) && sensor_registry_set_period(index, (uint32_t)value);
+		}
+		else
+		{
+			is_set = (driver->set_config != NULL) && driver->set_config(argv[2], value);
+		}
+
+		console_printf("%s %s: %s\r\n", driver->name, argv[2], (is_set == true) ? "ok" : "rejected");
+	}
+
+	return result;
+}
+
+
+static bool console_commands_start(uint8_t argc, char *argv[])
+{
+	return (argc == 2) && console_commands_run_control(argv[1], &sensor_registry_start);
+}
+
+
+static bool console_commands_stop(uint8_t argc, char *argv[])
+{
+	return (argc == 2) && console_commands_run_control(argv[1], &sensor_registry_stop);
+}
+
+
+static bool console_commands_stats(uint8_t argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	for (uint8_t n = 0; n < sensor_registry_get_count(); n++)
+	{
+		sensor_registry_stats_struct stats;
+
+		sensor_registry_get_stats(n, &stats);
+		console_printf("%-8s %lu samples, %lu invalid, %lu not ready, %lu errors, %lu mHz, read %lu\r\n",
+				sensor_registry_get_driver(n)->name,
+				(unsigned long)stats.sample_count, (unsigned long)stats.invalid_count,
+				(unsigned long)stats.not_ready_count, (unsigned long)stats.error_count,
+				(unsigned long)stats.rate_mHz, (unsigned long)stats.read_time);
+	}
+
+	if (sensor_registry_find("bmp280", &(uint8_t){0}) == true)
+	{
+		uint32_t duty_cycle_ppm;
+		uint32_t rate_mHz;
+
+		bmp280_application_get_duty_cycle(&duty_cycle_ppm, &rate_mHz);
+		console_printf("bmp280   %lu duplicates, duty %lu ppm\r\n",
+				(unsigned long)bmp280_get_duplicate_count(), (unsigned long)duty_cycle_ppm);
+	}
+
+	console_printf("console  %lu rx overflows\r\n", (unsigned long)console_get_overflow_count());
+	console_printf("trace    %lu frames, decode with Tools/trace_decode\r\n", (unsigned long)sensor_trace_get_frame_count());
+
+	sensor_memory_usage_struct usage;
+
+	sensor_memory_get_usage(&usage);
+	console_printf("memory   stack %lu/%lu, heap %lu/%lu (peak %lu, %lu failed), headroom %lu bytes\r\n",
+			(unsigned long)usage.stack_peak, (unsigned long)usage.stack_reserved,
+			(unsigned long)usage.heap_used, (unsigned long)usage.heap_reserved, (unsigned long)usage.heap_peak,
+			(unsigned long)usage.heap_fail_count, (unsigned long)usage.headroom);
+
+	return true;
+}
+
+
+static bool console_commands_log(uint8_t argc, char *argv[])
+{
+	bool result = (argc <= 2);
+
+	if (result == true && argc == 2)
+	{
+		result = false;
+		for (uint8_t n = 0; n < sizeof(console_commands_log_levels) / sizeof(console_commands_log_levels[0]); n++)
+		{
+			if (strcasecmp(argv[1], console_commands_log_levels[n]) == 0)
+			{
+				sensor_log_level = (sensor_log_level_enum)n;
+				result = true;
+			}
+		}
+	}
+	if (result == true)
+	{
+		console_printf("log level %s\r\n", console_commands_log_levels[sensor_log_level]);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief without argument report the line rate, otherwise run the switch
+ * 		  handshake (console_uart.h), the host has to follow
+*/
+static bool console_commands_baud(uint8_t argc, char *argv[])
+{
+	bool result = (argc <= 2);
+	int32_t baud = 0;
+
+	if (result == true && argc == 1)
+	{
+		uint8_t oversampling;
+		int32_t error_ppm = console_uart_get_baud_error_ppm(console_uart_get_baud(), &oversampling);
+
+		console_printf("baud %lu, oversampling %u, error %ld ppm\r\n", (unsigned long)console_uart_get_baud(),
+				(unsigned int)console_uart_get_oversampling(), (long)error_ppm);
+	}
+	else if (result == true && strcasecmp(argv[1], "auto") == 0)
+	{
+		console_uart_auto_baud();
+	}
+	else if (result == true)
+	{
+		result = console_parse_int(argv[1], &baud) && (baud > 0);
+		if (result == true && console_uart_set_baud((uint32_t)baud) == false)
+		{
+			console_printf("baud %ld rejected\r\n", (long)baud);
+		}
+	}
+
+	return result;
+}
+
+
+static bool console_commands_uarttest(uint8_t argc, char *argv[])
+{
+	console_uart_test_struct results[8];
+	uint8_t count;
+
+	(void)argc;
+	(void)argv;
+
+	console_printf("loopback test, line noise follows\r\n");
+	count = console_uart_self_test(results, sizeof(results) / sizeof(results[0]));
+
+	console_printf("\r\n");
+	for (uint8_t n = 0; n < count; n++)
+	{
+		console_printf("%7lu baud x%-2u %6lu B/s (%3lu %%), %u/%u bytes, %u mismatch, %u overrun, %u framing\r\n",
+				(unsigned long)results[n].baud, (unsigned int)results[n].oversampling, (unsigned long)results[n].bytes_per_s,
+				(unsigned long)(((uint64_t)results[n].bytes_per_s * 1000) / results[n].baud),
+				(unsigned int)results[n].received_count, (unsigned int)CONSOLE_UART_TEST_LENGTH,
+				(unsigned int)results[n].mismatch_count, (unsigned int)results[n].overrun_count, (unsigned int)results[n].framing_count);
+	}
+
+	return true;
+}
+
+
+/******************************************************************************
+ * @brief switch the clock profile, without argument list switch latency and
+ * 		  residency per profile and the resulting average run current
+*/
+static bool console_commands_clock(uint8_t argc, char *argv[])
+{
+	bool result = (argc <= 2);
+	sensor_clock_profile_enum profile;
+
+	if (result == true && argc == 2)
+	{
+		result = sensor_clock_find_profile(argv[1], &profile);
+		if (result == true)
+		{
+			console_printf("clock %s: %s\r\n", argv[1], (sensor_clock_set_profile(profile) == true) ? "ok" : "rejected");
+		}
+	}
+	else if (result == true)
+	{
+		sensor_clock_stats_struct stats;
+
+		for (uint8_t n = 0; sensor_clock_get_stats((sensor_clock_profile_enum)n, &stats) == true; n++)
+		{
+			console_printf("%c %-8s %2lu MHz, %lu switches, last %lu us, max %lu us, %lu ms, %lu uA\r\n",
+					(n == sensor_clock_get_profile()) ? '*' : ' ', stats.name, (unsigned long)(stats.sysclk_hz / 1000000),
+					(unsigned long)stats.switch_count, (unsigned long)stats.last_switch_us, (unsigned long)stats.max_switch_us,
+					(unsigned long)stats.residency_ms, (unsigned long)stats.current_uA);
+		}
+		console_printf("average %lu uA\r\n", (unsigned long)sensor_clock_get_average_current_uA());
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief cycles per sample of the hot kernels under each flash accelerator
+ * 		  setting, where the kernels live decides how much the setting matters
+*/
+static bool console_commands_membench(uint8_t argc, char *argv[])
+{
+	sensor_memory_benchmark_result_struct results[SENSOR_MEMORY_BENCHMARK_COUNT];
+	sensor_clock_stats_struct clock;
+
+	(void)argc;
+	(void)argv;
+
+	sensor_memory_benchmark_run(results);
+	sensor_clock_get_stats(sensor_clock_get_profile(), &clock);
+
+	console_printf("compensation in %s, filter in %s, %s %lu MHz\r\n", sensor_memory_benchmark_get_compensation_region(),
+			sensor_memory_benchmark_get_filter_region(), clock.name, (unsigned long)(clock.sysclk_hz / 1000000));
+	for (uint8_t n = 0; n < SENSOR_MEMORY_BENCHMARK_COUNT; n++)
+	{
+		uint32_t compensation_100 = (uint32_t)(((uint64_t)results[n].compensation_ticks * 100) / results[n].sample_count);
+		uint32_t filter_100 = (uint32_t)(((uint64_t)results[n].filter_ticks * 100) / results[n].sample_count);
+
+		console_printf("%-12s compensation %5lu.%02lu, filter %5lu.%02lu %s/sample\r\n", results[n].name,
+				(unsigned long)(compensation_100 / 100), (unsigned long)(compensation_100 % 100),
+				(unsigned long)(filter_100 / 100), (unsigned long)(filter_100 % 100), SENSOR_CYCLES_UNIT);
+	}
+
+	return true;
+}
+
+
+/******************************************************************************
+ * @brief cycles per sample line, sensor_format against sprintf()
+*/
+static bool console_commands_fmtbench(uint8_t argc, char *argv[])
+{
+	sensor_format_benchmark_result_struct results[SENSOR_FORMAT_BENCHMARK_COUNT];
+
+	(void)argc;
+	(void)argv;
+
+	sensor_format_benchmark_run(results);
+
+	for (uint8_t n = 0; n < SENSOR_FORMAT_BENCHMARK_COUNT; n++)
+	{
+		uint32_t ticks_per_line_100 = (uint32_t)(((uint64_t)results[n].total_ticks * 100) / results[n].line_count);
+
+		console_printf("%-14s %6lu.%02lu %s/line, %lu characters, %lu mismatches\r\n", results[n].name,
+				(unsigned long)(ticks_per_line_100 / 100), (unsigned long)(ticks_per_line_100 % 100), SENSOR_CYCLES_UNIT,
+				(unsigned long)results[n].character_count, (unsigned long)results[n].mismatch_count);
+	}
+
+	return true;
+}
+
+
+/******************************************************************************
+ * @brief cycles per sample of the BMP280 compensation variants, with "exact"
+ * 		  their error against the 64 bit reference instead (takes seconds)
+*/
+static bool console_commands_compbench(uint8_t argc, char *argv[])
+{
+	bool result = (argc == 1) || (argc == 2 && strcasecmp(argv[1], "exact") == 0);
+
+	if (result == true && argc == 2)
+	{
+		bmp280_benchmark_exactness_struct exactness[BMP280_BENCHMARK_COUNT];
+
+		bmp280_benchmark_check_exactness(exactness, BMP280_BENCHMARK_PRESSURE_STEP);
+		for (uint8_t n = 0; n < BMP280_BENCHMARK_COUNT; n++)
+		{
+			console_printf("%-16s %lu samples, %lu mismatches, max error %lu/100 degC, %lu/256 Pa\r\n", exactness[n].name,
+					(unsigned long)exactness[n].sample_count, (unsigned long)exactness[n].mismatch_count,
+					(unsigned long)exactness[n].max_temperature_error_100, (unsigned long)exactness[n].max_pressure_error_256);
+		}
+	}
+	else if (result == true)
+	{
+		bmp280_benchmark_result_struct results[BMP280_BENCHMARK_COUNT];
+
+		bmp280_benchmark_run(results);
+		for (uint8_t n = 0; n < BMP280_BENCHMARK_COUNT; n++)
+		{
+			uint32_t ticks_per_sample_100 = (uint32_t)(((uint64_t)results[n].total_ticks * 100) / results[n].sample_count);
+
+			console_printf("%-16s %6lu.%02lu %s/sample\r\n", results[n].name,
+					(unsigned long)(ticks_per_sample_100 / 100), (unsigned long)(ticks_per_sample_100 % 100), SENSOR_CYCLES_UNIT);
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief record sensor register traffic, "dump" prints the trace as hex
+ * 		  lines for Tools/i2c_replay, without argument print the state
+*/
+static bool console_commands_record(uint8_t argc, char *argv[])
+{
+	bool result = (argc <= 2);
+	sensor_record_stats_struct stats;
+
+	if (result == true && argc == 2 && strcasecmp(argv[1], "start") == 0)
+	{
+		sensor_record_start();
+	}
+	else if (result == true && argc == 2 && strcasecmp(argv[1], "stop") == 0)
+	{
+		sensor_record_stop();
+	}
+	else if (result == true && argc == 2 && strcasecmp(argv[1], "dump") == 0)
+	{
+		uint32_t length;
+		const uint8_t *buffer = sensor_record_get_buffer(&length);
+		char line[4 + 32 * 2 + 1];
+		sensor_format_struct format;
+
+		// 32 bytes per line, the same on every dump so logs diff cleanly
+		for (uint32_t offset = 0; offset < length; offset += 32)
+		{
+			sensor_format_initialize(&format, line, sizeof(line));
+			sensor_format_text(&format, "rec ");
+			for (uint32_t n = offset; n < length && n < offset + 32; n++)
+			{
+				sensor_format_hex(&format, buffer[n], 2);
+			}
+			console_printf("%s\r\n", line);
+		}
+		console_printf("rec end %lu\r\n", (unsigned long)length);
+	}
+	else if (result == true && argc == 2)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		sensor_record_get_stats(&stats);
+		console_printf("record %s, %lu transactions, %lu/%lu bytes, %lu us, %lu dropped\r\n", (stats.is_recording == true) ? "on" : "off",
+				(unsigned long)stats.transaction_count, (unsigned long)stats.length, (unsigned long)SENSOR_RECORD_BUFFER_SIZE,
+				(unsigned long)stats.duration_us, (unsigned long)stats.dropped_count);
+	}
+
+	return result;
+}
+
+
+static bool console_commands_find_sensor(const char *name, uint8_t *index)
+{
+	bool result = sensor_registry_find(name, index);
+
+	if (result == false)
+	{
+		console_printf("unknown sensor '%s'\r\n", name);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief apply start/stop to one sensor or to all of them with "all"
+ * 
+ * @param[out] false only for an unknown sensor name
+*/
+static bool console_commands_run_control(const char *name, bool (*control)(uint8_t index))
+{
+	bool result = true;
+
+	if (strcasecmp(name, "all") == 0)
+	{
+		for (uint8_t n = 0; n < sensor_registry_get_count(); n++)
+		{
+			console_printf("%s: %s\r\n", sensor_registry_get_driver(n)->name, (control(n) == true) ? "ok" : "failed");
+		}
+	}
+	else
+	{
+		uint8_t index = 0;
+
+		if (console_commands_find_sensor(name, &index) == true)
+		{
+			console_printf("%s: %s\r\n", sensor_registry_get_driver(index)->name, (control(index) == true) ? "ok" : "failed");
+		}
+		else
+		{
+			result = false;
+		}
+	}
+
+	return result;
+}
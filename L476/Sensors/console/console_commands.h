@@ -0,0 +1,16 @@
+/*
+ * console_commands.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef CONSOLE_CONSOLE_COMMANDS_H_
+#define CONSOLE_CONSOLE_COMMANDS_H_
+
+#include <stdbool.h>
+
+// firmware command table on the USART2 console, see console_commands.c
+bool console_commands_initialize();
+
+#endif /* CONSOLE_CONSOLE_COMMANDS_H_ */
@@ -0,0 +1,401 @@
+/*
+ * console_uart.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <stdlib.h>
+
+#include "usart.h"
+
+#include "console_uart.h"
+
+#include "../common/sensor_cycles.h"
+#include "../common/sensor_memory.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void console_uart_write(const char *text, uint16_t length);
+static bool console_uart_configure(uint32_t baud, bool is_half_duplex);
+static bool console_uart_wait_for_sync();
+static void console_uart_drain_sync();
+static void console_uart_run_loopback(console_uart_test_struct *result);
+static uint8_t console_uart_test_pattern(uint16_t index);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static uint8_t console_uart_rx_byte;
+static uint8_t console_uart_oversampling = 16;
+
+// line rates offered to the host and covered by the self-test
+static const uint32_t console_uart_rates[] = {115200, 230400, 460800, 921600, 1000000, 1500000, 2000000};
+
+#define CONSOLE_UART_RATE_COUNT (sizeof(console_uart_rates) / sizeof(console_uart_rates[0]))
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief start reception on USART2, output shares the blocking TX path
+ * 
+ * @param[out] true if the RX interrupt was armed
+*/
+bool console_uart_initialize(const console_command_struct *commands, uint8_t command_count)
+{
+	console_initialize(commands, command_count, &console_uart_write);
+
+	return HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1) == HAL_OK;
+}
+
+
+/******************************************************************************
+ * @brief switch the line rate with the handshake described in console_uart.h,
+ * 		  falls back to the current rate if the host does not follow
+ * 
+ * @param[out] true if the host confirmed the new rate
+*/
+bool console_uart_set_baud(uint32_t baud)
+{
+	uint32_t old_baud = huart2.Init.BaudRate;
+	uint8_t oversampling;
+	bool result = (baud <= CONSOLE_UART_MAX_BAUD) && (labs(console_uart_get_baud_error_ppm(baud, &oversampling)) <= CONSOLE_UART_MAX_ERROR_PPM);
+
+	if (result == true)
+	{
+		// HAL_UART_Transmit returns after TC, the answer is out before the switch
+		console_printf("baud %lu switch\r\n", (unsigned long)baud);
+		HAL_UART_AbortReceive(&huart2);
+
+		result = console_uart_configure(baud, false) && console_uart_wait_for_sync();
+		if (result == true)
+		{
+			console_printf("baud %lu ok\r\n", (unsigned long)baud);
+			console_uart_drain_sync();
+		}
+		else
+		{
+			console_uart_configure(old_baud, false);
+			console_printf("baud %lu timeout\r\n", (unsigned long)baud);
+		}
+
+		HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief let the USART measure the host rate on the next sync byte (auto baud
+ * 		  rate detection on a 0x55 frame), falls back on timeout or error
+ * 
+ * @param[out] true if a rate was detected and confirmed
+*/
+bool console_uart_auto_baud()
+{
+	uint32_t old_baud = huart2.Init.BaudRate;
+	uint32_t baud = old_baud;
+	uint32_t start_ms;
+	bool result;
+
+	console_printf("baud auto switch\r\n");
+	HAL_UART_AbortReceive(&huart2);
+
+	huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+	huart2.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_AUTOBAUDRATE_INIT;
+	huart2.AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_ENABLE;
+	huart2.AdvancedInit.AutoBaudRateMode = UART_ADVFEATURE_AUTOBAUDRATE_ON0X55FRAME;
+	result = (HAL_UART_Init(&huart2) == HAL_OK);
+
+	start_ms = HAL_GetTick();
+	while (result == true && __HAL_UART_GET_FLAG(&huart2, UART_FLAG_ABRF) == RESET)
+	{
+		result = (HAL_GetTick() - start_ms < CONSOLE_UART_SYNC_TIMEOUT_MS);
+	}
+	if (result == true)
+	{
+		result = (__HAL_UART_GET_FLAG(&huart2, UART_FLAG_ABRE) == RESET) && (huart2.Instance->BRR != 0);
+	}
+	if (result == true)
+	{
+		baud = HAL_RCC_GetPCLK1Freq() / huart2.Instance->BRR;
+		result = (baud <= CONSOLE_UART_MAX_BAUD);
+	}
+
+	// back to a fixed divider, ABREN is cleared by the re-init
+	huart2.AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_DISABLE;
+	console_uart_configure((result == true) ? baud : old_baud, false);
+	huart2.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
+
+	if (result == true)
+	{
+		console_printf("baud %lu ok\r\n", (unsigned long)baud);
+		console_uart_drain_sync();
+	}
+	else
+	{
+		console_printf("baud auto timeout\r\n");
+	}
+
+	HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1);
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief re-derive the divider for the current rate, e.g. after PCLK1 changed
+*/
+bool console_uart_reconfigure()
+{
+	bool result;
+
+	HAL_UART_AbortReceive(&huart2);
+	result = console_uart_configure(huart2.Init.BaudRate, false);
+	HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1);
+
+	return result;
+}
+
+
+uint32_t console_uart_get_baud()
+{
+	return huart2.Init.BaudRate;
+}
+
+
+uint8_t console_uart_get_oversampling()
+{
+	return console_uart_oversampling;
+}
+
+
+/******************************************************************************
+ * @brief divider error for `baud` at the current PCLK1. Oversampling by 16 is
+ * 		  preferred (more noise margin), by 8 when the rate needs it or 16
+ * 		  cannot hit the rate closely enough.
+ * 
+ * @param[out] error in ppm, INT32_MAX if the rate is out of reach
+*/
+int32_t console_uart_get_baud_error_ppm(uint32_t baud, uint8_t *oversampling)
+{
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+	int32_t error_ppm = INT32_MAX;
+
+	*oversampling = 0;
+
+	for (uint8_t factor = 1; factor <= 2 && baud != 0; factor++)
+	{
+		// USARTDIV = factor * pclk / baud, factor 1 = OVER16, factor 2 = OVER8
+		uint32_t divider = (uint32_t)((((uint64_t)pclk * factor) + (baud / 2)) / baud);
+
+		if (divider >= 16 && divider <= 0xFFFF)
+		{
+			uint32_t actual = (uint32_t)(((uint64_t)pclk * factor) / divider);
+			int32_t error = (int32_t)((((int64_t)actual - (int64_t)baud) * 1000000) / (int64_t)baud);
+
+			if (*oversampling == 0 || (labs(error_ppm) > CONSOLE_UART_MAX_ERROR_PPM && labs(error) < labs(error_ppm)))
+			{
+				error_ppm = error;
+				*oversampling = (factor == 1) ? 16 : 8;
+			}
+		}
+	}
+
+	return error_ppm;
+}
+
+
+/******************************************************************************
+ * @brief loopback throughput test at every rate the current clock supports.
+ * 		  USART2 runs in half-duplex mode for the test, the receiver then sees
+ * 		  the TX pin internally, no jumper needed. The ST-LINK sees the test
+ * 		  traffic as noise at the console rate.
+ * 
+ * @param[out] number of rates tested
+*/
+uint8_t console_uart_self_test(console_uart_test_struct *results, uint8_t max_count)
+{
+	uint32_t baud = huart2.Init.BaudRate;
+	uint8_t count = 0;
+
+	sensor_cycles_initialize();
+	HAL_UART_AbortReceive(&huart2);
+
+	for (uint8_t n = 0; n < CONSOLE_UART_RATE_COUNT && count < max_count; n++)
+	{
+		console_uart_test_struct *result = &results[count];
+
+		*result = (console_uart_test_struct){0};
+		result->baud = console_uart_rates[n];
+
+		if (console_uart_configure(console_uart_rates[n], true) == true)
+		{
+			result->oversampling = console_uart_oversampling;
+			console_uart_run_loopback(result);
+			count++;
+		}
+	}
+
+	console_uart_configure(baud, false);
+	HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1);
+
+	return count;
+}
+
+
+//=============================================================================
+//	HAL callbacks
+//=============================================================================
+
+SENSOR_RAM_FUNCTION void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if (huart == &huart2)
+	{
+		console_receive_byte(console_uart_rx_byte);
+		HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1);
+	}
+}
+
+
+// overrun/framing errors abort the reception, re-arm
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	if (huart == &huart2)
+	{
+		HAL_UART_Receive_IT(&huart2, &console_uart_rx_byte, 1);
+	}
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static void console_uart_write(const char *text, uint16_t length)
+{
+	HAL_UART_Transmit(&huart2, (uint8_t *)text, length, HAL_MAX_DELAY);
+}
+
+
+/******************************************************************************
+ * @brief apply `baud` with the oversampling chosen by
+ * 		  console_uart_get_baud_error_ppm(), reception must be stopped
+*/
+static bool console_uart_configure(uint32_t baud, bool is_half_duplex)
+{
+	uint8_t oversampling;
+	bool result = (labs(console_uart_get_baud_error_ppm(baud, &oversampling)) <= CONSOLE_UART_MAX_ERROR_PPM);
+
+	if (result == true)
+	{
+		huart2.Init.BaudRate = baud;
+		huart2.Init.OverSampling = (oversampling == 8) ? UART_OVERSAMPLING_8 : UART_OVERSAMPLING_16;
+
+		result = (((is_half_duplex == true) ? HAL_HalfDuplex_Init(&huart2) : HAL_UART_Init(&huart2)) == HAL_OK);
+	}
+	if (result == true)
+	{
+		console_uart_oversampling = oversampling;
+	}
+
+	return result;
+}
+
+
+// bytes garbled by the switch itself are ignored
+static bool console_uart_wait_for_sync()
+{
+	uint32_t start_ms = HAL_GetTick();
+	uint8_t byte = 0;
+	bool result = false;
+
+	__HAL_UART_CLEAR_FLAG(&huart2, UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF);
+
+	while (result == false && HAL_GetTick() - start_ms < CONSOLE_UART_SYNC_TIMEOUT_MS)
+	{
+		result = (HAL_UART_Receive(&huart2, &byte, 1, CONSOLE_UART_SYNC_INTERVAL_MS) == HAL_OK) && (byte == CONSOLE_UART_SYNC_BYTE);
+	}
+
+	return result;
+}
+
+
+// the host repeats the sync byte until it reads the answer, keep the
+// leftovers out of the command line
+static void console_uart_drain_sync()
+{
+	uint32_t start_ms = HAL_GetTick();
+	uint8_t byte;
+
+	while (HAL_UART_Receive(&huart2, &byte, 1, CONSOLE_UART_SYNC_INTERVAL_MS * 2) == HAL_OK && HAL_GetTick() - start_ms < CONSOLE_UART_SYNC_TIMEOUT_MS)
+	{
+	}
+	__HAL_UART_CLEAR_FLAG(&huart2, UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF);
+}
+
+
+/******************************************************************************
+ * @brief stream CONSOLE_UART_TEST_LENGTH bytes through the half-duplex
+ * 		  loopback by register access. TX is kept at most two bytes ahead of
+ * 		  RX (TDR + shift register) so the line stays busy without the
+ * 		  polling loop itself causing overruns.
+*/
+static void console_uart_run_loopback(console_uart_test_struct *result)
+{
+	USART_TypeDef *usart = huart2.Instance;
+	uint32_t timeout_ms = (uint32_t)(((uint64_t)CONSOLE_UART_TEST_LENGTH * 10 * 1000 * 2) / result->baud) + 10;
+	uint32_t start_ms = HAL_GetTick();
+	uint32_t start = sensor_cycles_now();
+	uint32_t cycles;
+	uint16_t sent = 0;
+	uint16_t received = 0;
+
+	__HAL_UART_CLEAR_FLAG(&huart2, UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF);
+
+	while (received < CONSOLE_UART_TEST_LENGTH && HAL_GetTick() - start_ms < timeout_ms)
+	{
+		uint32_t isr = usart->ISR;
+
+		if ((isr & USART_ISR_RXNE) != 0)
+		{
+			if ((uint8_t)usart->RDR != console_uart_test_pattern(received))
+			{
+				result->mismatch_count++;
+			}
+			received++;
+		}
+		if ((isr & USART_ISR_ORE) != 0)
+		{
+			result->overrun_count++;
+			usart->ICR = USART_ICR_ORECF;
+		}
+		if ((isr & (USART_ISR_FE | USART_ISR_NE)) != 0)
+		{
+			result->framing_count++;
+			usart->ICR = USART_ICR_FECF | USART_ICR_NCF;
+		}
+		if ((isr & USART_ISR_TXE) != 0 && sent < CONSOLE_UART_TEST_LENGTH && (uint16_t)(sent - received) < 2)
+		{
+			usart->TDR = console_uart_test_pattern(sent++);
+		}
+	}
+
+	cycles = sensor_cycles_now() - start;
+	result->received_count = received;
+	result->bytes_per_s = (cycles == 0) ? 0 : (uint32_t)(((uint64_t)received * SystemCoreClock) / cycles);
+}
+
+
+// position dependent, a dropped byte shows up as mismatches
+static uint8_t console_uart_test_pattern(uint16_t index)
+{
+	return (uint8_t)((index * 167u) ^ (index >> 8));
+}
@@ -0,0 +1,58 @@
+/*
+ * console_uart.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef CONSOLE_CONSOLE_UART_H_
+#define CONSOLE_CONSOLE_UART_H_
+
+#include "console.h"
+
+//=============================================================================
+//	USART2 console link
+//=============================================================================
+// Console on USART2 (ST-LINK virtual COM port), RX interrupt per byte.
+//
+// line rate switch, both ends agree before the old rate is dropped:
+//   host:   "baud <rate>"              (or "baud auto")
+//   target: "baud <rate> switch"       at the old rate, then changes rate
+//   host:   changes rate, sends CONSOLE_UART_SYNC_BYTE until answered
+//   target: "baud <rate> ok"           at the new rate
+// Without a sync byte within CONSOLE_UART_SYNC_TIMEOUT_MS the target falls
+// back to the old rate. For "auto" the sync byte is measured by the USART
+// auto baud rate detection instead of matched against a preset.
+// Tools/uart_link implements the host side.
+
+#define CONSOLE_UART_DEFAULT_BAUD		115200
+#define CONSOLE_UART_MAX_BAUD			2000000
+#define CONSOLE_UART_MAX_ERROR_PPM		10000	// divider error, the receiver tolerates ~3 % in total
+#define CONSOLE_UART_SYNC_BYTE			0x55	// 'U', also the auto baud rate reference frame
+#define CONSOLE_UART_SYNC_TIMEOUT_MS	1000
+#define CONSOLE_UART_SYNC_INTERVAL_MS	20		// host repeats the sync byte at this interval
+#define CONSOLE_UART_TEST_LENGTH		2048	// bytes per loopback run
+
+typedef struct
+{
+	uint32_t baud;
+	uint8_t oversampling;		// 8 or 16
+	uint32_t bytes_per_s;		// sustained, ~baud / 10 at best
+	uint16_t received_count;
+	uint16_t mismatch_count;
+	uint16_t overrun_count;
+	uint16_t framing_count;		// framing and noise errors
+}console_uart_test_struct;
+
+bool console_uart_initialize(const console_command_struct *commands, uint8_t command_count);
+
+bool console_uart_set_baud(uint32_t baud);
+bool console_uart_auto_baud();
+bool console_uart_reconfigure();
+uint32_t console_uart_get_baud();
+uint8_t console_uart_get_oversampling();
+int32_t console_uart_get_baud_error_ppm(uint32_t baud, uint8_t *oversampling);
+
+uint8_t console_uart_self_test(console_uart_test_struct *results, uint8_t max_count);
+
+#endif /* CONSOLE_CONSOLE_UART_H_ */
@@ -0,0 +1,404 @@
+/*
+ * filter.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "filter_dsp.h"
+
+#include "filter.h"
+
+#include "../common/sensor_memory.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static int32_t filter_stage_median_process(void *filter, int32_t sample);
+static int32_t filter_stage_iir_q31_process(void *filter, int32_t sample);
+static int32_t filter_stage_iir_q15_process(void *filter, int32_t sample);
+static int32_t filter_stage_moving_average_process(void *filter, int32_t sample);
+static int32_t filter_stage_outlier_process(void *filter, int32_t sample);
+
+
+//=============================================================================
+//	median
+//=============================================================================
+
+/******************************************************************************
+ * @brief initialize median filter
+ * 
+ * @param[in] filter
+ * @param[in] length window length, 1 - FILTER_MEDIAN_MAX_LENGTH (odd recommended)
+ * 
+ * @param[out] true if length is valid
+*/
+bool filter_median_initialize(filter_median_struct *filter, uint8_t length)
+{
+	bool result = true;
+
+	if (length == 0 || length > FILTER_MEDIAN_MAX_LENGTH)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		filter->length = length;
+		filter->count = 0;
+		filter->index = 0;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief add sample and return the median of the window
+ * 		  The sorted copy is updated incrementally: O(length) per sample.
+ * 		  Until the window is full the median of the samples so far is returned.
+*/
+SENSOR_RAM_FUNCTION int32_t filter_median_process(filter_median_struct *filter, int32_t sample)
+{
+	uint8_t position;
+
+	// window full => remove the oldest sample from the sorted copy
+	if (filter->count == filter->length)
+	{
+		int32_t oldest = filter->history[filter->index];
+
+		for (position = 0; position < filter->count - 1 && filter->sorted[position] != oldest; position++)
+		{
+		}
+		for (; position < filter->count - 1; position++)
+		{
+			filter->sorted[position] = filter->sorted[position + 1];
+		}
+		filter->count--;
+	}
+
+	// insert new sample, shifting larger values up
+	for (position = filter->count; position > 0 && filter->sorted[position - 1] > sample; position--)
+	{
+		filter->sorted[position] = filter->sorted[position - 1];
+	}
+	filter->sorted[position] = sample;
+	filter->count++;
+
+	filter->history[filter->index] = sample;
+	filter->index = (uint8_t)((filter->index + 1) % filter->length);
+
+	return filter->sorted[filter->count / 2];
+}
+
+
+//=============================================================================
+//	exponential IIR
+//=============================================================================
+
+/******************************************************************************
+ * @brief initialize 32-bit exponential IIR
+ * 
+ * @param[in] filter
+ * @param[in] alpha_q15 smoothing factor in Q15, 1 (heavy) - 32767 (none)
+ * 
+ * @param[out] true if alpha is valid
+*/
+bool filter_iir_q31_initialize(filter_iir_q31_struct *filter, int16_t alpha_q15)
+{
+	bool result = true;
+
+	if (alpha_q15 <= 0)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		filter->alpha_q15 = alpha_q15;
+		filter->state = 0;
+		filter->is_initialized = false;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief y += alpha * (x - y), first sample initializes the state
+*/
+SENSOR_RAM_FUNCTION int32_t filter_iir_q31_process(filter_iir_q31_struct *filter, int32_t sample)
+{
+	if (filter->is_initialized == false)
+	{
+		filter->state = sample;
+		filter->is_initialized = true;
+	}
+	else
+	{
+		int32_t error = filter_dsp_qsub(sample, filter->state);
+		filter->state = filter_dsp_qadd(filter->state, filter_dsp_mul_q31_q15(error, filter->alpha_q15));
+	}
+
+	return filter->state;
+}
+
+
+/******************************************************************************
+ * @brief initialize 16-bit exponential IIR
+ * 
+ * @param[in] filter
+ * @param[in] alpha_q15 smoothing factor in Q15, 1 (heavy) - 32767 (none)
+ * 
+ * @param[out] true if alpha is valid
+*/
+bool filter_iir_q15_initialize(filter_iir_q15_struct *filter, int16_t alpha_q15)
+{
+	bool result = true;
+
+	if (alpha_q15 <= 0)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		// 1 - alpha = 32768 - alpha, fits int16_t because alpha >= 1
+		filter->coefficients_q15 = filter_dsp_pack_q15(alpha_q15, (int16_t)(32768 - alpha_q15));
+		filter->state = 0;
+		filter->is_initialized = false;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief y = alpha * x + (1 - alpha) * y as a single dual multiply-accumulate
+ * 		  Only 16 bits of state are kept: small alphas stop tracking changes
+ * 		  smaller than 1/alpha LSB. Use the Q31 variant for heavy smoothing.
+*/
+SENSOR_RAM_FUNCTION int16_t filter_iir_q15_process(filter_iir_q15_struct *filter, int16_t sample)
+{
+	if (filter->is_initialized == false)
+	{
+		filter->state = sample;
+		filter->is_initialized = true;
+	}
+	else
+	{
+		int32_t accumulator = filter_dsp_smlad(filter_dsp_pack_q15(sample, filter->state), filter->coefficients_q15, 1 << 14);
+		filter->state = (int16_t)(accumulator >> 15);
+	}
+
+	return filter->state;
+}
+
+
+//=============================================================================
+//	moving average
+//=============================================================================
+
+/******************************************************************************
+ * @brief initialize moving average
+ * 
+ * @param[in] filter
+ * @param[in] length window length, power of two 1 - FILTER_MOVING_AVERAGE_MAX_LENGTH
+ * 
+ * @param[out] true if length is valid
+*/
+bool filter_moving_average_initialize(filter_moving_average_struct *filter, uint8_t length)
+{
+	bool result = true;
+
+	if (length == 0 || length > FILTER_MOVING_AVERAGE_MAX_LENGTH || (length & (length - 1)) != 0)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		filter->length = length;
+		filter->shift = 0;
+		while ((1u << filter->shift) < length)
+		{
+			filter->shift++;
+		}
+		filter->count = 0;
+		filter->index = 0;
+		filter->sum = 0;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief add sample to the running sum and return the window average
+ * 		  The first sample fills the window, so the average is always the sum
+ * 		  shifted by log2(length), no division. Rounds towards minus infinity.
+*/
+SENSOR_RAM_FUNCTION int32_t filter_moving_average_process(filter_moving_average_struct *filter, int32_t sample)
+{
+	if (filter->count == 0)
+	{
+		for (uint8_t n = 0; n < filter->length; n++)
+		{
+			filter->history[n] = sample;
+		}
+		filter->sum = (int64_t)sample * filter->length;
+		filter->count = filter->length;
+	}
+
+	filter->sum += (int64_t)sample - filter->history[filter->index];
+	filter->history[filter->index] = sample;
+	filter->index = (uint8_t)((filter->index + 1) & (filter->length - 1));
+
+	return (int32_t)(filter->sum >> filter->shift);
+}
+
+
+//=============================================================================
+//	outlier rejection
+//=============================================================================
+
+/******************************************************************************
+ * @brief initialize outlier rejection
+ * 
+ * @param[in] filter
+ * @param[in] max_deviation  largest accepted step between samples
+ * @param[in] max_rejections consecutive rejections after which the new level is accepted
+ * 
+ * @param[out] true if parameters are valid
+*/
+bool filter_outlier_initialize(filter_outlier_struct *filter, int32_t max_deviation, uint8_t max_rejections)
+{
+	bool result = true;
+
+	if (max_deviation <= 0)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		filter->max_deviation = max_deviation;
+		filter->max_rejections = max_rejections;
+		filter->rejection_count = 0;
+		filter->total_rejections = 0;
+		filter->reference = 0;
+		filter->is_initialized = false;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief return sample, or the last accepted sample if it is an outlier
+*/
+SENSOR_RAM_FUNCTION int32_t filter_outlier_process(filter_outlier_struct *filter, int32_t sample)
+{
+	int32_t deviation = filter_dsp_qsub(sample, filter->reference);
+
+	if (filter->is_initialized == false)
+	{
+		filter->is_initialized = true;
+		filter->reference = sample;
+	}
+	else if ((deviation > filter->max_deviation || deviation < -filter->max_deviation) && filter->rejection_count < filter->max_rejections)
+	{
+		filter->rejection_count++;
+		filter->total_rejections++;
+	}
+	else
+	{
+		filter->rejection_count = 0;
+		filter->reference = sample;
+	}
+
+	return filter->reference;
+}
+
+
+//=============================================================================
+//	pipeline
+//=============================================================================
+
+filter_stage_struct filter_stage_median(filter_median_struct *filter)
+{
+	return (filter_stage_struct){.process = &filter_stage_median_process, .filter = filter};
+}
+
+filter_stage_struct filter_stage_iir_q31(filter_iir_q31_struct *filter)
+{
+	return (filter_stage_struct){.process = &filter_stage_iir_q31_process, .filter = filter};
+}
+
+filter_stage_struct filter_stage_iir_q15(filter_iir_q15_struct *filter)
+{
+	return (filter_stage_struct){.process = &filter_stage_iir_q15_process, .filter = filter};
+}
+
+filter_stage_struct filter_stage_moving_average(filter_moving_average_struct *filter)
+{
+	return (filter_stage_struct){.process = &filter_stage_moving_average_process, .filter = filter};
+}
+
+filter_stage_struct filter_stage_outlier(filter_outlier_struct *filter)
+{
+	return (filter_stage_struct){.process = &filter_stage_outlier_process, .filter = filter};
+}
+
+
+/******************************************************************************
+ * @brief run a sample through all stages in order
+ * 
+ * @param[in] stages      e.g. {filter_stage_outlier(&o), filter_stage_median(&m), filter_stage_iir_q31(&i)}
+ * @param[in] stage_count
+ * @param[in] sample
+ * 
+ * @param[out] output of the last stage
+*/
+SENSOR_RAM_FUNCTION int32_t filter_pipeline_process(const filter_stage_struct *stages, uint8_t stage_count, int32_t sample)
+{
+	for (uint8_t n = 0; n < stage_count; n++)
+	{
+		sample = stages[n].process(stages[n].filter, sample);
+	}
+
+	return sample;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+SENSOR_RAM_FUNCTION static int32_t filter_stage_median_process(void *filter, int32_t sample)
+{
+	return filter_median_process((filter_median_struct *)filter, sample);
+}
+
+SENSOR_RAM_FUNCTION static int32_t filter_stage_iir_q31_process(void *filter, int32_t sample)
+{
+	return filter_iir_q31_process((filter_iir_q31_struct *)filter, sample);
+}
+
+SENSOR_RAM_FUNCTION static int32_t filter_stage_iir_q15_process(void *filter, int32_t sample)
+{
+	// saturate to the 16-bit range of the stage
+	int16_t sample_q15 = (sample > INT16_MAX) ? INT16_MAX : (sample < INT16_MIN) ? INT16_MIN : (int16_t)sample;
+	return filter_iir_q15_process((filter_iir_q15_struct *)filter, sample_q15);
+}
+
+SENSOR_RAM_FUNCTION static int32_t filter_stage_moving_average_process(void *filter, int32_t sample)
+{
+	return filter_moving_average_process((filter_moving_average_struct *)filter, sample);
+}
+
+SENSOR_RAM_FUNCTION static int32_t filter_stage_outlier_process(void *filter, int32_t sample)
+{
+	return filter_outlier_process((filter_outlier_struct *)filter, sample);
+}
@@ -0,0 +1,115 @@
+/*
+ * filter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef FILTER_FILTER_H_
+#define FILTER_FILTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	limits
+//=============================================================================
+// all state lives in the filter structs, nothing is allocated at runtime
+
+#define FILTER_MEDIAN_MAX_LENGTH         (15)
+#define FILTER_MOVING_AVERAGE_MAX_LENGTH (64)
+
+//=============================================================================
+//	filter stages
+//=============================================================================
+// Samples are int32_t in whatever fixed-point unit the stream uses (mm, Q31, ...).
+
+// median of the last `length` samples, removes spikes without smearing edges
+typedef struct
+{
+	int32_t history[FILTER_MEDIAN_MAX_LENGTH];   // arrival order (ring buffer)
+	int32_t sorted[FILTER_MEDIAN_MAX_LENGTH];    // same samples, ascending
+	uint8_t length;
+	uint8_t count;
+	uint8_t index;
+}filter_median_struct;
+
+// exponential IIR on 32-bit samples: y += alpha * (x - y), saturating
+typedef struct
+{
+	int32_t state;
+	int16_t alpha_q15;
+	bool is_initialized;
+}filter_iir_q31_struct;
+
+// exponential IIR on 16-bit samples: y = alpha * x + (1 - alpha) * y, one SMLAD per sample
+typedef struct
+{
+	int16_t state;
+	uint32_t coefficients_q15;                   // packed {alpha, 1 - alpha}
+	bool is_initialized;
+}filter_iir_q15_struct;
+
+// moving average with running sum: O(1) per sample regardless of length,
+// the length is a power of two so the average is a shift
+typedef struct
+{
+	int32_t history[FILTER_MOVING_AVERAGE_MAX_LENGTH];
+	int64_t sum;
+	uint8_t length;
+	uint8_t shift;		// log2(length)
+	uint8_t count;
+	uint8_t index;
+}filter_moving_average_struct;
+
+// replaces samples further than `max_deviation` from the last accepted sample by
+// that sample. After `max_rejections` consecutive rejections the new level is
+// accepted, so real steps pass through with a short delay.
+typedef struct
+{
+	int32_t reference;
+	int32_t max_deviation;
+	uint8_t max_rejections;
+	uint8_t rejection_count;
+	uint32_t total_rejections;
+	bool is_initialized;
+}filter_outlier_struct;
+
+//=============================================================================
+//	pipeline
+//=============================================================================
+typedef int32_t (filter_stage_function)(void *filter, int32_t sample);
+
+typedef struct
+{
+	filter_stage_function *process;
+	void *filter;
+}filter_stage_struct;
+
+//=============================================================================
+//	functions
+//=============================================================================
+bool filter_median_initialize(filter_median_struct *filter, uint8_t length);
+int32_t filter_median_process(filter_median_struct *filter, int32_t sample);
+
+bool filter_iir_q31_initialize(filter_iir_q31_struct *filter, int16_t alpha_q15);
+int32_t filter_iir_q31_process(filter_iir_q31_struct *filter, int32_t sample);
+
+bool filter_iir_q15_initialize(filter_iir_q15_struct *filter, int16_t alpha_q15);
+int16_t filter_iir_q15_process(filter_iir_q15_struct *filter, int16_t sample);
+
+bool filter_moving_average_initialize(filter_moving_average_struct *filter, uint8_t length);
+int32_t filter_moving_average_process(filter_moving_average_struct *filter, int32_t sample);
+
+bool filter_outlier_initialize(filter_outlier_struct *filter, int32_t max_deviation, uint8_t max_rejections);
+int32_t filter_outlier_process(filter_outlier_struct *filter, int32_t sample);
+
+filter_stage_struct filter_stage_median(filter_median_struct *filter);
+filter_stage_struct filter_stage_iir_q31(filter_iir_q31_struct *filter);
+filter_stage_struct filter_stage_iir_q15(filter_iir_q15_struct *filter);
+filter_stage_struct filter_stage_moving_average(filter_moving_average_struct *filter);
+filter_stage_struct filter_stage_outlier(filter_outlier_struct *filter);
+
+int32_t filter_pipeline_process(const filter_stage_struct *stages, uint8_t stage_count, int32_t sample);
+
+#endif /* FILTER_FILTER_H_ */
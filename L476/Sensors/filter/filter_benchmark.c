@@ -0,0 +1,120 @@
+/*
+ * filter_benchmark.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "../common/sensor_cycles.h"
+#include "../common/sensor_memory.h"
+
+#include "filter_benchmark.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void filter_benchmark_generate_input(int32_t *samples, uint32_t sample_count);
+static void filter_benchmark_stage(filter_benchmark_result_struct *result, const char *name, const filter_stage_struct *stages, uint8_t stage_count, const int32_t *samples);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static int32_t filter_benchmark_input[FILTER_BENCHMARK_SAMPLE_COUNT] SENSOR_SRAM2_DATA;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief time every filter stage on the same synthetic range stream
+ * 		  (ramp + noise + occasional spikes, in mm)
+ * 
+ * @param[out] results one entry per filter_benchmark_stage_enum
+*/
+void filter_benchmark_run(filter_benchmark_result_struct results[FILTER_BENCHMARK_STAGE_COUNT])
+{
+	filter_median_struct median_5;
+	filter_median_struct median_15;
+	filter_iir_q31_struct iir_q31;
+	filter_iir_q15_struct iir_q15;
+	filter_moving_average_struct moving_average;
+	filter_outlier_struct outlier;
+
+	sensor_cycles_initialize();
+	filter_benchmark_generate_input(filter_benchmark_input, FILTER_BENCHMARK_SAMPLE_COUNT);
+
+	filter_median_initialize(&median_5, 5);
+	filter_median_initialize(&median_15, 15);
+	filter_iir_q31_initialize(&iir_q31, 8192);
+	filter_iir_q15_initialize(&iir_q15, 8192);
+	filter_moving_average_initialize(&moving_average, 32);
+	filter_outlier_initialize(&outlier, 20, 3);
+
+	const filter_stage_struct median_5_stage = filter_stage_median(&median_5);
+	const filter_stage_struct median_15_stage = filter_stage_median(&median_15);
+	const filter_stage_struct iir_q31_stage = filter_stage_iir_q31(&iir_q31);
+	const filter_stage_struct iir_q15_stage = filter_stage_iir_q15(&iir_q15);
+	const filter_stage_struct moving_average_stage = filter_stage_moving_average(&moving_average);
+	const filter_stage_struct outlier_stage = filter_stage_outlier(&outlier);
+
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_MEDIAN_5], "median5", &median_5_stage, 1, filter_benchmark_input);
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_MEDIAN_15], "median15", &median_15_stage, 1, filter_benchmark_input);
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_IIR_Q31], "iir_q31", &iir_q31_stage, 1, filter_benchmark_input);
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_IIR_Q15], "iir_q15", &iir_q15_stage, 1, filter_benchmark_input);
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_MOVING_AVERAGE_32], "moving_average32", &moving_average_stage, 1, filter_benchmark_input);
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_OUTLIER], "outlier", &outlier_stage, 1, filter_benchmark_input);
+
+	// typical range stream: outlier rejection -> median -> IIR
+	filter_median_initialize(&median_5, 5);
+	filter_iir_q31_initialize(&iir_q31, 8192);
+	filter_outlier_initialize(&outlier, 20, 3);
+	const filter_stage_struct pipeline[] = {outlier_stage, median_5_stage, iir_q31_stage};
+	filter_benchmark_stage(&results[FILTER_BENCHMARK_STAGE_PIPELINE], "pipeline", pipeline, sizeof(pipeline) / sizeof(pipeline[0]), filter_benchmark_input);
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief deterministic test stream, identical on host and target
+*/
+static void filter_benchmark_generate_input(int32_t *samples, uint32_t sample_count)
+{
+	uint32_t random = 12345;
+
+	for (uint32_t n = 0; n < sample_count; n++)
+	{
+		// linear congruential generator (Numerical Recipes constants)
+		random = random * 1664525 + 1013904223;
+
+		int32_t noise = (int32_t)((random >> 24) & 0x0F) - 8;
+		int32_t spike = ((random >> 16) & 0x3F) == 0 ? 120 : 0;
+
+		samples[n] = 50 + (int32_t)(n / 8) + noise + spike;
+	}
+}
+
+
+/******************************************************************************
+ * @brief run `stages` over all samples and record elapsed ticks
+*/
+static void filter_benchmark_stage(filter_benchmark_result_struct *result, const char *name, const filter_stage_struct *stages, uint8_t stage_count, const int32_t *samples)
+{
+	int32_t checksum = 0;
+	uint32_t start = sensor_cycles_now();
+
+	for (uint32_t n = 0; n < FILTER_BENCHMARK_SAMPLE_COUNT; n++)
+	{
+		checksum += filter_pipeline_process(stages, stage_count, samples[n]);
+	}
+
+	result->total_ticks = sensor_cycles_now() - start;
+	result->name = name;
+	result->sample_count = FILTER_BENCHMARK_SAMPLE_COUNT;
+	result->checksum = checksum;
+}
@@ -0,0 +1,39 @@
+/*
+ * filter_benchmark.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef FILTER_FILTER_BENCHMARK_H_
+#define FILTER_FILTER_BENCHMARK_H_
+
+#include <stdint.h>
+
+#include "filter.h"
+
+#define FILTER_BENCHMARK_SAMPLE_COUNT (1024)
+
+typedef enum
+{
+	FILTER_BENCHMARK_STAGE_MEDIAN_5,
+	FILTER_BENCHMARK_STAGE_MEDIAN_15,
+	FILTER_BENCHMARK_STAGE_IIR_Q31,
+	FILTER_BENCHMARK_STAGE_IIR_Q15,
+	FILTER_BENCHMARK_STAGE_MOVING_AVERAGE_32,
+	FILTER_BENCHMARK_STAGE_OUTLIER,
+	FILTER_BENCHMARK_STAGE_PIPELINE,
+	FILTER_BENCHMARK_STAGE_COUNT,
+}filter_benchmark_stage_enum;
+
+typedef struct
+{
+	const char *name;
+	uint32_t total_ticks;                        // SENSOR_CYCLES_UNIT
+	uint32_t sample_count;
+	int32_t checksum;                            // keeps the work observable
+}filter_benchmark_result_struct;
+
+void filter_benchmark_run(filter_benchmark_result_struct results[FILTER_BENCHMARK_STAGE_COUNT]);
+
+#endif /* FILTER_FILTER_BENCHMARK_H_ */
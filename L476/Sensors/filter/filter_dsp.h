@@ -0,0 +1,85 @@
+/*
+ * filter_dsp.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef FILTER_FILTER_DSP_H_
+#define FILTER_FILTER_DSP_H_
+
+#include <stdint.h>
+
+//=============================================================================
+//	saturating fixed-point primitives
+//=============================================================================
+// Cortex-M4: single-cycle DSP instructions (QADD, QSUB, SMLAD) via CMSIS
+// host:      plain C with the same saturation behaviour
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+#include "cmsis_compiler.h"
+
+static inline int32_t filter_dsp_qadd(int32_t a, int32_t b)
+{
+	return __QADD(a, b);
+}
+
+static inline int32_t filter_dsp_qsub(int32_t a, int32_t b)
+{
+	return __QSUB(a, b);
+}
+
+// a[15:0]*b[15:0] + a[31:16]*b[31:16] + accumulator
+static inline int32_t filter_dsp_smlad(uint32_t a, uint32_t b, int32_t accumulator)
+{
+	return (int32_t)__SMLAD(a, b, (uint32_t)accumulator);
+}
+
+#else
+
+static inline int32_t filter_dsp_saturate_q31(int64_t value)
+{
+	if (value > INT32_MAX)
+	{
+		value = INT32_MAX;
+	}
+	else if (value < INT32_MIN)
+	{
+		value = INT32_MIN;
+	}
+	return (int32_t)value;
+}
+
+static inline int32_t filter_dsp_qadd(int32_t a, int32_t b)
+{
+	return filter_dsp_saturate_q31((int64_t)a + b);
+}
+
+static inline int32_t filter_dsp_qsub(int32_t a, int32_t b)
+{
+	return filter_dsp_saturate_q31((int64_t)a - b);
+}
+
+static inline int32_t filter_dsp_smlad(uint32_t a, uint32_t b, int32_t accumulator)
+{
+	int32_t low = (int32_t)(int16_t)(a & 0xFFFF) * (int32_t)(int16_t)(b & 0xFFFF);
+	int32_t high = (int32_t)(int16_t)(a >> 16) * (int32_t)(int16_t)(b >> 16);
+	return (int32_t)((uint32_t)accumulator + (uint32_t)low + (uint32_t)high);
+}
+
+#endif
+
+// pack two Q15 values into one word for filter_dsp_smlad
+static inline uint32_t filter_dsp_pack_q15(int16_t low, int16_t high)
+{
+	return ((uint32_t)(uint16_t)high << 16) | (uint32_t)(uint16_t)low;
+}
+
+// Q31 x Q15 => Q31
+static inline int32_t filter_dsp_mul_q31_q15(int32_t a, int16_t b)
+{
+	return (int32_t)(((int64_t)a * b) >> 15);
+}
+
+#endif /* FILTER_FILTER_DSP_H_ */
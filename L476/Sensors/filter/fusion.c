@@ -0,0 +1,306 @@
+/*
+ * fusion.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include "fusion.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+
+// Kalman gain is kept in Q40, K * v then rounds to about 1 um^2 at the
+// largest variance
+#define FUSION_GAIN_FRACTIONAL_BITS (40)
+
+// initial uncertainty before the first measurement, also the upper bound of
+// every variance: (1 m)^2
+#define FUSION_MAX_VARIANCE_UM2 (1000000000000LL)
+
+// lower bound of the innovation variance S: (2 um)^2, far below any sensor
+// noise. With Cauchy-Schwarz |P H'|_i <= sqrt(P_ii * S), so
+// |K_i| <= sqrt(FUSION_MAX_VARIANCE_UM2 / S) <= 500000 (< 2^19, Q40 < 2^59).
+#define FUSION_MIN_INNOVATION_VARIANCE_UM2 (4)
+
+// 1/d for d in [0.5, 1): linear seed 48/17 - 32/17 d (error <= 1/17), three
+// Newton steps in 32 bit (error < 2^-29) and a last one in 64 bit (< 2^-58).
+// Q30 constants.
+#define FUSION_RECIPROCAL_SEED_OFFSET_Q30 (3031741621UL)	// 48/17
+#define FUSION_RECIPROCAL_SEED_SLOPE_Q30  (2021161081UL)	// 32/17
+#define FUSION_RECIPROCAL_NEWTON_STEPS    (3)
+
+// confidence of a fully trusted ToF sample (see VL6180X_RANGE_CONFIDENCE_MAX)
+#define FUSION_CONFIDENCE_MAX (255)
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void fusion_update(fusion_struct *fusion, int32_t measurement_um, int64_t h0, int64_t h1, uint64_t measurement_noise_um2);
+static int64_t fusion_reciprocal(uint64_t value, uint8_t *shift);
+static int64_t fusion_multiply_shift(int64_t a, int64_t b, uint8_t shift);
+static int32_t fusion_saturate(int64_t value);
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief initialize filter
+ * 
+ * @param[in] fusion
+ * @param[in] height_process_noise_um2_per_ms how fast the height may change
+ * @param[in] offset_process_noise_um2_per_ms how fast barometer drift/surface altitude may change
+ * @param[in] distance_noise_um2              ToF variance (e.g. (2 mm)^2 = 4000000)
+ * @param[in] altitude_noise_um2              barometer variance (e.g. (150 mm)^2)
+*/
+void fusion_initialize(fusion_struct *fusion, uint32_t height_process_noise_um2_per_ms, uint32_t offset_process_noise_um2_per_ms, uint64_t distance_noise_um2, uint64_t altitude_noise_um2)
+{
+	fusion->x[0] = 0;
+	fusion->x[1] = 0;
+
+	fusion->P[0][0] = FUSION_MAX_VARIANCE_UM2;
+	fusion->P[0][1] = 0;
+	fusion->P[1][0] = 0;
+	fusion->P[1][1] = FUSION_MAX_VARIANCE_UM2;
+
+	fusion->height_process_noise_um2_per_ms = height_process_noise_um2_per_ms;
+	fusion->offset_process_noise_um2_per_ms = offset_process_noise_um2_per_ms;
+	fusion->distance_noise_um2 = distance_noise_um2;
+	fusion->altitude_noise_um2 = altitude_noise_um2;
+
+	fusion->is_initialized = true;
+}
+
+
+/******************************************************************************
+ * @brief time update: both states are random walks, only the covariance grows
+ * 
+ * @param[in] fusion
+ * @param[in] elapsed_ms time since the previous predict
+*/
+void fusion_predict(fusion_struct *fusion, uint32_t elapsed_ms)
+{
+	fusion->P[0][0] += (int64_t)fusion->height_process_noise_um2_per_ms * elapsed_ms;
+	fusion->P[1][1] += (int64_t)fusion->offset_process_noise_um2_per_ms * elapsed_ms;
+
+	if (fusion->P[0][0] > FUSION_MAX_VARIANCE_UM2)
+	{
+		fusion->P[0][0] = FUSION_MAX_VARIANCE_UM2;
+	}
+	if (fusion->P[1][1] > FUSION_MAX_VARIANCE_UM2)
+	{
+		fusion->P[1][1] = FUSION_MAX_VARIANCE_UM2;
+	}
+}
+
+
+/******************************************************************************
+ * @brief measurement update with a ToF distance
+ * 
+ * @param[in] fusion
+ * @param[in] distance_um height above surface
+ * @param[in] confidence  1 - 255, measurement variance is scaled by 255/confidence.
+ * 						  0 skips the update (invalid sample).
+*/
+void fusion_update_distance(fusion_struct *fusion, int32_t distance_um, uint8_t confidence)
+{
+	if (confidence != 0)
+	{
+		uint8_t shift;
+		int64_t reciprocal = fusion_reciprocal(confidence, &shift);
+		uint64_t measurement_noise_um2 = (uint64_t)fusion_multiply_shift((int64_t)(fusion->distance_noise_um2 * FUSION_CONFIDENCE_MAX), reciprocal, shift);
+
+		fusion_update(fusion, distance_um, 1, 0, measurement_noise_um2);
+	}
+}
+
+
+/******************************************************************************
+ * @brief measurement update with a barometric altitude delta
+ * 
+ * @param[in] fusion
+ * @param[in] altitude_um altitude relative to the barometer reference
+*/
+void fusion_update_altitude(fusion_struct *fusion, int32_t altitude_um)
+{
+	fusion_update(fusion, altitude_um, 1, 1, fusion->altitude_noise_um2);
+}
+
+
+/******************************************************************************
+ * @brief current height estimate and its variance
+*/
+fusion_estimate_struct fusion_get_estimate(const fusion_struct *fusion)
+{
+	fusion_estimate_struct estimate =
+	{
+		.height_um = fusion->x[0],
+		.variance_um2 = (fusion->P[0][0] > 0) ? (uint64_t)fusion->P[0][0] : 0,
+	};
+
+	return estimate;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief generic scalar measurement update for H = [h0 h1]
+ * 
+ * 		  S = H P H' + R
+ * 		  K = P H' / S             (Q40, S by its reciprocal)
+ * 		  x = x + K (z - H x)
+ * 		  P = P - K (H P)          (symmetric form)
+ * 
+ * 		  K (H P) equals (P H')(P H')' / S, so every product is bounded by
+ * 		  sqrt(P_ii P_jj) <= FUSION_MAX_VARIANCE_UM2 even when |K| > 1.
+*/
+static void fusion_update(fusion_struct *fusion, int32_t measurement_um, int64_t h0, int64_t h1, uint64_t measurement_noise_um2)
+{
+	int64_t (*P)[FUSION_STATE_COUNT] = fusion->P;
+	uint8_t shift;
+
+	// P H'
+	int64_t v0 = P[0][0] * h0 + P[0][1] * h1;
+	int64_t v1 = P[1][0] * h0 + P[1][1] * h1;
+
+	// innovation and its variance
+	int64_t S = v0 * h0 + v1 * h1 + (int64_t)measurement_noise_um2;
+	int64_t innovation = (int64_t)measurement_um - (fusion->x[0] * h0 + fusion->x[1] * h1);
+
+	if (S < FUSION_MIN_INNOVATION_VARIANCE_UM2)
+	{
+		S = FUSION_MIN_INNOVATION_VARIANCE_UM2;
+	}
+
+	// 1/S = reciprocal * 2^-shift, shift >= 64 for S >= 4
+	int64_t reciprocal = fusion_reciprocal((uint64_t)S, &shift);
+	int64_t K0 = fusion_multiply_shift(v0, reciprocal, shift - FUSION_GAIN_FRACTIONAL_BITS);
+	int64_t K1 = fusion_multiply_shift(v1, reciprocal, shift - FUSION_GAIN_FRACTIONAL_BITS);
+
+	fusion->x[0] = fusion_saturate(fusion->x[0] + fusion_multiply_shift(K0, innovation, FUSION_GAIN_FRACTIONAL_BITS));
+	fusion->x[1] = fusion_saturate(fusion->x[1] + fusion_multiply_shift(K1, innovation, FUSION_GAIN_FRACTIONAL_BITS));
+
+	int64_t P00 = P[0][0] - fusion_multiply_shift(K0, v0, FUSION_GAIN_FRACTIONAL_BITS);
+	int64_t P01 = P[0][1] - fusion_multiply_shift(K0, v1, FUSION_GAIN_FRACTIONAL_BITS);
+	int64_t P10 = P[1][0] - fusion_multiply_shift(K1, v0, FUSION_GAIN_FRACTIONAL_BITS);
+	int64_t P11 = P[1][1] - fusion_multiply_shift(K1, v1, FUSION_GAIN_FRACTIONAL_BITS);
+
+	P[0][0] = P00;
+	P[1][1] = P11;
+	P[0][1] = (P01 + P10) / 2;
+	P[1][0] = P[0][1];
+}
+
+
+/******************************************************************************
+ * @brief reciprocal without a division: 1/value ~= result * 2^-shift
+ * 		  The value is normalized to d in [0.5, 1) with CLZ, 1/d is found by
+ * 		  a fixed number of Newton steps (multiplies only), so the run time
+ * 		  does not depend on the value. Relative error < 2^-58.
+ * 
+ * @param[in]  value  >= 1
+ * @param[out] shift  62 - 125
+ * @param[out] 1/d in Q61, 2^61 - 2^62
+*/
+static int64_t fusion_reciprocal(uint64_t value, uint8_t *shift)
+{
+	uint8_t n = (uint8_t)__builtin_clzll(value);
+	int64_t d_q63 = (int64_t)((value << n) >> 1);
+	uint32_t d = (uint32_t)(d_q63 >> 31);
+
+	// d as a Q32 fraction, x ~= 1/d in Q30
+	uint32_t x = FUSION_RECIPROCAL_SEED_OFFSET_Q30 - (uint32_t)(((uint64_t)FUSION_RECIPROCAL_SEED_SLOPE_Q30 * d) >> 32);
+
+	for (uint8_t step = 0; step < FUSION_RECIPROCAL_NEWTON_STEPS; step++)
+	{
+		// x = x (2 - d x)
+		uint32_t dx = (uint32_t)(((uint64_t)d * x) >> 32);
+		x = (uint32_t)(((uint64_t)x * ((1UL << 31) - dx)) >> 30);
+	}
+
+	// last step on the full 64 bit value, Q61
+	int64_t x_q61 = (int64_t)x << 31;
+	int64_t dx_q61 = fusion_multiply_shift(d_q63, x_q61, 63);
+	x_q61 = fusion_multiply_shift(x_q61, ((int64_t)1 << 62) - dx_q61, 61);
+
+	// value = d * 2^(64 - n), 1/value = (x_q61 / 2^61) * 2^(n - 64)
+	*shift = (uint8_t)(125 - n);
+
+	return x_q61;
+}
+
+
+/******************************************************************************
+ * @brief (a * b) >> shift with a 128 bit intermediate, rounded to nearest
+ * 		  (exact quotients stay exact with the reciprocal slightly low).
+ * 		  Four 32x32 multiplies; the result must fit in int64.
+ * 
+ * @param[in] shift 0 - 127
+*/
+static int64_t fusion_multiply_shift(int64_t a, int64_t b, uint8_t shift)
+{
+	bool is_negative = (a < 0) != (b < 0);
+	uint64_t ua = (a < 0) ? (uint64_t)0 - (uint64_t)a : (uint64_t)a;
+	uint64_t ub = (b < 0) ? (uint64_t)0 - (uint64_t)b : (uint64_t)b;
+
+	uint64_t ll = (ua & 0xFFFFFFFFUL) * (ub & 0xFFFFFFFFUL);
+	uint64_t lh = (ua & 0xFFFFFFFFUL) * (ub >> 32);
+	uint64_t hl = (ua >> 32) * (ub & 0xFFFFFFFFUL);
+	uint64_t hh = (ua >> 32) * (ub >> 32);
+
+	uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFFUL) + (hl & 0xFFFFFFFFUL);
+	uint64_t low = (middle << 32) | (ll & 0xFFFFFFFFUL);
+	uint64_t high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+	uint64_t result;
+
+	// half of the last kept bit
+	if (shift > 64)
+	{
+		high += (uint64_t)1 << (shift - 65);
+	}
+	else if (shift > 0)
+	{
+		uint64_t half = (uint64_t)1 << (shift - 1);
+
+		low += half;
+		high += (low < half) ? 1 : 0;
+	}
+
+	if (shift == 0)
+	{
+		result = low;
+	}
+	else if (shift < 64)
+	{
+		result = (high << (64 - shift)) | (low >> shift);
+	}
+	else
+	{
+		result = high >> (shift - 64);
+	}
+
+	return (is_negative == true) ? -(int64_t)result : (int64_t)result;
+}
+
+
+// limits a state update to the int32 range instead of wrapping
+static int32_t fusion_saturate(int64_t value)
+{
+	if (value > INT32_MAX)
+	{
+		value = INT32_MAX;
+	}
+	else if (value < INT32_MIN)
+	{
+		value = INT32_MIN;
+	}
+
+	return (int32_t)value;
+}
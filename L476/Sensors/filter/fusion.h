@@ -0,0 +1,60 @@
+/*
+ * fusion.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef FILTER_FUSION_H_
+#define FILTER_FUSION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+//	barometer + time-of-flight height fusion
+//=============================================================================
+// Two-state Kalman filter, all integer math:
+//   x[0] = height above surface (um)
+//   x[1] = barometer offset     (um): surface altitude + barometer drift
+//
+//   ToF measures       z = x[0]         (precise, short range only)
+//   barometer measures z = x[0] + x[1]  (coarse, always available)
+//
+// While the ToF is valid the offset is learned, so when the target leaves the
+// ToF range the barometer keeps tracking height without a jump. The run time
+// of every call does not depend on the data: no data-dependent iteration
+// counts and no 64 bit division (__aeabi_ldivmod runs longer for some
+// operands), the gain uses a reciprocal from a fixed number of Newton steps.
+// The only branches are clamps of a few instructions.
+
+#define FUSION_STATE_COUNT (2)
+
+typedef struct
+{
+	int32_t x[FUSION_STATE_COUNT];                      // um
+	int64_t P[FUSION_STATE_COUNT][FUSION_STATE_COUNT];  // um^2
+
+	uint32_t height_process_noise_um2_per_ms;
+	uint32_t offset_process_noise_um2_per_ms;
+	uint64_t distance_noise_um2;                        // ToF measurement variance at full confidence
+	uint64_t altitude_noise_um2;                        // barometer measurement variance
+
+	bool is_initialized;
+}fusion_struct;
+
+typedef struct
+{
+	int32_t height_um;
+	uint64_t variance_um2;
+}fusion_estimate_struct;
+
+void fusion_initialize(fusion_struct *fusion, uint32_t height_process_noise_um2_per_ms, uint32_t offset_process_noise_um2_per_ms, uint64_t distance_noise_um2, uint64_t altitude_noise_um2);
+
+void fusion_predict(fusion_struct *fusion, uint32_t elapsed_ms);
+void fusion_update_distance(fusion_struct *fusion, int32_t distance_um, uint8_t confidence);
+void fusion_update_altitude(fusion_struct *fusion, int32_t altitude_um);
+
+fusion_estimate_struct fusion_get_estimate(const fusion_struct *fusion);
+
+#endif /* FILTER_FUSION_H_ */
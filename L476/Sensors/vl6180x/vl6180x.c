@@ -5,6 +5,8 @@
  *      Author: Aniel
  */
 
+#include "../common/sensor_endian.h"
+
 #include "vl6180x.h"
 
 
@@ -16,6 +18,18 @@ vl6180x_register_operation *vl6180x_read_registers;
 vl6180x_register_operation *vl6180x_write_registers;
 vl6180x_sleep_function     *vl6180x_sleep_ms;
 
+//=============================================================================
+//	types
+//=============================================================================
+
+// ranging profiles: settings that jointly decide ranging rate and noise
+typedef struct
+{
+	uint8_t readout_averaging_period;  // READOUT_AVERAGING_SAMPLE_PERIOD
+	uint8_t max_convergence_time_ms;   // SYSRANGE_MAX_CONVERGENCE_TIME
+	uint8_t intermeasurement_period;   // SYSRANGE_INTERMEASUREMENT_PERIOD
+}vl6180x_ranging_profile_struct;
+
 //=============================================================================
 //	internal functions
 //=============================================================================
@@ -27,10 +41,48 @@ static bool vl6180x_is_device_ready();
 
 static bool vl6180x_load_SR03_settings();
 static bool vl6180x_load_recommended_configuration();
+static bool vl6180x_read_scaling_calibration();
+static bool vl6180x_arm_range_interrupt(vl6180x_int_config_range_enum source, uint8_t threshold_low, uint8_t threshold_high);
+static uint8_t vl6180x_convert_mm_to_raw_range(uint16_t distance_mm);
+static bool vl6180x_update_early_convergence_estimate(const vl6180x_ranging_profile_struct *settings);
 
 static bool vl6180x_retrieve_measurement(uint8_t *distance_mm, uint8_t *error_flag);
 static bool vl6180x_clear_data_ready_interrupt();
 
+static bool vl6180x_is_interrupt_pending(uint8_t mask, uint8_t value, uint8_t *error_flag);
+static bool vl6180x_wait_for_interrupt(bool (*is_ready)(uint8_t *error_flag), uint32_t poll_rate_ms);
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// ranging profiles
+static const vl6180x_ranging_profile_struct vl6180x_ranging_profiles[VL6180X_RANGING_PROFILE_COUNT] =
+{
+	// 3.2 + 5 + 1.3 ms = 9.5 ms per range => fits a 10 ms period
+	[VL6180X_RANGING_PROFILE_HIGH_SPEED]    = {.readout_averaging_period = 0x00, .max_convergence_time_ms = 5,  .intermeasurement_period = 0x00},
+	// 3.2 + 10 + 2.3 ms = 15.5 ms per range => 20 ms period
+	[VL6180X_RANGING_PROFILE_BALANCED]      = {.readout_averaging_period = 0x10, .max_convergence_time_ms = 10, .intermeasurement_period = 0x01},
+	// 3.2 + 49 + 4.4 ms = 56.6 ms per range => 100 ms period (AN4545 defaults)
+	[VL6180X_RANGING_PROFILE_HIGH_ACCURACY] = {.readout_averaging_period = 0x30, .max_convergence_time_ms = 49, .intermeasurement_period = 0x09},
+};
+
+// ALS configuration as programmed by vl6180x_load_recommended_configuration()
+static vl6180x_als_gain_enum vl6180x_als_gain = VL6180X_ALS_GAIN_1;
+static uint16_t vl6180x_als_integration_period_ms = 100;
+
+// range scaling, 1x calibration values are read once after initialization
+static vl6180x_range_scaling_enum vl6180x_range_scaling = VL6180X_RANGE_SCALING_1X;
+static int8_t vl6180x_part_to_part_offset_1x;
+static uint8_t vl6180x_crosstalk_valid_height_1x;
+
+// threshold interrupts, window limits are kept in mm so they survive a scaling change
+static bool vl6180x_threshold_enabled = false;
+static vl6180x_threshold_mode_enum vl6180x_threshold_mode;
+static vl6180x_int_config_range_enum vl6180x_threshold_armed_source = VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_NEW_SAMPLE_READY;
+static uint16_t vl6180x_threshold_low_mm;
+static uint16_t vl6180x_threshold_high_mm;
+
 /******************************************************************************
  * @brief Initializes global variables and checks sensor ID
  * 
@@ -78,23 +130,906 @@ bool  vl6180x_initialize(vl6180x_register_operation *vl6180x_read, vl6180x_regis
 		result = vl6180x_load_recommended_configuration();
 	}
 
-	if (result == true)
-	{
-		result = vl6180x_clear_startup_flag();
-	}
+	if (result == true)
+	{
+		result = vl6180x_read_scaling_calibration();
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_clear_startup_flag();
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Start single measurement
+ * 
+ * @pre device Initialized
+ * 
+ * @param[out] true if single measurement started
+*/
+bool vl6180x_request_single_measurement()
+{
+	bool result = true;
+
+	result = vl6180x_is_device_ready();
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_START, &(uint8_t){VL6180X_REGISTER_SYSRANGE_START_VALUE_SINGLE_SHOT}, 1);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Start continuous measurement
+ * 
+ * @pre device initialized
+ * 
+ * @param[out] true if continuous mode started
+*/
+bool vl6180x_start_continuous_measurements()
+{
+	bool result = true;
+
+	result = vl6180x_is_device_ready();
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_START, &(uint8_t){VL6180X_REGISTER_SYSRANGE_START_VALUE_TOGGLE_CONTINUOUS_MODE}, 1);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Stop continuous measurements
+ * 
+ * @pre continuous mode started
+ * 
+ * @param[out] true if continuous mode stopped
+*/
+bool vl6180x_stop_continous_measurements()
+{
+	bool result = true;
+
+	result = vl6180x_is_device_ready();
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_START, &(uint8_t){VL6180X_REGISTER_SYSRANGE_START_VALUE_STOP_CONTINUOUS_MODE}, 1);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Check if new data is available
+ * 
+ * @pre Single or Continuos measurement started
+ * 
+ * @param[out] error_flag with non-zero value if any error occred while aquiring measurement result
+ * @param[out] true if check was OK and data available
+*/
+bool vl6180x_is_measurement_ready(uint8_t *error_flag)
+{
+	return vl6180x_is_interrupt_pending(VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_RANGE, (uint8_t)VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_RANGE_NEW_SAMPLE_READY, error_flag);
+}
+
+
+/******************************************************************************
+ * @brief Check if a new ALS sample is available
+ * 
+ * @pre Single, continuous or interleaved ALS measurement started
+ * 
+ * @param[out] error_flag with non-zero value if any error occred while aquiring measurement result
+ * @param[out] true if check was OK and data available
+*/
+bool vl6180x_is_als_measurement_ready(uint8_t *error_flag)
+{
+	return vl6180x_is_interrupt_pending(VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_ALS, (uint8_t)VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_NEW_SAMPLE_READY, error_flag);
+}
+
+
+/******************************************************************************
+ * @brief blocking function to check for new data
+ * 
+ * @param[out] true if new data available
+*/
+bool vl6180x_wait_for_new_measurement(uint32_t poll_rate_ms)
+{
+	return vl6180x_wait_for_interrupt(&vl6180x_is_measurement_ready, poll_rate_ms);
+}
+
+
+/******************************************************************************
+ * @brief blocking function to wait until the device accepts configuration
+ * 		  changes and start commands again (e.g. after stopping continuous mode)
+ * 
+ * @param[out] true if device ready, false on bus error
+*/
+bool vl6180x_wait_for_device_ready(uint32_t poll_rate_ms)
+{
+	bool result = false;
+	uint8_t data;
+
+	while(true)
+	{
+		result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_RANGE_STATUS, &data, 1);
+
+		// break on bus error or device ready
+		if (result == false || (data & VL6180X_REGISTER_RESULT_RANGE_STATUS_MASK_DEVICE_READY) == VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_DEVICE_READY_TRUE)
+		{
+			break;
+		}
+
+		// otherwise sleep
+		vl6180x_sleep_ms(poll_rate_ms);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief blocking function to check for new ALS data
+ * 
+ * @param[out] true if new data available
+*/
+bool vl6180x_wait_for_new_als_measurement(uint32_t poll_rate_ms)
+{
+	return vl6180x_wait_for_interrupt(&vl6180x_is_als_measurement_ready, poll_rate_ms);
+}
+
+/******************************************************************************
+ * @brief Get results of single measurement
+ * 
+ * @pre measurement ready
+ * 
+ * @param[out] distance in mm
+ * @param[out] true if succeeded
+*/
+bool vl6180x_get_measurement_result(uint8_t *distance_mm, uint8_t *error_flag)
+{
+	bool result = true;
+	
+	result = vl6180x_retrieve_measurement(distance_mm, error_flag);
+
+	if (result == true)
+	{
+		result = vl6180x_clear_data_ready_interrupt();
+	}
+	return result;
+}
+
+
+//=============================================================================
+//	range quality
+//=============================================================================
+
+/******************************************************************************
+ * @brief Get results of single measurement including signal quality.
+ * 		  RESULT_RANGE_VAL up to RESULT_RANGE_REFERENCE_CONV_TIME is read in
+ * 		  one burst, RESULT_RANGE_STATUS separately.
+ * 
+ * @pre measurement ready
+ * 
+ * @param[out] range_quality scaled range, decoded error, rates, counts and convergence times
+ * @param[out] true if the bus transfers succeeded and the range is valid
+*/
+bool vl6180x_get_range_quality_result(vl6180x_range_quality_struct *range_quality)
+{
+	bool result = true;
+	uint8_t status;
+	uint8_t data[VL6180X_QUALITY_BURST_LENGTH];
+
+	result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_RANGE_STATUS, &status, 1);
+
+	if (result == true)
+	{
+		result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_RANGE_VAL, data, VL6180X_QUALITY_BURST_LENGTH);
+	}
+
+	// clear even on a range error, otherwise continuous mode stalls on the pending interrupt
+	if (result == true)
+	{
+		result = vl6180x_clear_data_ready_interrupt();
+	}
+
+	if (result == true)
+	{
+		range_quality->range.raw_range = data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_VAL)];
+		range_quality->range.scaling = vl6180x_range_scaling;
+		range_quality->range.distance_mm = (uint16_t)range_quality->range.raw_range * (uint16_t)vl6180x_range_scaling;
+		range_quality->range.error_code = status & VL6180X_REGISTER_RESULT_RANGE_STATUS_MASK_ERROR_CODE;
+
+		range_quality->return_rate_mcps_128 = sensor_endian_get_u16_be(&data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_RETURN_RATE)]);
+		range_quality->reference_rate_mcps_128 = sensor_endian_get_u16_be(&data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_REFERENCE_RATE)]);
+		range_quality->return_signal_count = sensor_endian_get_u32_be(&data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_RETURN_SIGNAL_COUNT)]);
+		range_quality->return_ambient_count = sensor_endian_get_u32_be(&data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_RETURN_AMB_COUNT)]);
+		range_quality->return_convergence_time_us = sensor_endian_get_u32_be(&data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_RETURN_CONV_TIME)]);
+		range_quality->reference_convergence_time_us = sensor_endian_get_u32_be(&data[VL6180X_QUALITY_BURST_OFFSET(VL6180X_REGISTER_RESULT_RANGE_REFERENCE_CONV_TIME)]);
+
+		range_quality->error = vl6180x_decode_range_error(range_quality->range.error_code);
+
+		// confidence: share of the return signal that is not ambient light
+		if (range_quality->error != VL6180X_RANGE_ERROR_NONE || range_quality->return_signal_count == 0)
+		{
+			range_quality->confidence = 0;
+		}
+		else
+		{
+			uint64_t total_count = (uint64_t)range_quality->return_signal_count + range_quality->return_ambient_count;
+			range_quality->confidence = (uint8_t)(((uint64_t)range_quality->return_signal_count * VL6180X_RANGE_CONFIDENCE_MAX) / total_count);
+		}
+
+		if (range_quality->error != VL6180X_RANGE_ERROR_NONE)
+		{
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Map a RESULT_RANGE_STATUS error code to its category
+ * 
+ * @param[in] error_code RESULT_RANGE_STATUS & MASK_ERROR_CODE
+ * 
+ * @param[out] error category
+*/
+vl6180x_range_error_enum vl6180x_decode_range_error(uint8_t error_code)
+{
+	vl6180x_range_error_enum error;
+
+	switch ((vl6180x_result_range_error_code_enum)error_code)
+	{
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR:
+			error = VL6180X_RANGE_ERROR_NONE;
+			break;
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_EARLY_CONVERGENCE_ESTIMATE:
+			error = VL6180X_RANGE_ERROR_EARLY_CONVERGENCE;
+			break;
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_MAX_CONVERGENCE:
+			error = VL6180X_RANGE_ERROR_NO_CONVERGENCE;
+			break;
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_TARGET_IGNORE:
+			error = VL6180X_RANGE_ERROR_RANGE_IGNORE;
+			break;
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Max_SNR:
+			error = VL6180X_RANGE_ERROR_SNR;
+			break;
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Underflow:
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Underflow:
+			error = VL6180X_RANGE_ERROR_UNDERFLOW;
+			break;
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Overflow:
+		case VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Overflow:
+			error = VL6180X_RANGE_ERROR_OVERFLOW;
+			break;
+		default:
+			// VCSEL continuity/watchdog, PLL lock and reserved codes
+			error = VL6180X_RANGE_ERROR_SYSTEM;
+			break;
+	}
+
+	return error;
+}
+
+
+/******************************************************************************
+ * @brief Short name of an error category, for logging
+*/
+const char *vl6180x_get_range_error_name(vl6180x_range_error_enum error)
+{
+	static const char *names[] =
+	{
+		[VL6180X_RANGE_ERROR_NONE]              = "none",
+		[VL6180X_RANGE_ERROR_SYSTEM]            = "system",
+		[VL6180X_RANGE_ERROR_EARLY_CONVERGENCE] = "ece",
+		[VL6180X_RANGE_ERROR_NO_CONVERGENCE]    = "no convergence",
+		[VL6180X_RANGE_ERROR_RANGE_IGNORE]      = "range ignore",
+		[VL6180X_RANGE_ERROR_SNR]               = "snr",
+		[VL6180X_RANGE_ERROR_UNDERFLOW]         = "underflow",
+		[VL6180X_RANGE_ERROR_OVERFLOW]          = "overflow",
+	};
+
+	return ((unsigned)error < sizeof(names) / sizeof(names[0])) ? names[error] : "unknown";
+}
+
+
+/******************************************************************************
+ * @brief Set SYSRANGE_MAX_CONVERGENCE_TIME, the upper limit for a range
+ * 		  measurement before it is reported as "no convergence"
+ * 
+ * @param[in] max_convergence_time_ms 1 - 63 ms
+ * 
+ * @param[out] true if written
+*/
+bool vl6180x_set_max_convergence_time(uint8_t max_convergence_time_ms)
+{
+	bool result = true;
+
+	if (max_convergence_time_ms == 0 || max_convergence_time_ms > VL6180X_MAX_CONVERGENCE_TIME_MAX_MS)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_MAX_CONVERGENCE_TIME, &max_convergence_time_ms, 1);
+	}
+
+	return result;
+}
+
+
+//=============================================================================
+//	ranging profiles
+//=============================================================================
+
+/******************************************************************************
+ * @brief Apply a ranging profile. Averaging period, max convergence time,
+ * 		  early convergence estimate and inter-measurement period are set
+ * 		  together so the range execution time always fits the period.
+ * 
+ * @pre device initialized, no measurement running
+ * 
+ * @param[in] profile
+ * 
+ * @param[out] true if all registers were written
+*/
+bool vl6180x_set_ranging_profile(vl6180x_ranging_profile_enum profile)
+{
+	bool result = true;
+	const vl6180x_ranging_profile_struct *settings = NULL;
+
+	if (profile >= VL6180X_RANGING_PROFILE_COUNT)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		settings = &vl6180x_ranging_profiles[profile];
+		result = vl6180x_is_device_ready();
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_READOUT_AVERAGING_SAMPLE_PERIOD, &(uint8_t){settings->readout_averaging_period}, 1);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_set_max_convergence_time(settings->max_convergence_time_ms);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_update_early_convergence_estimate(settings);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_INTERMEASUREMENT_PERIOD, &(uint8_t){settings->intermeasurement_period}, 1);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Worst case duration of one range measurement for a profile
+ * 
+ * @param[out] time in us, 0 for an invalid profile
+*/
+uint32_t vl6180x_get_range_execution_time_us(vl6180x_ranging_profile_enum profile)
+{
+	uint32_t execution_time_us = 0;
+
+	if (profile < VL6180X_RANGING_PROFILE_COUNT)
+	{
+		const vl6180x_ranging_profile_struct *settings = &vl6180x_ranging_profiles[profile];
+
+		execution_time_us = VL6180X_RANGE_PRE_CALIBRATION_TIME_US
+						  + (uint32_t)settings->max_convergence_time_ms * 1000
+						  + VL6180X_READOUT_AVERAGING_BASE_TIME_US
+						  + ((uint32_t)settings->readout_averaging_period * VL6180X_READOUT_AVERAGING_STEP_TIME_NS) / 1000;
+	}
+
+	return execution_time_us;
+}
+
+
+/******************************************************************************
+ * @brief Continuous mode sample period of a profile
+ * 
+ * @param[out] period in ms, 0 for an invalid profile
+*/
+uint32_t vl6180x_get_intermeasurement_period_ms(vl6180x_ranging_profile_enum profile)
+{
+	uint32_t period_ms = 0;
+
+	if (profile < VL6180X_RANGING_PROFILE_COUNT)
+	{
+		period_ms = ((uint32_t)vl6180x_ranging_profiles[profile].intermeasurement_period + 1) * VL6180X_INTERMEASUREMENT_PERIOD_STEP_MS;
+	}
+
+	return period_ms;
+}
+
+
+//=============================================================================
+//	range scaling
+//=============================================================================
+
+/******************************************************************************
+ * @brief Set range scaling (1x: ~0-200 mm, 2x: ~0-400 mm, 3x: ~0-600 mm)
+ * 		  Follows `set_scaling` from vl6180_pi.c, but derives the scaled
+ * 		  offset and crosstalk height from the cached 1x values so repeated
+ * 		  calls do not compound.
+ * 
+ * @pre device initialized, no measurement running
+ * 
+ * @param[in] scaling
+ * @param[out] true if registers were written
+*/
+bool vl6180x_set_range_scaling(vl6180x_range_scaling_enum scaling)
+{
+	bool result = true;
+	static const uint8_t scaler_table[] = VL6180X_RANGE_SCALER_VALUE_TABLE;
+	uint8_t range_check_enables;
+
+	if (scaling < VL6180X_RANGE_SCALING_1X || scaling > VL6180X_RANGE_SCALING_3X)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_is_device_ready();
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_register_u16(VL6180X_REGISTER_SYSRANGE_RANGE_SCALER, scaler_table[scaling]);
+	}
+
+	if (result == true)
+	{
+		int8_t part_to_part_offset = (int8_t)(vl6180x_part_to_part_offset_1x / (int8_t)scaling);
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_PART_TO_PART_RANGE_OFFSET, (uint8_t *)&part_to_part_offset, 1);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_CROSSTALK_VALID_HEIGHT, &(uint8_t){vl6180x_crosstalk_valid_height_1x / (uint8_t)scaling}, 1);
+	}
+
+	// early convergence estimate is only valid at 1x
+	if (result == true)
+	{
+		result = vl6180x_read_registers(VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES, &range_check_enables, 1);
+	}
+
+	if (result == true)
+	{
+		range_check_enables &= (uint8_t)~VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES_MASK_EARLY_CONVERGENCE;
+		if (scaling == VL6180X_RANGE_SCALING_1X)
+		{
+			range_check_enables |= VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES_MASK_EARLY_CONVERGENCE;
+		}
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES, &range_check_enables, 1);
+	}
+
+	// a result still pending was measured with the previous scaling
+	if (result == true)
+	{
+		vl6180x_range_scaling = scaling;
+		result = vl6180x_clear_data_ready_interrupt();
+	}
+
+	// thresholds are programmed in raw units of the active scaling
+	if (result == true && vl6180x_threshold_enabled == true)
+	{
+		result = vl6180x_set_range_thresholds(vl6180x_threshold_low_mm, vl6180x_threshold_high_mm);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Get active range scaling
+*/
+vl6180x_range_scaling_enum vl6180x_get_range_scaling()
+{
+	return vl6180x_range_scaling;
+}
+
+
+/******************************************************************************
+ * @brief Select the scaling for the next measurements based on a result.
+ * 		  Scales up near the top of the current full scale or on overflow,
+ * 		  scales down well inside the next lower full scale. Does not touch
+ * 		  the device, call vl6180x_set_range_scaling() if the scale changed.
+ * 
+ * @param[in] scaling      scaling the result was measured with
+ * @param[in] range_result latest result
+ * 
+ * @param[out] preferred scaling
+*/
+vl6180x_range_scaling_enum vl6180x_select_range_scaling(vl6180x_range_scaling_enum scaling, const vl6180x_range_result_struct *range_result)
+{
+	vl6180x_range_scaling_enum selected = scaling;
+	uint16_t scale_up_mm = (uint16_t)(VL6180X_RANGE_SCALING_NOMINAL_MAX_MM * VL6180X_AUTO_SCALING_UP_PERCENT / 100) * (uint16_t)scaling;
+	uint16_t scale_down_mm = (uint16_t)(VL6180X_RANGE_SCALING_NOMINAL_MAX_MM * VL6180X_AUTO_SCALING_DOWN_PERCENT / 100) * (uint16_t)(scaling - 1);
+
+	bool is_overflow = range_result->error_code == (uint8_t)VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Overflow
+					|| range_result->error_code == (uint8_t)VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Overflow;
+
+	if ((is_overflow == true || range_result->distance_mm >= scale_up_mm) && scaling < VL6180X_RANGE_SCALING_3X)
+	{
+		selected = (vl6180x_range_scaling_enum)(scaling + 1);
+	}
+	else if (range_result->error_code == 0 && range_result->distance_mm < scale_down_mm && scaling > VL6180X_RANGE_SCALING_1X)
+	{
+		selected = (vl6180x_range_scaling_enum)(scaling - 1);
+	}
+
+	return selected;
+}
+
+
+/******************************************************************************
+ * @brief Get results of single measurement, scaled to mm
+ * 
+ * @pre measurement ready
+ * 
+ * @param[out] range_result distance in mm together with the scaling and error code
+ * @param[out] true if succeeded and the range is valid
+*/
+bool vl6180x_get_range_result(vl6180x_range_result_struct *range_result)
+{
+	bool result = true;
+
+	result = vl6180x_get_range_sample(range_result);
+
+	if (result == true && range_result->error_code != (uint8_t)VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR)
+	{
+		result = false;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Get results of single measurement like vl6180x_get_range_result(),
+ * 		  but a range error is only reported in error_code, e.g. for callers
+ * 		  that treat "no target" as a regular sample
+ * 
+ * @pre measurement ready
+ * 
+ * @param[out] range_result distance in mm together with the scaling and error
+ * 			   code, VL6180X_GENERIC_ERROR if the result could not be read
+ * @param[out] true if all I2C transfers succeeded, including the interrupt clear
+*/
+bool vl6180x_get_range_sample(vl6180x_range_result_struct *range_result)
+{
+	bool result = true;
+	uint8_t data = 0;
+
+	result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_RANGE_VAL, &range_result->raw_range, 1);
+
+	if (result == true)
+	{
+		result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_RANGE_STATUS, &data, 1);
+	}
+
+	range_result->error_code = (result == true) ? (data & VL6180X_REGISTER_RESULT_RANGE_STATUS_MASK_ERROR_CODE) : VL6180X_GENERIC_ERROR;
+	range_result->scaling = vl6180x_range_scaling;
+	range_result->distance_mm = (uint16_t)range_result->raw_range * (uint16_t)vl6180x_range_scaling;
+
+	// clear even on a range error, otherwise continuous mode stalls on the pending interrupt
+	if (vl6180x_clear_data_ready_interrupt() == false)
+	{
+		result = false;
+	}
+
+	return result;
+}
+
+
+//=============================================================================
+//	threshold interrupts
+//=============================================================================
+
+/******************************************************************************
+ * @brief Raise the range interrupt (GPIO1) only on threshold events instead
+ * 		  of on every new sample. Combine with continuous ranging so the MCU
+ * 		  and the bus stay idle until the target crosses a threshold.
+ * 
+ * 		  LEVEL_LOW:     distance < threshold_low_mm
+ * 		  LEVEL_HIGH:    distance > threshold_high_mm
+ * 		  OUT_OF_WINDOW: distance < threshold_low_mm or > threshold_high_mm
+ * 		  IN_WINDOW:     distance enters or leaves [threshold_low_mm, threshold_high_mm]
+ * 
+ * @param[in] mode
+ * @param[in] threshold_low_mm
+ * @param[in] threshold_high_mm
+ * 
+ * @param[out] true if configured
+*/
+bool vl6180x_set_threshold_mode(vl6180x_threshold_mode_enum mode, uint16_t threshold_low_mm, uint16_t threshold_high_mm)
+{
+	bool result = true;
+
+	if (threshold_low_mm > threshold_high_mm)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		vl6180x_threshold_mode = mode;
+		vl6180x_threshold_enabled = true;
+		result = vl6180x_set_range_thresholds(threshold_low_mm, threshold_high_mm);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Update thresholds of the active threshold mode. Thresholds and
+ * 		  interrupt source are written under GROUPED_PARAMETER_HOLD so a
+ * 		  running measurement never sees a half-updated configuration.
+ * 
+ * @pre vl6180x_set_threshold_mode()
+ * 
+ * @param[in] threshold_low_mm
+ * @param[in] threshold_high_mm
+ * 
+ * @param[out] true if configured
+*/
+bool vl6180x_set_range_thresholds(uint16_t threshold_low_mm, uint16_t threshold_high_mm)
+{
+	bool result = true;
+	vl6180x_int_config_range_enum source;
+	uint8_t threshold_low = vl6180x_convert_mm_to_raw_range(threshold_low_mm);
+	uint8_t threshold_high = vl6180x_convert_mm_to_raw_range(threshold_high_mm);
+
+	if (vl6180x_threshold_enabled == false || threshold_low_mm > threshold_high_mm)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		vl6180x_threshold_low_mm = threshold_low_mm;
+		vl6180x_threshold_high_mm = threshold_high_mm;
+
+		switch (vl6180x_threshold_mode)
+		{
+			case VL6180X_THRESHOLD_MODE_LEVEL_LOW:
+				source = VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_LEVEL_LOW;
+				break;
+			case VL6180X_THRESHOLD_MODE_LEVEL_HIGH:
+				source = VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_LEVEL_HIGH;
+				break;
+			default:
+				// IN_WINDOW starts by reporting whichever side the target is on,
+				// vl6180x_get_threshold_event() then re-arms for the next crossing
+				source = VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_OUT_OF_WINDOW;
+				break;
+		}
+
+		result = vl6180x_arm_range_interrupt(source, threshold_low, threshold_high);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Return to a range interrupt on every new sample
+ * 
+ * @param[out] true if configured
+*/
+bool vl6180x_disable_threshold_mode()
+{
+	bool result = true;
+
+	result = vl6180x_arm_range_interrupt(VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_NEW_SAMPLE_READY, 0, 0xFF);
+
+	if (result == true)
+	{
+		vl6180x_threshold_enabled = false;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Check if the armed threshold event occured
+ * 
+ * @param[out] error_flag with non-zero value if any error occred while aquiring measurement result
+ * @param[out] true if check was OK and a threshold event is pending
+*/
+bool vl6180x_is_threshold_event_pending(uint8_t *error_flag)
+{
+	return vl6180x_is_interrupt_pending(VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_RANGE, (uint8_t)vl6180x_threshold_armed_source, error_flag);
+}
+
+
+/******************************************************************************
+ * @brief blocking function to wait for the armed threshold event
+ * 
+ * @param[out] true if event occured
+*/
+bool vl6180x_wait_for_threshold_event(uint32_t poll_rate_ms)
+{
+	return vl6180x_wait_for_interrupt(&vl6180x_is_threshold_event_pending, poll_rate_ms);
+}
+
+
+/******************************************************************************
+ * @brief Retrieve the sample that raised a threshold event. In IN_WINDOW
+ * 		  mode the interrupt is re-armed for the opposite crossing.
+ * 		  A range error (no target, weak signal, overflow) is the usual
+ * 		  sample once the target left past the far edge, so it counts as
+ * 		  beyond the window and still re-arms.
+ * 
+ * @pre threshold event pending
+ * 
+ * @param[out] range_result sample that raised the event, error_code set on a range error
+ * @param[out] is_in_window true if the sample is valid and lies within [low, high]
+ * @param[out] true if all I2C transfers succeeded
+*/
+bool vl6180x_get_threshold_event(vl6180x_range_result_struct *range_result, bool *is_in_window)
+{
+	bool result = true;
+	bool is_beyond = false;
+	uint8_t threshold_low = vl6180x_convert_mm_to_raw_range(vl6180x_threshold_low_mm);
+	uint8_t threshold_high = vl6180x_convert_mm_to_raw_range(vl6180x_threshold_high_mm);
+
+	result = vl6180x_get_range_sample(range_result);
+
+	if (result == true)
+	{
+		is_beyond = range_result->error_code != (uint8_t)VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR || range_result->raw_range > threshold_high;
+		*is_in_window = is_beyond == false && range_result->raw_range >= threshold_low;
+	}
+
+	if (result == true && vl6180x_threshold_mode == VL6180X_THRESHOLD_MODE_IN_WINDOW)
+	{
+		if (*is_in_window == true)
+		{
+			// inside: next event when leaving on either side
+			result = vl6180x_arm_range_interrupt(VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_OUT_OF_WINDOW, threshold_low, threshold_high);
+		}
+		else if (is_beyond == true)
+		{
+			// beyond: next event when moving closer than the far edge
+			result = vl6180x_arm_range_interrupt(VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_LEVEL_LOW, threshold_high, 0xFF);
+		}
+		else
+		{
+			// too close: next event when moving further than the near edge
+			result = vl6180x_arm_range_interrupt(VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_LEVEL_HIGH, 0, threshold_low);
+		}
+	}
+
+	return result;
+}
+
+
+//=============================================================================
+//	ambient light sensing
+//=============================================================================
+
+/******************************************************************************
+ * @brief Set ALS analogue gain and integration period
+ * 		  Both values are cached to convert raw counts to lux
+ * 
+ * @param[in] gain                  light channel gain
+ * @param[in] integration_period_ms 1 - 512 ms
+ * 
+ * @param[out] true if registers were written
+*/
+bool vl6180x_set_als_configuration(vl6180x_als_gain_enum gain, uint16_t integration_period_ms)
+{
+	bool result = true;
+	uint8_t gain_register = VL6180X_REGISTER_SYSALS_ANALOGUE_GAIN_VALUE_DARK_GAIN | ((uint8_t)gain & VL6180X_REGISTER_SYSALS_ANALOGUE_GAIN_MASK_LIGHT_GAIN);
+
+	if (integration_period_ms == 0 || integration_period_ms > VL6180X_ALS_INTEGRATION_PERIOD_MAX_MS)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSALS_ANALOGUE_GAIN, &gain_register, 1);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_register_u16(VL6180X_REGISTER_SYSALS_INTEGRATION_PERIOD, integration_period_ms - 1);
+	}
+
+	if (result == true)
+	{
+		vl6180x_als_gain = gain;
+		vl6180x_als_integration_period_ms = integration_period_ms;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Start single ALS measurement
+ * 
+ * @pre device initialized
+ * 
+ * @param[out] true if single measurement started
+*/
+bool vl6180x_request_single_als_measurement()
+{
+	return vl6180x_write_registers(VL6180X_REGISTER_SYSALS_START, &(uint8_t){VL6180X_REGISTER_SYSALS_START_VALUE_SINGLE_SHOT}, 1);
+}
+
+
+/******************************************************************************
+ * @brief Start continuous ALS measurements
+ * 		  The interval is set by SYSALS_INTERMEASUREMENT_PERIOD
+ * 
+ * @pre device initialized
+ * 
+ * @param[out] true if continuous mode started
+*/
+bool vl6180x_start_continuous_als_measurements()
+{
+	return vl6180x_write_registers(VL6180X_REGISTER_SYSALS_START, &(uint8_t){VL6180X_REGISTER_SYSALS_START_VALUE_TOGGLE_CONTINUOUS_MODE}, 1);
+}
+
 
-	return result;
+/******************************************************************************
+ * @brief Stop continuous ALS measurements
+ * 
+ * @pre continuous ALS mode started
+ * 
+ * @param[out] true if continuous mode stopped
+*/
+bool vl6180x_stop_continuous_als_measurements()
+{
+	return vl6180x_write_registers(VL6180X_REGISTER_SYSALS_START, &(uint8_t){VL6180X_REGISTER_SYSALS_START_VALUE_STOP_CONTINUOUS_MODE}, 1);
 }
 
 
 /******************************************************************************
- * @brief Start single measurement
+ * @brief Start interleaved mode: every ALS start is preceded by a range
+ * 		  measurement, both triggered by one continuous ALS start command.
+ * 		  The cycle time is set by SYSALS_INTERMEASUREMENT_PERIOD and must
+ * 		  cover range convergence plus ALS integration time.
  * 
- * @pre device Initialized
+ * @pre device initialized, range continuous mode stopped
  * 
- * @param[out] true if single measurement started
+ * @param[out] true if interleaved mode started
 */
-bool vl6180x_request_single_measurement()
+bool vl6180x_start_interleaved_measurements()
 {
 	bool result = true;
 
@@ -102,7 +1037,12 @@ bool vl6180x_request_single_measurement()
 
 	if (result == true)
 	{
-		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_START, &(uint8_t){VL6180X_REGISTER_SYSRANGE_START_VALUE_SINGLE_SHOT}, 1);
+		result = vl6180x_write_registers(VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE, &(uint8_t){VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE_VALUE_ENABLE}, 1);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_start_continuous_als_measurements();
 	}
 
 	return result;
@@ -110,21 +1050,21 @@ bool vl6180x_request_single_measurement()
 
 
 /******************************************************************************
- * @brief Start continuous measurement
+ * @brief Stop interleaved mode and return to independent range/ALS operation
  * 
- * @pre device initialized
+ * @pre interleaved mode started
  * 
- * @param[out] true if continuous mode started
+ * @param[out] true if interleaved mode stopped
 */
-bool vl6180x_start_continuous_measurements()
+bool vl6180x_stop_interleaved_measurements()
 {
 	bool result = true;
 
-	result = vl6180x_is_device_ready();
+	result = vl6180x_stop_continuous_als_measurements();
 
 	if (result == true)
 	{
-		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_START, &(uint8_t){VL6180X_REGISTER_SYSRANGE_START_VALUE_TOGGLE_CONTINUOUS_MODE}, 1);
+		result = vl6180x_write_registers(VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE, &(uint8_t){VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE_VALUE_DISABLE}, 1);
 	}
 
 	return result;
@@ -132,21 +1072,35 @@ bool vl6180x_start_continuous_measurements()
 
 
 /******************************************************************************
- * @brief Stop continuous measurements
+ * @brief Get result of an ALS measurement
  * 
- * @pre continuous mode started
+ * @pre ALS measurement ready
  * 
- * @param[out] true if continuous mode stopped
+ * @param[out] lux_100    illuminance in 0.01 lux
+ * @param[out] error_flag is non-zero if an error occured
+ * @param[out] true if succeeded
 */
-bool vl6180x_stop_continous_measurements()
+bool vl6180x_get_als_measurement_result(uint32_t *lux_100, uint8_t *error_flag)
 {
 	bool result = true;
+	uint8_t data[VL6180X_REGISTER_RESULT_ALS_VAL - VL6180X_REGISTER_RESULT_ALS_STATUS + 2];
 
-	result = vl6180x_is_device_ready();
+	// RESULT_ALS_STATUS, RESULT_INTERRUPT_STATUS_GPIO and RESULT_ALS_VAL in one burst
+	result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_ALS_STATUS, data, sizeof(data));
 
 	if (result == true)
 	{
-		result = vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_START, &(uint8_t){VL6180X_REGISTER_SYSRANGE_START_VALUE_STOP_CONTINUOUS_MODE}, 1);
+		*error_flag = data[0] & VL6180X_REGISTER_RESULT_ALS_STATUS_MASK_ERROR_CODE;
+		*lux_100 = vl6180x_convert_als_to_lux_100(sensor_endian_get_u16_be(&data[VL6180X_REGISTER_RESULT_ALS_VAL - VL6180X_REGISTER_RESULT_ALS_STATUS]));
+		if (*error_flag != 0)
+		{
+			result = false;
+		}
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSTEM_INTERRUPT_CLEAR, &(uint8_t){VL6180X_REGISTER_SYSTEM_INTERRUPT_CLEAR_VALUE_ALS}, 1);
 	}
 
 	return result;
@@ -154,44 +1108,39 @@ bool vl6180x_stop_continous_measurements()
 
 
 /******************************************************************************
- * @brief Check if new data is available
+ * @brief Get range and ALS result of an interleaved cycle in one burst read
+ * 		  (RESULT_RANGE_STATUS up to RESULT_RANGE_VAL) instead of four
+ * 		  separate transactions
  * 
- * @pre Single or Continuos measurement started
+ * @pre ALS measurement ready (interleaved mode: range completes first)
  * 
- * @param[out] error_flag with non-zero value if any error occred while aquiring measurement result
- * @param[out] true if check was OK and data available
+ * @param[out] distance_mm
+ * @param[out] lux_100    illuminance in 0.01 lux
+ * @param[out] error_flag range error code in upper nibble, ALS error code in lower nibble
+ * @param[out] true if succeeded
 */
-bool vl6180x_is_measurement_ready(uint8_t *error_flag)
+bool vl6180x_get_combined_measurement_result(uint8_t *distance_mm, uint32_t *lux_100, uint8_t *error_flag)
 {
 	bool result = true;
-	uint8_t data;
+	uint8_t data[VL6180X_RESULT_BURST_LENGTH];
 
-	result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO, &data, 1);
-
-	if (result == false)
-	{
-		*error_flag = VL6180X_GENERIC_ERROR;
-	}
+	result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_RANGE_STATUS, data, VL6180X_RESULT_BURST_LENGTH);
 
-	// check for errors
 	if (result == true)
 	{
-		*error_flag = data & VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_ERROR;
-		if (*error_flag != (uint8_t)VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_NO_ERROR)
+		*distance_mm = data[VL6180X_RESULT_BURST_OFFSET_RANGE_VAL];
+		*lux_100 = vl6180x_convert_als_to_lux_100(sensor_endian_get_u16_be(&data[VL6180X_RESULT_BURST_OFFSET_ALS_VAL]));
+		*error_flag = (data[VL6180X_RESULT_BURST_OFFSET_RANGE_STATUS] & VL6180X_REGISTER_RESULT_RANGE_STATUS_MASK_ERROR_CODE)
+					| ((data[VL6180X_RESULT_BURST_OFFSET_ALS_STATUS] & VL6180X_REGISTER_RESULT_ALS_STATUS_MASK_ERROR_CODE) >> 4);
+		if (*error_flag != 0)
 		{
 			result = false;
 		}
 	}
 
-	// check for new data
 	if (result == true)
 	{
-		vl6180x_result_int_range_gpio_enum range_sample_status;
-		range_sample_status = (vl6180x_result_int_range_gpio_enum) (data & VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_RANGE);
-		if (range_sample_status != VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_RANGE_NEW_SAMPLE_READY)
-		{
-			result = false;
-		}
+		result = vl6180x_clear_data_ready_interrupt();
 	}
 
 	return result;
@@ -199,54 +1148,87 @@ bool vl6180x_is_measurement_ready(uint8_t *error_flag)
 
 
 /******************************************************************************
- * @brief blocking function to check for new data
+ * @brief Convert raw ALS count to lux, fixed-point
+ * 		  lux = 0.32 * count / gain * (100 / integration_period_ms)
  * 
- * @param[out] true if new data available
+ * @param[in] als_count RESULT_ALS_VAL
+ * 
+ * @param[out] illuminance in 0.01 lux
 */
-bool vl6180x_wait_for_new_measurement(uint32_t poll_rate_ms)
+uint32_t vl6180x_convert_als_to_lux_100(uint16_t als_count)
 {
-	bool result = false;
-	uint8_t error_flag;
+	static const uint16_t gain_100_table[] = VL6180X_ALS_GAIN_100_TABLE;
 
-	while(true)
-	{
-		result = vl6180x_is_measurement_ready(&error_flag);
+	uint64_t numerator = (uint64_t)als_count * VL6180X_ALS_LUX_RESOLUTION_100 * VL6180X_ALS_REFERENCE_INTEGRATION_MS * 100;
+	uint32_t denominator = (uint32_t)gain_100_table[vl6180x_als_gain] * vl6180x_als_integration_period_ms;
 
-		// break on error or data ready
-		if (result == true || error_flag != (uint8_t)VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_NO_ERROR)
-		{
-			break;
-		}
+	return (uint32_t)(numerator / denominator);
+}
 
-		// otherwise sleep
-		vl6180x_sleep_ms(poll_rate_ms);
+
+/******************************************************************************
+ * @brief Read a 16-bit register (e.g. RESULT_RANGE_RETURN_RATE)
+ * 
+ * @param[in]  register_address address of the MSB
+ * @param[out] value
+ * @param[out] true if succeeded
+*/
+bool vl6180x_read_register_u16(const vl6180x_register_address_enum register_address, uint16_t *value)
+{
+	bool result = true;
+	uint8_t data[2];
+
+	result = vl6180x_read_registers(register_address, data, sizeof(data));
+
+	if (result == true)
+	{
+		*value = sensor_endian_get_u16_be(data);
 	}
 
 	return result;
 }
 
+
 /******************************************************************************
- * @brief Get results of single measurement
- * 
- * @pre measurement ready
+ * @brief Read a 32-bit register (e.g. RESULT_RANGE_RETURN_SIGNAL_COUNT)
  * 
- * @param[out] distance in mm
+ * @param[in]  register_address address of the MSB
+ * @param[out] value
  * @param[out] true if succeeded
 */
-bool vl6180x_get_measurement_result(uint8_t *distance_mm, uint8_t *error_flag)
+bool vl6180x_read_register_u32(const vl6180x_register_address_enum register_address, uint32_t *value)
 {
 	bool result = true;
-	
-	result = vl6180x_retrieve_measurement(distance_mm, error_flag);
+	uint8_t data[4];
+
+	result = vl6180x_read_registers(register_address, data, sizeof(data));
 
 	if (result == true)
 	{
-		result = vl6180x_clear_data_ready_interrupt();
+		*value = sensor_endian_get_u32_be(data);
 	}
+
 	return result;
 }
 
 
+/******************************************************************************
+ * @brief Write a 16-bit register (e.g. SYSALS_INTEGRATION_PERIOD)
+ * 
+ * @param[in] register_address address of the MSB
+ * @param[in] value
+ * @param[out] true if succeeded
+*/
+bool vl6180x_write_register_u16(const vl6180x_register_address_enum register_address, const uint16_t value)
+{
+	uint8_t data[2];
+
+	sensor_endian_put_u16_be(data, value);
+
+	return vl6180x_write_registers(register_address, data, sizeof(data));
+}
+
+
 //=============================================================================
 //	static functions
 //=============================================================================
@@ -481,3 +1463,193 @@ static bool vl6180x_clear_data_ready_interrupt()
 
 	return result;
 }
+
+
+/******************************************************************************
+ * @brief Check RESULT_INTERRUPT_STATUS_GPIO for a pending event
+ * 
+ * @param[in]  mask       field of the interrupt status register (range or ALS)
+ * @param[in]  value      expected value of the field
+ * @param[out] error_flag with non-zero value if any error occred while aquiring measurement result
+ * @param[out] true if check was OK and event pending
+*/
+static bool vl6180x_is_interrupt_pending(uint8_t mask, uint8_t value, uint8_t *error_flag)
+{
+	bool result = true;
+	uint8_t data;
+
+	result = vl6180x_read_registers(VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO, &data, 1);
+
+	if (result == false)
+	{
+		*error_flag = VL6180X_GENERIC_ERROR;
+	}
+
+	// check for errors
+	if (result == true)
+	{
+		*error_flag = data & VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_ERROR;
+		if (*error_flag != (uint8_t)VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_NO_ERROR)
+		{
+			result = false;
+		}
+	}
+
+	// check for new data
+	if (result == true)
+	{
+		if ((data & mask) != value)
+		{
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief blocking poll loop around an `is_*_ready` check
+ * 
+ * @param[out] true if new data available
+*/
+static bool vl6180x_wait_for_interrupt(bool (*is_ready)(uint8_t *error_flag), uint32_t poll_rate_ms)
+{
+	bool result = false;
+	uint8_t error_flag;
+
+	while(true)
+	{
+		result = is_ready(&error_flag);
+
+		// break on error or data ready
+		if (result == true || error_flag != (uint8_t)VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_NO_ERROR)
+		{
+			break;
+		}
+
+		// otherwise sleep
+		vl6180x_sleep_ms(poll_rate_ms);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Cache the 1x part-to-part offset and crosstalk valid height
+ * 		  so scaled values can always be derived from the originals
+ * 
+ * @param[out] true if succeeded
+*/
+static bool vl6180x_read_scaling_calibration()
+{
+	bool result = true;
+	uint8_t data;
+
+	result = vl6180x_read_registers(VL6180X_REGISTER_SYSRANGE_PART_TO_PART_RANGE_OFFSET, &data, 1);
+
+	if (result == true)
+	{
+		vl6180x_part_to_part_offset_1x = (int8_t)data;
+		result = vl6180x_read_registers(VL6180X_REGISTER_SYSRANGE_CROSSTALK_VALID_HEIGHT, &vl6180x_crosstalk_valid_height_1x, 1);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Write thresholds and range interrupt source as one grouped update.
+ * 		  The ALS interrupt source in the same register is preserved.
+ * 
+ * @param[in] source         range interrupt source
+ * @param[in] threshold_low  raw range units (current scaling)
+ * @param[in] threshold_high raw range units (current scaling)
+ * 
+ * @param[out] true if succeeded
+*/
+static bool vl6180x_arm_range_interrupt(vl6180x_int_config_range_enum source, uint8_t threshold_low, uint8_t threshold_high)
+{
+	bool result = true;
+	uint8_t interrupt_config;
+
+	result = vl6180x_read_registers(VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO, &interrupt_config, 1);
+
+	if (result == true)
+	{
+		interrupt_config = (interrupt_config & (uint8_t)~VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_MASK_RANGE) | (uint8_t)source;
+		result = vl6180x_write_registers(VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD, &(uint8_t){VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD_VALUE_HOLD}, 1);
+	}
+
+	if (result == true)
+	{
+		result &= vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_THRESH_HIGH, &threshold_high, 1);
+		result &= vl6180x_write_registers(VL6180X_REGISTER_SYSRANGE_THRESH_LOW, &threshold_low, 1);
+		result &= vl6180x_write_registers(VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO, &interrupt_config, 1);
+
+		// always release the hold, even if one of the writes failed
+		result &= vl6180x_write_registers(VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD, &(uint8_t){VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD_VALUE_RELEASE}, 1);
+	}
+
+	if (result == true)
+	{
+		vl6180x_threshold_armed_source = source;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief Convert mm to RESULT_RANGE_VAL units at the current scaling
+*/
+static uint8_t vl6180x_convert_mm_to_raw_range(uint16_t distance_mm)
+{
+	uint16_t raw_range = distance_mm / (uint16_t)vl6180x_range_scaling;
+
+	return (raw_range > 0xFF) ? 0xFF : (uint8_t)raw_range;
+}
+
+
+/******************************************************************************
+ * @brief Recompute SYSRANGE_EARLY_CONVERGENCE_ESTIMATE for a new convergence
+ * 		  time, following VL6180x_RangeSetEarlyConvergenceEestimateThreshold()
+ * 		  of the ST API. With a fixed ECE a shorter convergence time would
+ * 		  reject valid targets.
+ * 
+ * @param[in] settings profile being applied
+ * 
+ * @param[out] true if succeeded
+*/
+static bool vl6180x_update_early_convergence_estimate(const vl6180x_ranging_profile_struct *settings)
+{
+	bool result = true;
+	uint32_t fine_threshold;
+	uint32_t averaging_time_us = VL6180X_READOUT_AVERAGING_BASE_TIME_US + ((uint32_t)settings->readout_averaging_period * VL6180X_READOUT_AVERAGING_STEP_TIME_NS) / 1000;
+	uint32_t convergence_time_us = (uint32_t)settings->max_convergence_time_ms * 1000;
+	uint32_t ece_threshold;
+
+	if (convergence_time_us <= averaging_time_us)
+	{
+		result = false;
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_read_register_u32(VL6180X_REGISTER_PRIVATE_ECE_FINE_THRESHOLD, &fine_threshold);
+	}
+
+	if (result == true)
+	{
+		convergence_time_us -= averaging_time_us;
+		ece_threshold = (uint32_t)(((uint64_t)VL6180X_ECE_FACTOR_M * VL6180X_ECE_SAMPLE_TIME_US * fine_threshold * 256) / ((uint64_t)convergence_time_us * VL6180X_ECE_FACTOR_D));
+		if (ece_threshold > 0xFFFF)
+		{
+			ece_threshold = 0xFFFF;
+		}
+		result = vl6180x_write_register_u16(VL6180X_REGISTER_SYSRANGE_EARLY_CONVERGENCE_ESTIMATE, (uint16_t)ece_threshold);
+	}
+
+	return result;
+}
@@ -14,6 +14,29 @@
 
 #include "vl6180x_definitions.h"
 
+// range result with the scale it was measured at; distance_mm is always in mm
+typedef struct
+{
+	uint16_t distance_mm;
+	uint8_t raw_range;
+	vl6180x_range_scaling_enum scaling;
+	uint8_t error_code;
+}vl6180x_range_result_struct;
+
+// range result extended with signal quality, see vl6180x_get_range_quality_result()
+typedef struct
+{
+	vl6180x_range_result_struct range;
+	vl6180x_range_error_enum error;
+	uint8_t confidence;                     // 0 (invalid) - VL6180X_RANGE_CONFIDENCE_MAX
+	uint16_t return_rate_mcps_128;          // 9.7 fixed-point MCPS
+	uint16_t reference_rate_mcps_128;       // 9.7 fixed-point MCPS
+	uint32_t return_signal_count;
+	uint32_t return_ambient_count;
+	uint32_t return_convergence_time_us;
+	uint32_t reference_convergence_time_us;
+}vl6180x_range_quality_struct;
+
 // function pointer for memory read/write
 typedef bool (vl6180x_register_operation)(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length);
 typedef bool (vl6180x_sleep_function)(const uint32_t sleep_ms);
@@ -27,6 +50,54 @@ bool vl6180x_stop_continous_measurements();
 
 bool vl6180x_is_measurement_ready(uint8_t *error_flag);
 bool vl6180x_wait_for_new_measurement(uint32_t poll_rate_ms);
+bool vl6180x_wait_for_device_ready(uint32_t poll_rate_ms);
 bool vl6180x_get_measurement_result(uint8_t *distance_mm, uint8_t *error_flag);
 
+// range quality
+bool vl6180x_get_range_quality_result(vl6180x_range_quality_struct *range_quality);
+vl6180x_range_error_enum vl6180x_decode_range_error(uint8_t error_code);
+const char *vl6180x_get_range_error_name(vl6180x_range_error_enum error);
+bool vl6180x_set_max_convergence_time(uint8_t max_convergence_time_ms);
+
+// ranging profiles
+bool vl6180x_set_ranging_profile(vl6180x_ranging_profile_enum profile);
+uint32_t vl6180x_get_range_execution_time_us(vl6180x_ranging_profile_enum profile);
+uint32_t vl6180x_get_intermeasurement_period_ms(vl6180x_ranging_profile_enum profile);
+
+// range scaling
+bool vl6180x_set_range_scaling(vl6180x_range_scaling_enum scaling);
+vl6180x_range_scaling_enum vl6180x_get_range_scaling();
+vl6180x_range_scaling_enum vl6180x_select_range_scaling(vl6180x_range_scaling_enum scaling, const vl6180x_range_result_struct *range_result);
+bool vl6180x_get_range_result(vl6180x_range_result_struct *range_result);
+bool vl6180x_get_range_sample(vl6180x_range_result_struct *range_result);
+
+// threshold interrupts
+bool vl6180x_set_threshold_mode(vl6180x_threshold_mode_enum mode, uint16_t threshold_low_mm, uint16_t threshold_high_mm);
+bool vl6180x_set_range_thresholds(uint16_t threshold_low_mm, uint16_t threshold_high_mm);
+bool vl6180x_disable_threshold_mode();
+bool vl6180x_is_threshold_event_pending(uint8_t *error_flag);
+bool vl6180x_wait_for_threshold_event(uint32_t poll_rate_ms);
+bool vl6180x_get_threshold_event(vl6180x_range_result_struct *range_result, bool *is_in_window);
+
+// ambient light sensing
+bool vl6180x_set_als_configuration(vl6180x_als_gain_enum gain, uint16_t integration_period_ms);
+
+bool vl6180x_request_single_als_measurement();
+bool vl6180x_start_continuous_als_measurements();
+bool vl6180x_stop_continuous_als_measurements();
+bool vl6180x_start_interleaved_measurements();
+bool vl6180x_stop_interleaved_measurements();
+
+bool vl6180x_is_als_measurement_ready(uint8_t *error_flag);
+bool vl6180x_wait_for_new_als_measurement(uint32_t poll_rate_ms);
+bool vl6180x_get_als_measurement_result(uint32_t *lux_100, uint8_t *error_flag);
+bool vl6180x_get_combined_measurement_result(uint8_t *distance_mm, uint32_t *lux_100, uint8_t *error_flag);
+
+uint32_t vl6180x_convert_als_to_lux_100(uint16_t als_count);
+
+// multi-byte register access (big-endian, MSB at lowest address)
+bool vl6180x_read_register_u16(const vl6180x_register_address_enum register_address, uint16_t *value);
+bool vl6180x_read_register_u32(const vl6180x_register_address_enum register_address, uint32_t *value);
+bool vl6180x_write_register_u16(const vl6180x_register_address_enum register_address, const uint16_t value);
+
 #endif /* VL6180X_VL6180X_H_ */
@@ -5,9 +5,15 @@
  *      Author: Aniel
  */
 
+#include <string.h>
+
 #include "i2c.h"
 #include "usart.h"
 
+#include "../common/sensor_i2c.h"
+#include "../common/sensor_record.h"
+#include "../common/sensor_registry.h"
+
 #include "vl6180x_application.h"
 
 
@@ -18,12 +24,40 @@
 static bool vl6180x_application_read_registers(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, const uint16_t data_length);
 static bool vl6180x_application_write_registers(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, const uint16_t data_length);
 static bool vl6180x_application_sleep(const uint32_t timeout_ms);
+static bool vl6180x_application_apply_auto_scaling(const vl6180x_range_result_struct *range_result);
+static uint32_t vl6180x_application_isqrt(uint64_t value);
+static bool vl6180x_application_halt_ranging(bool is_running);
+
+
+//=============================================================================
+//	defines
+//=============================================================================
 
+// number of consecutive results that must agree before the range scale changes
+#define VL6180X_AUTO_SCALING_CONFIRM_SAMPLES (3)
 
 //=============================================================================
 //	global variables
 //=============================================================================
-const uint8_t vl6180x_device_i2c_address = VL6180X_I2C_DEVICE_ADDRESS;
+const sensor_i2c_device_struct vl6180x_device =
+{
+	.name           = "VL6180X",
+	.i2c_handle     = &hi2c3,
+	.device_address = VL6180X_I2C_DEVICE_ADDRESS,
+	.address_width  = SENSOR_I2C_ADDRESS_WIDTH_16BIT,
+};
+
+// achieved sample rates
+static uint32_t vl6180x_rate_start_tick_ms;
+static uint32_t vl6180x_range_sample_count;
+static uint32_t vl6180x_als_sample_count;
+
+// last profile set by vl6180x_application_set_ranging_profile(), COUNT = device defaults
+static vl6180x_ranging_profile_enum vl6180x_application_profile = VL6180X_RANGING_PROFILE_COUNT;
+
+// auto scaling
+static bool vl6180x_auto_scaling_enabled = false;
+static uint8_t vl6180x_auto_scaling_votes;
 
 //=============================================================================
 //	client functions
@@ -47,6 +81,7 @@ bool vl6180x_application_initialize_device()
 	if (result == true)
 	{
 		result = vl6180x_start_continuous_measurements();
+		vl6180x_rate_start_tick_ms = HAL_GetTick();
 	}
 
 	uint8_t msg[92];
@@ -88,41 +123,264 @@ bool vl6180x_application_poll_measurement(uint8_t *distance_mm)
 		result = vl6180x_get_measurement_result(distance_mm, &error_flag);
 	}
 
+	if (result == true)
+	{
+		vl6180x_range_sample_count++;
+	}
+
 	return result;
 }
 
 
-//=============================================================================
-//	callback functions
-//=============================================================================
+/******************************************************************************
+ * @brief client API to retrieve a scaled range result
+ * 		  Applies auto scaling afterwards if enabled
+ * 
+ * @param[out] range_result distance in mm, scaling and error code
+*/
+bool vl6180x_application_poll_range_result(vl6180x_range_result_struct *range_result)
+{
+	bool result = true;
+
+	result = vl6180x_wait_for_new_measurement(10);
+
+	if (result == true)
+	{
+		result = vl6180x_get_range_result(range_result);
+
+		// overflow results carry the information needed to scale up
+		if (vl6180x_auto_scaling_enabled == true)
+		{
+			vl6180x_application_apply_auto_scaling(range_result);
+		}
+	}
+
+	if (result == true)
+	{
+		vl6180x_range_sample_count++;
+	}
+
+	return result;
+}
+
 
 /******************************************************************************
- * @brief read I2C register. Uses underlying HAL 
+ * @brief client API to retrieve a range result with signal quality metrics
  * 
- * @param[in] register_address
- * @param[in] data_buffer
- * @param[in] data_length
+ * @param[out] range_quality scaled range, decoded error and confidence
+*/
+bool vl6180x_application_poll_range_quality(vl6180x_range_quality_struct *range_quality)
+{
+	bool result = true;
+
+	result = vl6180x_wait_for_new_measurement(10);
+
+	if (result == true)
+	{
+		result = vl6180x_get_range_quality_result(range_quality);
+	}
+
+	if (result == true)
+	{
+		vl6180x_range_sample_count++;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief enable/disable automatic range scaling in continuous range mode
+*/
+void vl6180x_application_set_auto_scaling(bool enable)
+{
+	vl6180x_auto_scaling_enabled = enable;
+	vl6180x_auto_scaling_votes = 0;
+}
+
+
+/******************************************************************************
+ * @brief client API to only report targets entering or leaving a window
+ * 		  while the sensor keeps ranging continuously
  * 
- * @param[out] true if succeeds
+ * @param[in] window_low_mm
+ * @param[in] window_high_mm
 */
-static bool vl6180x_application_read_registers(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, const uint16_t data_length)
+bool vl6180x_application_start_presence_detection(uint16_t window_low_mm, uint16_t window_high_mm)
+{
+	return vl6180x_set_threshold_mode(VL6180X_THRESHOLD_MODE_IN_WINDOW, window_low_mm, window_high_mm);
+}
+
+
+/******************************************************************************
+ * @brief client API to wait for a presence change
+ * 		  GPIO1 is not routed to an EXTI line yet, so the interrupt status is
+ * 		  polled at a low rate; the bus stays idle between polls
+ * 
+ * @param[out] range_result sample that raised the event
+ * @param[out] is_present   true if the target is inside the window
+*/
+bool vl6180x_application_poll_presence_event(vl6180x_range_result_struct *range_result, bool *is_present)
 {
 	bool result = true;
-	uint8_t msg[92];
+
+	result = vl6180x_wait_for_threshold_event(50);
+
+	if (result == true)
+	{
+		result = vl6180x_get_threshold_event(range_result, is_present);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief client API to retrieve ALS measurement
+ * 
+ * @param[out] lux_100 illuminance in 0.01 lux
+*/
+bool vl6180x_application_poll_als_measurement(uint32_t *lux_100)
+{
+	bool result = true;
+
+	result = vl6180x_wait_for_new_als_measurement(10);
+
+	if (result == true)
+	{
+		uint8_t error_flag;
+		result = vl6180x_get_als_measurement_result(lux_100, &error_flag);
+	}
+
+	if (result == true)
+	{
+		vl6180x_als_sample_count++;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief client API to switch the ranging profile while ranging continuously
+ * 
+ * @param[in] profile
+*/
+bool vl6180x_application_set_ranging_profile(vl6180x_ranging_profile_enum profile)
+{
+	bool result = true;
+
+	result = vl6180x_application_halt_ranging(true);
+
+	if (result == true)
+	{
+		result = vl6180x_set_ranging_profile(profile);
+	}
+
+	if (result == true)
+	{
+		vl6180x_application_profile = profile;
+		result = vl6180x_start_continuous_measurements();
+	}
+
+	if (result == true)
+	{
+		vl6180x_rate_start_tick_ms = HAL_GetTick();
+		vl6180x_range_sample_count = 0;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief client API to measure the achieved rate and noise of a profile on
+ * 		  a static target. Leaves the profile active.
+ * 		  Samples with a range error (expected with the short convergence
+ * 		  times of the fast profiles) are counted apart and kept out of the
+ * 		  noise. More errors than `sample_count` end the run, the target is
+ * 		  then out of reach for the profile.
+ * 
+ * @param[in]  profile
+ * @param[in]  sample_count       number of valid samples to collect
+ * @param[out] rate_mHz           achieved range samples per 1000 s, errors included
+ * @param[out] noise_mm_100       standard deviation of the distance in 0.01 mm
+ * @param[out] range_error_count  samples with a range error
+ * @param[out] true if `sample_count` valid samples were collected
+*/
+bool vl6180x_application_characterize_profile(vl6180x_ranging_profile_enum profile, uint16_t sample_count, uint32_t *rate_mHz, uint32_t *noise_mm_100,
+											  uint32_t *range_error_count)
+{
+	bool result = true;
+	vl6180x_range_result_struct range_result;
+	uint16_t valid_count = 0;
+	uint32_t sum = 0;
+	uint64_t sum_of_squares = 0;
+	uint32_t als_rate_mHz;
+	uint8_t msg[144];
 	uint16_t msg_len;
 
-	HAL_StatusTypeDef retval = HAL_I2C_Mem_Read(&hi2c3, vl6180x_device_i2c_address, (uint8_t)register_address, I2C_MEMADD_SIZE_16BIT, data_buffer, data_length, HAL_MAX_DELAY);
+	*range_error_count = 0;
 
-	if (retval == HAL_OK)
+	if (sample_count == 0)
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "VL6180X - read registers: addr: 0x%x | len: %2d | data[0]: %d [OK]\r\n", (uint8_t)register_address, data_length,  *data_buffer);
+		result = false;
 	}
-	else
+
+	if (result == true)
+	{
+		result = vl6180x_application_set_ranging_profile(profile);
+	}
+
+	while (result == true && valid_count < sample_count && *range_error_count <= sample_count)
+	{
+		result = vl6180x_wait_for_new_measurement(10);
+
+		// only bus errors end the run
+		if (result == true)
+		{
+			result = vl6180x_get_range_sample(&range_result);
+		}
+		if (result == true)
+		{
+			vl6180x_range_sample_count++;
+
+			if (range_result.error_code == (uint8_t)VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR)
+			{
+				sum += range_result.distance_mm;
+				sum_of_squares += (uint32_t)range_result.distance_mm * range_result.distance_mm;
+				valid_count++;
+			}
+			else
+			{
+				(*range_error_count)++;
+			}
+
+			// overflow results carry the information needed to scale up
+			if (vl6180x_auto_scaling_enabled == true)
+			{
+				vl6180x_application_apply_auto_scaling(&range_result);
+			}
+		}
+	}
+
+	if (result == true && valid_count < sample_count)
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "VL6180X - read registers: addr: 0x%x | len: %2d | result: %d [FAILED]\r\n", (uint8_t)register_address, data_length, retval);
 		result = false;
 	}
 
+	if (result == true)
+	{
+		// variance in 0.0001 mm^2 => standard deviation in 0.01 mm
+		uint64_t variance_10000 = ((sum_of_squares * sample_count - (uint64_t)sum * sum) * 10000) / ((uint64_t)sample_count * sample_count);
+
+		vl6180x_application_get_sample_rates(rate_mHz, &als_rate_mHz);
+		*noise_mm_100 = vl6180x_application_isqrt(variance_10000);
+	}
+
+	msg_len = (uint16_t)sprintf((char*)msg, "VL6180X - profile %d: %lu mHz (period %lu ms) | noise: %lu/100 mm | valid: %u, range errors: %lu\r\n", profile,
+								(result == true) ? (unsigned long)*rate_mHz : 0UL, (unsigned long)vl6180x_get_intermeasurement_period_ms(profile),
+								(result == true) ? (unsigned long)*noise_mm_100 : 0UL, (unsigned int)valid_count, (unsigned long)*range_error_count);
 	HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
 
 	return result;
@@ -130,7 +388,108 @@ static bool vl6180x_application_read_registers(const vl6180x_register_address_en
 
 
 /******************************************************************************
- * @brief write I2C register. Uses underlying HAL 
+ * @brief client API to switch from continuous ranging to interleaved range+ALS
+*/
+bool vl6180x_application_start_interleaved_mode()
+{
+	bool result = true;
+
+	result = vl6180x_stop_continous_measurements();
+
+	if (result == true)
+	{
+		// wait for the running range measurement to finish before the device accepts a new start
+		vl6180x_application_sleep(100);
+		result = vl6180x_start_interleaved_measurements();
+	}
+
+	if (result == true)
+	{
+		vl6180x_rate_start_tick_ms = HAL_GetTick();
+		vl6180x_range_sample_count = 0;
+		vl6180x_als_sample_count = 0;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief client API to retrieve range and ALS of one interleaved cycle
+ * 
+ * @param[out] distance_mm
+ * @param[out] lux_100 illuminance in 0.01 lux
+*/
+bool vl6180x_application_poll_interleaved_measurement(uint8_t *distance_mm, uint32_t *lux_100)
+{
+	bool result = true;
+
+	// ALS completes after the range measurement of the same cycle
+	result = vl6180x_wait_for_new_als_measurement(10);
+
+	if (result == true)
+	{
+		uint8_t error_flag;
+		result = vl6180x_get_combined_measurement_result(distance_mm, lux_100, &error_flag);
+	}
+
+	if (result == true)
+	{
+		vl6180x_range_sample_count++;
+		vl6180x_als_sample_count++;
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief achieved sample rates since the measurement mode was started
+ * 
+ * @param[out] range_rate_mHz range samples per 1000 s
+ * @param[out] als_rate_mHz   ALS samples per 1000 s
+*/
+void vl6180x_application_get_sample_rates(uint32_t *range_rate_mHz, uint32_t *als_rate_mHz)
+{
+	uint32_t elapsed_ms = HAL_GetTick() - vl6180x_rate_start_tick_ms;
+
+	if (elapsed_ms == 0)
+	{
+		*range_rate_mHz = 0;
+		*als_rate_mHz = 0;
+	}
+	else
+	{
+		*range_rate_mHz = (uint32_t)(((uint64_t)vl6180x_range_sample_count * 1000000) / elapsed_ms);
+		*als_rate_mHz = (uint32_t)(((uint64_t)vl6180x_als_sample_count * 1000000) / elapsed_ms);
+	}
+}
+
+
+//=============================================================================
+//	callback functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief read I2C register. Uses the shared 16-bit register transport
+ * 
+ * @param[in] register_address
+ * @param[in] data_buffer
+ * @param[in] data_length
+ * 
+ * @param[out] true if succeeds
+*/
+static bool vl6180x_application_read_registers(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	bool result = sensor_i2c_read_registers(&vl6180x_device, (uint16_t)register_address, data_buffer, data_length);
+
+	sensor_record_transaction(SENSOR_RECORD_DEVICE_VL6180X, false, (uint16_t)register_address, data_buffer, data_length, result);
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief write I2C register. Uses the shared 16-bit register transport
  * 
  * @param[in] register_address
  * @param[in] data_buffer
@@ -140,27 +499,120 @@ static bool vl6180x_application_read_registers(const vl6180x_register_address_en
 */
 static bool vl6180x_application_write_registers(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, const uint16_t data_length)
 {
-	bool result = true;
-	uint8_t msg[92];
-	uint16_t msg_len;
+	bool result = sensor_i2c_write_registers(&vl6180x_device, (uint16_t)register_address, data_buffer, data_length);
+
+	sensor_record_transaction(SENSOR_RECORD_DEVICE_VL6180X, true, (uint16_t)register_address, data_buffer, data_length, result);
+	return result;
+}
+
 
-	HAL_StatusTypeDef retval = HAL_I2C_Mem_Write(&hi2c3, vl6180x_device_i2c_address, (uint8_t)register_address, I2C_MEMADD_SIZE_16BIT, data_buffer, data_length, HAL_MAX_DELAY);
+/******************************************************************************
+ * @brief change the range scale once enough consecutive results ask for it.
+ * 		  Continuous ranging is stopped while the scaling registers change.
+ * 
+ * @param[in] range_result latest result
+ * 
+ * @param[out] true if no change was needed or the change succeeded
+*/
+static bool vl6180x_application_apply_auto_scaling(const vl6180x_range_result_struct *range_result)
+{
+	bool result = true;
+	vl6180x_range_scaling_enum selected = vl6180x_select_range_scaling(range_result->scaling, range_result);
 
-	if (retval == HAL_OK)
+	if (selected == range_result->scaling)
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "VL6180X - write registers: addr: 0x%x | len: %2d | result: %d [OK]\r\n", (uint8_t)register_address, data_length,  retval);
+		vl6180x_auto_scaling_votes = 0;
 	}
 	else
 	{
-		msg_len = (uint16_t)sprintf((char*)msg, "VL6180X - write registers: addr: 0x%x | len: %2d | result: %d [FAILED]\r\n", (uint8_t)register_address, data_length, retval);
-		result = false;
+		vl6180x_auto_scaling_votes++;
+	}
+
+	if (vl6180x_auto_scaling_votes >= VL6180X_AUTO_SCALING_CONFIRM_SAMPLES)
+	{
+		vl6180x_auto_scaling_votes = 0;
+
+		// the scaler can only change while idle
+		result = vl6180x_application_halt_ranging(true);
+
+		if (result == true)
+		{
+			result = vl6180x_set_range_scaling(selected);
+		}
+		if (result == true)
+		{
+			result = vl6180x_start_continuous_measurements();
+		}
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief bring the device to idle before ranging registers change.
+ * 		  A running continuous mode is stopped once the device takes commands,
+ * 		  then the measurement in progress is waited for. A stop command on
+ * 		  an idle device would start a single shot instead.
+ * 
+ * @param[in] is_running continuous ranging is active
+ * 
+ * @param[out] true if the device is idle
+*/
+static bool vl6180x_application_halt_ranging(bool is_running)
+{
+	bool result = true;
+
+	if (is_running == true)
+	{
+		result = vl6180x_wait_for_device_ready(1);
+
+		if (result == true)
+		{
+			result = vl6180x_stop_continous_measurements();
+		}
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_wait_for_device_ready(1);
 	}
 
-	HAL_UART_Transmit(&huart2, msg, msg_len, HAL_MAX_DELAY);
 	return result;
 }
 
 
+/******************************************************************************
+ * @brief integer square root (bitwise, no floating point)
+*/
+static uint32_t vl6180x_application_isqrt(uint64_t value)
+{
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > value)
+	{
+		bit >>= 2;
+	}
+
+	while (bit != 0)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t)root;
+}
+
+
 /******************************************************************************
  * @brief sleep function
  * 
@@ -171,3 +623,185 @@ static bool vl6180x_application_sleep(const uint32_t timeout_ms)
 	HAL_Delay(timeout_ms);
 	return true;
 }
+
+
+//=============================================================================
+//	generic sensor interface
+//=============================================================================
+
+static bool vl6180x_sensor_probe()
+{
+	bool result = true;
+	uint8_t model_id = 0;
+
+	result = vl6180x_application_read_registers(VL6180X_REGISTER_IDENTIFICATION_MODEL_ID, &model_id, 1);
+
+	if (result == true)
+	{
+		result = (model_id == VL6180X_REGISTER_IDENTIFICATION_MODEL_ID_VALUE);
+	}
+	return result;
+}
+
+
+static bool vl6180x_sensor_initialize()
+{
+	return vl6180x_initialize(&vl6180x_application_read_registers, &vl6180x_application_write_registers, &vl6180x_application_sleep);
+}
+
+
+static bool vl6180x_sensor_start()
+{
+	bool result = true;
+
+	result = vl6180x_start_continuous_measurements();
+
+	if (result == true)
+	{
+		vl6180x_rate_start_tick_ms = HAL_GetTick();
+		vl6180x_range_sample_count = 0;
+	}
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief raw layout: [raw range, scaling, error code]
+*/
+static bool vl6180x_sensor_read_raw(sensor_raw_struct *raw, bool *is_ready)
+{
+	bool result = true;
+	uint8_t error_flag = 0;
+	vl6180x_range_result_struct range_result = {0};
+
+	*is_ready = vl6180x_is_measurement_ready(&error_flag);
+
+	// failed status read or device error (laser safety, PLL) in RESULT_INTERRUPT_STATUS_GPIO
+	if (*is_ready == false && error_flag != 0)
+	{
+		result = false;
+	}
+
+	if (*is_ready == true)
+	{
+		// a range error is a valid (but unusable) sample, only bus errors fail the read
+		result = vl6180x_get_range_sample(&range_result);
+	}
+	if (*is_ready == true && result == true)
+	{
+		raw->data[0] = range_result.raw_range;
+		raw->data[1] = (uint8_t)range_result.scaling;
+		raw->data[2] = range_result.error_code;
+		raw->length = 3;
+		vl6180x_range_sample_count++;
+	}
+	return result;
+}
+
+
+static bool vl6180x_sensor_convert(const sensor_raw_struct *raw, int32_t *distance_mm)
+{
+	bool result = (raw->data[2] == (uint8_t)VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR);
+
+	if (result == true)
+	{
+		*distance_mm = (int32_t)raw->data[0] * (int32_t)raw->data[1];
+	}
+	return result;
+}
+
+
+static bool vl6180x_sensor_sleep()
+{
+	return vl6180x_stop_continous_measurements();
+}
+
+
+/******************************************************************************
+ * @brief keys: profile (0 high speed, 1 balanced, 2 high accuracy), scaling (1-3)
+ * 		  Ranging is halted while the registers change and only restarted if
+ * 		  the registry has the sensor running.
+*/
+static bool vl6180x_sensor_set_config(const char *key, int32_t value)
+{
+	bool result = true;
+	bool is_profile = (strcmp(key, "profile") == 0 && value >= 0 && value < VL6180X_RANGING_PROFILE_COUNT);
+	bool is_scaling = (strcmp(key, "scaling") == 0 && value >= VL6180X_RANGE_SCALING_1X && value <= VL6180X_RANGE_SCALING_3X);
+	bool is_halted = false;
+	uint8_t index;
+	bool is_running = sensor_registry_find(vl6180x_sensor_driver.name, &index) && sensor_registry_is_running(index);
+
+	result = (is_profile == true || is_scaling == true);
+
+	if (result == true)
+	{
+		result = vl6180x_application_halt_ranging(is_running);
+		is_halted = result;
+	}
+
+	if (result == true && is_profile == true)
+	{
+		result = vl6180x_set_ranging_profile((vl6180x_ranging_profile_enum)value);
+		if (result == true)
+		{
+			vl6180x_application_profile = (vl6180x_ranging_profile_enum)value;
+		}
+	}
+	else if (result == true)
+	{
+		result = vl6180x_set_range_scaling((vl6180x_range_scaling_enum)value);
+	}
+
+	// restart even after a failed change, the sensor keeps its previous settings
+	if (is_running == true && is_halted == true)
+	{
+		bool is_restarted = vl6180x_start_continuous_measurements();
+
+		if (is_restarted == true)
+		{
+			vl6180x_rate_start_tick_ms = HAL_GetTick();
+			vl6180x_range_sample_count = 0;
+		}
+		result = result && is_restarted;
+	}
+	return result;
+}
+
+
+static bool vl6180x_sensor_get_config(const char *key, int32_t *value)
+{
+	bool result = true;
+
+	if (strcmp(key, "profile") == 0 && vl6180x_application_profile < VL6180X_RANGING_PROFILE_COUNT)
+	{
+		*value = (int32_t)vl6180x_application_profile;
+	}
+	else if (strcmp(key, "scaling") == 0)
+	{
+		*value = (int32_t)vl6180x_get_range_scaling();
+	}
+	else
+	{
+		result = false;
+	}
+	return result;
+}
+
+
+// continuous ranging, the sample rate follows the ranging profile
+const sensor_driver_struct vl6180x_sensor_driver =
+{
+	.name           = "VL6180X",
+	.unit           = "mm",
+	.period_ms      = 0,
+	.is_single_shot = false,
+
+	.probe          = &vl6180x_sensor_probe,
+	.initialize     = &vl6180x_sensor_initialize,
+	.start          = &vl6180x_sensor_start,
+	.read_raw       = &vl6180x_sensor_read_raw,
+	.convert        = &vl6180x_sensor_convert,
+	.sleep          = &vl6180x_sensor_sleep,
+	.set_config     = &vl6180x_sensor_set_config,
+	.get_config     = &vl6180x_sensor_get_config,
+};
@@ -9,8 +9,25 @@
 #define VL6180X_VL6180X_APPLICATION_H_
 
 #include "vl6180x.h"
+#include "../common/sensor_driver.h"
+
+extern const sensor_driver_struct vl6180x_sensor_driver;
 
 bool vl6180x_application_initialize_device();
 bool vl6180x_application_poll_measurement(uint8_t *distance_mm);
+bool vl6180x_application_poll_range_result(vl6180x_range_result_struct *range_result);
+void vl6180x_application_set_auto_scaling(bool enable);
+bool vl6180x_application_poll_range_quality(vl6180x_range_quality_struct *range_quality);
+bool vl6180x_application_start_presence_detection(uint16_t window_low_mm, uint16_t window_high_mm);
+bool vl6180x_application_poll_presence_event(vl6180x_range_result_struct *range_result, bool *is_present);
+bool vl6180x_application_poll_als_measurement(uint32_t *lux_100);
+bool vl6180x_application_poll_interleaved_measurement(uint8_t *distance_mm, uint32_t *lux_100);
+
+bool vl6180x_application_set_ranging_profile(vl6180x_ranging_profile_enum profile);
+bool vl6180x_application_characterize_profile(vl6180x_ranging_profile_enum profile, uint16_t sample_count, uint32_t *rate_mHz, uint32_t *noise_mm_100,
+											  uint32_t *range_error_count);
+
+bool vl6180x_application_start_interleaved_mode();
+void vl6180x_application_get_sample_rates(uint32_t *range_rate_mHz, uint32_t *als_rate_mHz);
 
 #endif /* VL6180X_VL6180X_APPLICATION_H_ */
@@ -56,6 +56,7 @@ typedef enum
 	VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES         = 0x02D,
 	VL6180X_REGISTER_SYSRANGE_VHV_RECALIBRATE             = 0x02E,
 	VL6180X_REGISTER_SYSRANGE_VHV_REPEAT_RATE             = 0x031,
+	VL6180X_REGISTER_SYSRANGE_RANGE_SCALER                = 0x096,
 
 	VL6180X_REGISTER_SYSALS_START                   = 0x038,
 	VL6180X_REGISTER_SYSALS_THRESH_HIGH             = 0x03A,
@@ -122,6 +123,111 @@ typedef enum
 #define VL6180X_REGISTER_SYSRANGE_START_VALUE_STOP_CONTINUOUS_MODE 	 (0b01)
 
 
+//=============================================================================
+//	VL6180X_REGISTER_SYSRANGE_MAX_CONVERGENCE_TIME
+//=============================================================================
+#define VL6180X_MAX_CONVERGENCE_TIME_MAX_MS (63)
+
+
+//=============================================================================
+//	ranging timing - VL6180X datasheet, section 2.5
+//=============================================================================
+// range execution time = pre-calibration + convergence + readout averaging
+#define VL6180X_RANGE_PRE_CALIBRATION_TIME_US      (3200)
+#define VL6180X_READOUT_AVERAGING_BASE_TIME_US     (1300)
+#define VL6180X_READOUT_AVERAGING_STEP_TIME_NS     (64500)
+
+// SYSRANGE_INTERMEASUREMENT_PERIOD holds (period / 10 ms) - 1
+#define VL6180X_INTERMEASUREMENT_PERIOD_STEP_MS    (10)
+
+// SYSRANGE_EARLY_CONVERGENCE_ESTIMATE derivation as in the ST API (UM2760)
+#define VL6180X_REGISTER_PRIVATE_ECE_FINE_THRESHOLD (0x0B8)
+#define VL6180X_ECE_SAMPLE_TIME_US                  (500)
+#define VL6180X_ECE_FACTOR_M                        (85)
+#define VL6180X_ECE_FACTOR_D                        (100)
+
+typedef enum
+{
+	VL6180X_RANGING_PROFILE_HIGH_SPEED,    // ~100 Hz, short convergence, no averaging
+	VL6180X_RANGING_PROFILE_BALANCED,      // ~50 Hz
+	VL6180X_RANGING_PROFILE_HIGH_ACCURACY, // ~10 Hz, AN4545 recommended settings
+	VL6180X_RANGING_PROFILE_COUNT,
+}vl6180x_ranging_profile_enum;
+
+
+//=============================================================================
+//	range scaling - VL6180X datasheet, section 2.7
+//=============================================================================
+typedef enum
+{
+	VL6180X_RANGE_SCALING_1X = 1,
+	VL6180X_RANGE_SCALING_2X = 2,
+	VL6180X_RANGE_SCALING_3X = 3,
+}vl6180x_range_scaling_enum;
+
+// SYSRANGE_RANGE_SCALER value per scaling factor, index 0 is unused
+#define VL6180X_RANGE_SCALER_VALUE_TABLE {0, 253, 127, 84}
+
+// nominal full scale of RESULT_RANGE_VAL at 1x
+#define VL6180X_RANGE_SCALING_NOMINAL_MAX_MM (200)
+
+// auto scaling: scale up above UP% of the current full scale, scale down below
+// DOWN% of the next lower full scale. The gap between both is the hysteresis.
+#define VL6180X_AUTO_SCALING_UP_PERCENT   (90)
+#define VL6180X_AUTO_SCALING_DOWN_PERCENT (75)
+
+//=============================================================================
+//	VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES
+//=============================================================================
+#define VL6180X_REGISTER_SYSRANGE_RANGE_CHECK_ENABLES_MASK_EARLY_CONVERGENCE (0b00000001)
+
+
+//=============================================================================
+//	VL6180X_REGISTER_SYSALS_START
+//=============================================================================
+// same bit layout as SYSRANGE_START
+#define VL6180X_REGISTER_SYSALS_START_VALUE_SINGLE_SHOT            (0b01)
+#define VL6180X_REGISTER_SYSALS_START_VALUE_TOGGLE_CONTINUOUS_MODE (0b11)
+#define VL6180X_REGISTER_SYSALS_START_VALUE_STOP_CONTINUOUS_MODE   (0b01)
+
+
+//=============================================================================
+//	VL6180X_REGISTER_SYSALS_ANALOGUE_GAIN
+//=============================================================================
+// upper nibble is the dark gain and should not be changed (AN4545 - section 9)
+#define VL6180X_REGISTER_SYSALS_ANALOGUE_GAIN_VALUE_DARK_GAIN (0x40)
+#define VL6180X_REGISTER_SYSALS_ANALOGUE_GAIN_MASK_LIGHT_GAIN (0b00000111)
+
+typedef enum
+{
+	VL6180X_ALS_GAIN_20   = 0b000,
+	VL6180X_ALS_GAIN_10   = 0b001,
+	VL6180X_ALS_GAIN_5    = 0b010,
+	VL6180X_ALS_GAIN_2_5  = 0b011,
+	VL6180X_ALS_GAIN_1_67 = 0b100,
+	VL6180X_ALS_GAIN_1_25 = 0b101,
+	VL6180X_ALS_GAIN_1    = 0b110,
+	VL6180X_ALS_GAIN_40   = 0b111,
+}vl6180x_als_gain_enum;
+
+// actual (measured) gain per setting x100 - VL6180X datasheet, table 15
+#define VL6180X_ALS_GAIN_100_TABLE {2000, 1032, 521, 260, 172, 128, 101, 4000}
+
+// lux resolution at gain 1 and 100 ms integration is 0.32 lux/count
+#define VL6180X_ALS_LUX_RESOLUTION_100         (32)
+#define VL6180X_ALS_REFERENCE_INTEGRATION_MS   (100)
+
+// SYSALS_INTEGRATION_PERIOD holds (period_ms - 1) in bits [8:0]
+#define VL6180X_ALS_INTEGRATION_PERIOD_MAX_MS  (512)
+
+
+//=============================================================================
+//	VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE
+//=============================================================================
+#define VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE_VALUE_DISABLE (0x00)
+#define VL6180X_REGISTER_INTERLEAVED_MODE_ENABLE_VALUE_ENABLE  (0x01)
+
+
 //=============================================================================
 //	VL6180X_REGISTER_SYSTEM_INTERRUPT_CLEAR
 //=============================================================================
@@ -134,6 +240,40 @@ typedef enum
 }vl6180x_int_clear_sig_enum;
 
 
+//=============================================================================
+//	VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO
+//=============================================================================
+// range interrupt source, bits [2:0]. The ALS source uses the same values in bits [5:3]
+typedef enum
+{
+	VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_DISABLED         = 0b000,
+	VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_LEVEL_LOW        = 0b001,
+	VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_LEVEL_HIGH       = 0b010,
+	VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_OUT_OF_WINDOW    = 0b011,
+	VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_VALUE_RANGE_NEW_SAMPLE_READY = 0b100,
+}vl6180x_int_config_range_enum;
+#define VL6180X_REGISTER_SYSTEM_INTERRUPT_CONFIG_GPIO_MASK_RANGE (0b00000111)
+
+// threshold modes offered by the driver. IN_WINDOW has no hardware equivalent and is
+// emulated by re-arming LEVEL_LOW/LEVEL_HIGH/OUT_OF_WINDOW after every event, which
+// reports both entering and leaving the window
+typedef enum
+{
+	VL6180X_THRESHOLD_MODE_LEVEL_LOW,
+	VL6180X_THRESHOLD_MODE_LEVEL_HIGH,
+	VL6180X_THRESHOLD_MODE_OUT_OF_WINDOW,
+	VL6180X_THRESHOLD_MODE_IN_WINDOW,
+}vl6180x_threshold_mode_enum;
+
+
+//=============================================================================
+//	VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD
+//=============================================================================
+// while set, threshold and interrupt configuration changes are applied together after the hold is released
+#define VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD_VALUE_HOLD    (0x01)
+#define VL6180X_REGISTER_SYSTEM_GROUPED_PARAMETER_HOLD_VALUE_RELEASE (0x00)
+
+
 //=============================================================================
 //	VL6180X_REGISTER_RESULT_RANGE_STATUS
 //=============================================================================
@@ -144,24 +284,67 @@ typedef enum
 
 typedef enum
 {
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR                   = (0b0000 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_VCSEL_CONTINUITY_TEST      = (0b0001 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_VCSEL_WATCHDOG_TEST        = (0b0010 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_VCSEL_WATCHDOG             = (0b0011 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_PLL1_LOCK                  = (0b0100 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_PLL2_LOCK                  = (0b0101 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_EARLY_CONVERGENCE_ESTIMATE = (0b0110 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_MAX_CONVERGENCE            = (0b0111 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_TARGET_IGNORE           = (0b1000 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Max_SNR                    = (0b1011 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Underflow = (0b1100 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Overflow  = (0b1101 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Underflow     = (0b1110 << 3),
-	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Overflow      = (0b1111 << 3),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_ERROR                   = (0b0000 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_VCSEL_CONTINUITY_TEST      = (0b0001 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_VCSEL_WATCHDOG_TEST        = (0b0010 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_VCSEL_WATCHDOG             = (0b0011 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_PLL1_LOCK                  = (0b0100 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_PLL2_LOCK                  = (0b0101 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_EARLY_CONVERGENCE_ESTIMATE = (0b0110 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_MAX_CONVERGENCE            = (0b0111 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_NO_TARGET_IGNORE           = (0b1000 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Max_SNR                    = (0b1011 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Underflow = (0b1100 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Raw_Ranging_Algo_Overflow  = (0b1101 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Underflow     = (0b1110 << 4),
+	VL6180X_REGISTER_RESULT_RANGE_STATUS_VALUE_ERROR_Ranging_Algo_Overflow      = (0b1111 << 4),
 }vl6180x_result_range_error_code_enum;
 
 #define VL6180X_REGISTER_RESULT_RANGE_STATUS_MASK_ERROR_CODE (0b11110000)
 
+// error codes grouped by what they mean for the sample
+typedef enum
+{
+	VL6180X_RANGE_ERROR_NONE,
+	VL6180X_RANGE_ERROR_SYSTEM,             // VCSEL continuity/watchdog, PLL lock: hardware fault
+	VL6180X_RANGE_ERROR_EARLY_CONVERGENCE,  // ECE: return signal too low at the early estimate
+	VL6180X_RANGE_ERROR_NO_CONVERGENCE,     // MAX_CONVERGENCE_TIME reached
+	VL6180X_RANGE_ERROR_RANGE_IGNORE,       // below range ignore threshold, no target
+	VL6180X_RANGE_ERROR_SNR,                // ambient too high compared to signal
+	VL6180X_RANGE_ERROR_UNDERFLOW,          // target closer than the offset / too close
+	VL6180X_RANGE_ERROR_OVERFLOW,           // target beyond the current scale
+}vl6180x_range_error_enum;
+
+#define VL6180X_RANGE_CONFIDENCE_MAX (255)
+
+
+//=============================================================================
+//	quality burst: RESULT_RANGE_VAL (0x062) up to and including RESULT_RANGE_REFERENCE_CONV_TIME (0x083)
+//=============================================================================
+#define VL6180X_QUALITY_BURST_LENGTH                         (VL6180X_REGISTER_RESULT_RANGE_REFERENCE_CONV_TIME + 4 - VL6180X_REGISTER_RESULT_RANGE_VAL)
+#define VL6180X_QUALITY_BURST_OFFSET(register_address)       ((register_address) - VL6180X_REGISTER_RESULT_RANGE_VAL)
+
+// RESULT_RANGE_RETURN_RATE / REFERENCE_RATE are 9.7 fixed-point MCPS
+#define VL6180X_RANGE_RATE_FRACTIONAL_BITS (7)
+
+
+//=============================================================================
+//	VL6180X_REGISTER_RESULT_ALS_STATUS
+//=============================================================================
+#define VL6180X_REGISTER_RESULT_ALS_STATUS_MASK_DEVICE_READY (0b00000001)
+#define VL6180X_REGISTER_RESULT_ALS_STATUS_MASK_ERROR_CODE   (0b11110000)
+
+
+//=============================================================================
+//	result burst: RESULT_RANGE_STATUS (0x04D) up to and including RESULT_RANGE_VAL (0x062)
+//=============================================================================
+#define VL6180X_RESULT_BURST_LENGTH                  (VL6180X_REGISTER_RESULT_RANGE_VAL - VL6180X_REGISTER_RESULT_RANGE_STATUS + 1)
+#define VL6180X_RESULT_BURST_OFFSET_RANGE_STATUS     (0)
+#define VL6180X_RESULT_BURST_OFFSET_ALS_STATUS       (VL6180X_REGISTER_RESULT_ALS_STATUS - VL6180X_REGISTER_RESULT_RANGE_STATUS)
+#define VL6180X_RESULT_BURST_OFFSET_INTERRUPT_STATUS (VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO - VL6180X_REGISTER_RESULT_RANGE_STATUS)
+#define VL6180X_RESULT_BURST_OFFSET_ALS_VAL          (VL6180X_REGISTER_RESULT_ALS_VAL - VL6180X_REGISTER_RESULT_RANGE_STATUS)
+#define VL6180X_RESULT_BURST_OFFSET_RANGE_VAL        (VL6180X_REGISTER_RESULT_RANGE_VAL - VL6180X_REGISTER_RESULT_RANGE_STATUS)
+
 //=============================================================================
 //	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO
 //=============================================================================
@@ -177,19 +360,19 @@ typedef enum
 
 typedef enum
 {
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_NO_EVENTS               = (0b000 << 2),
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_LOW_LEVEL_THRESHOLD     = (0b001 << 2),
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_HIGH_LEVEL_THRESHOLD    = (0b010 << 2),
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_OUT_OF_WINDOW_THRESHOLD = (0b011 << 2),
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_NEW_SAMPLE_READY        = (0b100 << 2),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_NO_EVENTS               = (0b000 << 3),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_LOW_LEVEL_THRESHOLD     = (0b001 << 3),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_HIGH_LEVEL_THRESHOLD    = (0b010 << 3),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_OUT_OF_WINDOW_THRESHOLD = (0b011 << 3),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ALS_NEW_SAMPLE_READY        = (0b100 << 3),
 }vl6180x_result_int_als_gpio_enum;
 #define VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_ALS (0b00111000)
 
 typedef enum
 {
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_NO_ERROR           = (0b00 << 5),
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_LASER_SAFETY_ERROR = (0b01 << 5),
-	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_PLL_ERROR          = (0b00 << 5),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_NO_ERROR           = (0b00 << 6),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_LASER_SAFETY_ERROR = (0b01 << 6),
+	VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_VALUE_ERROR_PLL_ERROR          = (0b10 << 6),
 }vl6180x_result_int_error_gpio_enum;
 #define VL6180X_REGISTER_RESULT_INTERRUPT_STATUS_GPIO_MASK_ERROR (0b11000000)
 
@@ -0,0 +1,66 @@
+/*
+ * hal_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef HAL_SIM_H_
+#define HAL_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "i2c.h"
+#include "usart.h"
+
+//=============================================================================
+//	simulated HAL
+//=============================================================================
+// Host replacement for the HAL calls made by Sensors/: I2C memory transfers,
+// USART2 transmit and the millisecond tick. The tick is virtual, HAL_Delay()
+// advances it without sleeping, so host runs are fast and repeatable.
+//
+// I2C devices are callbacks keyed by their (shifted) bus address, a transfer
+// to an address without a device fails like a NACK. Like on the bus, only the
+// low byte of the register address reaches the device for I2C_MEMADD_SIZE_8BIT.
+// hal_sim_bmp280 and hal_sim_vl6180x are register models of the two sensors.
+
+#define HAL_SIM_I2C_MAX_DEVICES		(4)
+
+typedef HAL_StatusTypeDef (hal_sim_i2c_read_function)(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+typedef HAL_StatusTypeDef (hal_sim_i2c_write_function)(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length);
+
+bool hal_sim_i2c_attach(uint16_t device_address, hal_sim_i2c_read_function *read_fn, hal_sim_i2c_write_function *write_fn);
+void hal_sim_i2c_detach_all();
+
+void hal_sim_uart_set_output(FILE *output);
+void hal_sim_advance_ms(uint32_t ms);
+
+//=============================================================================
+//	BMP280 model
+//=============================================================================
+// Trimming parameters of BMP280 datasheet 3.12, the data registers return
+// the set ADC values (default the datasheet example 519888 / 415148).
+// Conversions complete immediately, the status register is always idle.
+// In normal mode every conversion (at measurement time + t_standby) flips
+// the pressure LSB, so consecutive samples differ like with sensor noise.
+
+bool hal_sim_bmp280_attach(uint16_t device_address);
+void hal_sim_bmp280_set_adc(uint32_t adc_T, uint32_t adc_P);
+
+//=============================================================================
+//	VL6180X model
+//=============================================================================
+// 16 bit register map, every write is kept at its full address so the
+// private registers above 0xFF (AN4545 SR03 settings) can be read back.
+// Identification and fresh-out-of-reset as after power-up, SYSRANGE_START
+// single shots complete immediately, continuous mode delivers samples at
+// the SYSRANGE_INTERMEASUREMENT_PERIOD on the simulated tick. The range
+// interrupt is raised per sample and cleared by SYSTEM_INTERRUPT_CLEAR.
+
+bool hal_sim_vl6180x_attach(uint16_t device_address);
+void hal_sim_vl6180x_set_range(uint8_t raw_range, uint8_t error_code);
+
+#endif /* HAL_SIM_H_ */
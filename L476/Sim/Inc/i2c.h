@@ -0,0 +1,29 @@
+/*
+ * i2c.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Simulated I2C for host builds, stands in for Core/Inc/i2c.h. Transfers go
+ *  to the device models attached with hal_sim_i2c_attach().
+ */
+
+#ifndef __I2C_H__
+#define __I2C_H__
+
+#include "main.h"
+
+#define I2C_MEMADD_SIZE_8BIT	0x00000001U
+#define I2C_MEMADD_SIZE_16BIT	0x00000002U
+
+typedef struct
+{
+	uint32_t ErrorCode;
+}I2C_HandleTypeDef;
+
+extern I2C_HandleTypeDef hi2c3;
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+#endif /* __I2C_H__ */
@@ -0,0 +1,43 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Simulated HAL for host builds: the subset of the STM32L4 HAL the Sensors/
+ *  code uses, see hal_sim.h. Stands in for Core/Inc/main.h.
+ */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+	HAL_OK       = 0x00U,
+	HAL_ERROR    = 0x01U,
+	HAL_BUSY     = 0x02U,
+	HAL_TIMEOUT  = 0x03U,
+}HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY		0xFFFFFFFFU
+
+// only as device description (chip select of sensor_spi), no pin is driven
+typedef struct
+{
+	uint32_t ODR;
+}GPIO_TypeDef;
+
+extern GPIO_TypeDef hal_sim_gpiob;
+
+#define GPIOB				(&hal_sim_gpiob)
+#define GPIO_PIN_12			((uint16_t)0x1000)
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+void Error_Handler(void);
+
+#endif /* __MAIN_H */
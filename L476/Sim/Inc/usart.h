@@ -0,0 +1,25 @@
+/*
+ * usart.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Simulated USART2 for host builds, stands in for Core/Inc/usart.h. The
+ *  output goes to stdout or wherever hal_sim_uart_set_output() points it.
+ */
+
+#ifndef __USART_H__
+#define __USART_H__
+
+#include "main.h"
+
+typedef struct
+{
+	uint32_t ErrorCode;
+}UART_HandleTypeDef;
+
+extern UART_HandleTypeDef huart2;
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+#endif /* __USART_H__ */
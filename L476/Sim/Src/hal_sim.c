@@ -0,0 +1,176 @@
+/*
+ * hal_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <stdlib.h>
+
+#include "hal_sim.h"
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	uint16_t device_address;
+	hal_sim_i2c_read_function *read;
+	hal_sim_i2c_write_function *write;
+}hal_sim_i2c_device_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static const hal_sim_i2c_device_struct *hal_sim_i2c_find(uint16_t device_address, uint16_t memory_address_size);
+static uint16_t hal_sim_i2c_bus_address(uint16_t memory_address, uint16_t memory_address_size);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+I2C_HandleTypeDef hi2c3;
+UART_HandleTypeDef huart2;
+GPIO_TypeDef hal_sim_gpiob;
+
+static hal_sim_i2c_device_struct hal_sim_i2c_devices[HAL_SIM_I2C_MAX_DEVICES];
+static uint8_t hal_sim_i2c_device_count = 0;
+
+static FILE *hal_sim_uart_output = NULL;
+static bool hal_sim_is_uart_output_set = false;
+static uint32_t hal_sim_tick_ms = 0;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool hal_sim_i2c_attach(uint16_t device_address, hal_sim_i2c_read_function *read_fn, hal_sim_i2c_write_function *write_fn)
+{
+	bool result = (hal_sim_i2c_device_count < HAL_SIM_I2C_MAX_DEVICES && read_fn != NULL && write_fn != NULL);
+
+	if (result == true)
+	{
+		hal_sim_i2c_devices[hal_sim_i2c_device_count++] = (hal_sim_i2c_device_struct){device_address, read_fn, write_fn};
+	}
+
+	return result;
+}
+
+
+void hal_sim_i2c_detach_all()
+{
+	hal_sim_i2c_device_count = 0;
+}
+
+
+/******************************************************************************
+ * @brief NULL discards the UART output, the default is stdout
+*/
+void hal_sim_uart_set_output(FILE *output)
+{
+	hal_sim_uart_output = output;
+	hal_sim_is_uart_output_set = true;
+}
+
+
+void hal_sim_advance_ms(uint32_t ms)
+{
+	hal_sim_tick_ms += ms;
+}
+
+
+//=============================================================================
+//	HAL functions
+//=============================================================================
+
+uint32_t HAL_GetTick(void)
+{
+	return hal_sim_tick_ms;
+}
+
+
+void HAL_Delay(uint32_t Delay)
+{
+	hal_sim_tick_ms += Delay;
+}
+
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "Error_Handler()\n");
+	abort();
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	const hal_sim_i2c_device_struct *device = hal_sim_i2c_find(DevAddress, MemAddSize);
+
+	(void)hi2c;
+	(void)Timeout;
+
+	return (device != NULL && pData != NULL) ? device->read(hal_sim_i2c_bus_address(MemAddress, MemAddSize), pData, Size) : HAL_ERROR;
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	const hal_sim_i2c_device_struct *device = hal_sim_i2c_find(DevAddress, MemAddSize);
+
+	(void)hi2c;
+	(void)Timeout;
+
+	return (device != NULL && pData != NULL) ? device->write(hal_sim_i2c_bus_address(MemAddress, MemAddSize), pData, Size) : HAL_ERROR;
+}
+
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	FILE *output = (hal_sim_is_uart_output_set == true) ? hal_sim_uart_output : stdout;
+
+	(void)huart;
+	(void)Timeout;
+
+	if (output != NULL)
+	{
+		fwrite(pData, 1, Size, output);
+	}
+
+	return HAL_OK;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static const hal_sim_i2c_device_struct *hal_sim_i2c_find(uint16_t device_address, uint16_t memory_address_size)
+{
+	const hal_sim_i2c_device_struct *device = NULL;
+
+	if (memory_address_size == I2C_MEMADD_SIZE_8BIT || memory_address_size == I2C_MEMADD_SIZE_16BIT)
+	{
+		for (uint8_t n = 0; n < hal_sim_i2c_device_count && device == NULL; n++)
+		{
+			if (hal_sim_i2c_devices[n].device_address == device_address)
+			{
+				device = &hal_sim_i2c_devices[n];
+			}
+		}
+	}
+
+	return device;
+}
+
+
+/******************************************************************************
+ * @brief register address as the device receives it, one address byte for
+ * 		  I2C_MEMADD_SIZE_8BIT
+*/
+static uint16_t hal_sim_i2c_bus_address(uint16_t memory_address, uint16_t memory_address_size)
+{
+	return (memory_address_size == I2C_MEMADD_SIZE_8BIT) ? (memory_address & 0xFF) : memory_address;
+}
@@ -0,0 +1,167 @@
+/*
+ * hal_sim_bmp280.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <string.h>
+
+#include "hal_sim.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+#define HAL_SIM_BMP280_ID				(0x58)
+#define HAL_SIM_BMP280_CALIBRATION		(0x88)
+#define HAL_SIM_BMP280_ID_REGISTER		(0xD0)
+#define HAL_SIM_BMP280_RESET			(0xE0)
+#define HAL_SIM_BMP280_CTRL_MEAS		(0xF4)
+#define HAL_SIM_BMP280_CONFIG			(0xF5)
+#define HAL_SIM_BMP280_DATA				(0xF7)
+#define HAL_SIM_BMP280_PRESS_XLSB		(0xF9)
+
+#define HAL_SIM_BMP280_MODE_NORMAL		(0x03)
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static HAL_StatusTypeDef hal_sim_bmp280_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef hal_sim_bmp280_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length);
+static void hal_sim_bmp280_reset();
+static uint32_t hal_sim_bmp280_get_period_us();
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static uint8_t hal_sim_bmp280_registers[256];
+
+// start of normal mode, conversions are counted from here
+static uint32_t hal_sim_bmp280_normal_start_ms;
+
+// dig_T1..dig_P9 little endian, BMP280 datasheet 3.12
+static const uint16_t hal_sim_bmp280_trimming[12] =
+{
+	27504, 26435, (uint16_t)-1000, 36477, (uint16_t)-10685, 3024, 2855, 140, (uint16_t)-7, 15500, (uint16_t)-14600, 6000,
+};
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool hal_sim_bmp280_attach(uint16_t device_address)
+{
+	hal_sim_bmp280_reset();
+
+	return hal_sim_i2c_attach(device_address, &hal_sim_bmp280_read, &hal_sim_bmp280_write);
+}
+
+
+/******************************************************************************
+ * @brief 20 bit ADC values, msb/lsb/xlsb as the sensor presents them
+*/
+void hal_sim_bmp280_set_adc(uint32_t adc_T, uint32_t adc_P)
+{
+	uint8_t *data = &hal_sim_bmp280_registers[HAL_SIM_BMP280_DATA];
+
+	data[0] = (uint8_t)(adc_P >> 12);
+	data[1] = (uint8_t)(adc_P >> 4);
+	data[2] = (uint8_t)(adc_P << 4);
+	data[3] = (uint8_t)(adc_T >> 12);
+	data[4] = (uint8_t)(adc_T >> 4);
+	data[5] = (uint8_t)(adc_T << 4);
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static HAL_StatusTypeDef hal_sim_bmp280_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	HAL_StatusTypeDef result = (memory_address + data_length <= sizeof(hal_sim_bmp280_registers)) ? HAL_OK : HAL_ERROR;
+
+	if (result == HAL_OK)
+	{
+		memcpy(data_buffer, &hal_sim_bmp280_registers[memory_address], data_length);
+	}
+
+	// normal mode: every conversion flips the pressure LSB like sensor noise,
+	// the driver tells a new sample from the data registers changing
+	if (result == HAL_OK && (hal_sim_bmp280_registers[HAL_SIM_BMP280_CTRL_MEAS] & 0x03) == HAL_SIM_BMP280_MODE_NORMAL &&
+		memory_address <= HAL_SIM_BMP280_PRESS_XLSB && memory_address + data_length > HAL_SIM_BMP280_PRESS_XLSB)
+	{
+		uint32_t conversion = (uint32_t)(((uint64_t)(HAL_GetTick() - hal_sim_bmp280_normal_start_ms) * 1000) / hal_sim_bmp280_get_period_us());
+
+		data_buffer[HAL_SIM_BMP280_PRESS_XLSB - memory_address] ^= (uint8_t)((conversion & 1) << 4);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief only control registers are writable, 0xB6 to the reset register
+ * 		  restores the power-on state
+*/
+static HAL_StatusTypeDef hal_sim_bmp280_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length)
+{
+	HAL_StatusTypeDef result = (memory_address >= HAL_SIM_BMP280_RESET && memory_address + data_length <= HAL_SIM_BMP280_DATA) ? HAL_OK : HAL_ERROR;
+
+	if (result == HAL_OK && memory_address == HAL_SIM_BMP280_RESET)
+	{
+		if (data_buffer[0] == 0xB6)
+		{
+			hal_sim_bmp280_reset();
+		}
+	}
+	else if (result == HAL_OK)
+	{
+		bool was_normal = (hal_sim_bmp280_registers[HAL_SIM_BMP280_CTRL_MEAS] & 0x03) == HAL_SIM_BMP280_MODE_NORMAL;
+
+		memcpy(&hal_sim_bmp280_registers[memory_address], data_buffer, data_length);
+		if (was_normal == false && (hal_sim_bmp280_registers[HAL_SIM_BMP280_CTRL_MEAS] & 0x03) == HAL_SIM_BMP280_MODE_NORMAL)
+		{
+			hal_sim_bmp280_normal_start_ms = HAL_GetTick();
+		}
+	}
+
+	return result;
+}
+
+
+static void hal_sim_bmp280_reset()
+{
+	memset(hal_sim_bmp280_registers, 0, sizeof(hal_sim_bmp280_registers));
+
+	for (uint8_t n = 0; n < sizeof(hal_sim_bmp280_trimming) / sizeof(hal_sim_bmp280_trimming[0]); n++)
+	{
+		hal_sim_bmp280_registers[HAL_SIM_BMP280_CALIBRATION + n * 2] = (uint8_t)(hal_sim_bmp280_trimming[n]);
+		hal_sim_bmp280_registers[HAL_SIM_BMP280_CALIBRATION + n * 2 + 1] = (uint8_t)(hal_sim_bmp280_trimming[n] >> 8);
+	}
+	hal_sim_bmp280_registers[HAL_SIM_BMP280_ID_REGISTER] = HAL_SIM_BMP280_ID;
+	hal_sim_bmp280_set_adc(519888, 415148);
+}
+
+
+/******************************************************************************
+ * @brief normal mode period, measurement time (BMP280 datasheet 9.1, typical)
+ * 		  and t_standby (datasheet 3.6.3)
+*/
+static uint32_t hal_sim_bmp280_get_period_us()
+{
+	static const uint32_t standby_us[8] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+	uint8_t control = hal_sim_bmp280_registers[HAL_SIM_BMP280_CTRL_MEAS];
+	uint8_t osrs_t = (control >> 5) & 0x07;
+	uint8_t osrs_p = (control >> 2) & 0x07;
+	uint32_t measurement_us = 1000;
+
+	measurement_us += (osrs_t == 0) ? 0 : 2000 << ((osrs_t > 5 ? 5 : osrs_t) - 1);
+	measurement_us += (osrs_p == 0) ? 0 : (2000 << ((osrs_p > 5 ? 5 : osrs_p) - 1)) + 500;
+
+	return measurement_us + standby_us[hal_sim_bmp280_registers[HAL_SIM_BMP280_CONFIG] >> 5];
+}
@@ -0,0 +1,94 @@
+/*
+ * hal_sim_clock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  sensor_clock.c reconfigures the RCC, the regulator and the flash wait
+ *  states, which have no host model. This stands in for it: the profiles
+ *  are listed with their SYSCLK and run current, the host stays in BOOST
+ *  (as after SystemClock_Config()) and rejects every switch.
+ */
+
+#include <strings.h>
+
+#include "hal_sim.h"
+
+#include "common/sensor_clock.h"
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// names, SYSCLK and run current as in sensor_clock.c
+static const sensor_clock_stats_struct hal_sim_clock_profiles[SENSOR_CLOCK_PROFILE_COUNT] =
+{
+	[SENSOR_CLOCK_PROFILE_BOOST]     = {.name = "boost",    .sysclk_hz = 80000000, .current_uA = 10200},
+	[SENSOR_CLOCK_PROFILE_RUN]       = {.name = "run",      .sysclk_hz = 24000000, .current_uA = 2600},
+	[SENSOR_CLOCK_PROFILE_LOW_POWER] = {.name = "lowpower", .sysclk_hz = 2000000,  .current_uA = 250},
+};
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool sensor_clock_set_profile(sensor_clock_profile_enum profile)
+{
+	return (profile == SENSOR_CLOCK_PROFILE_BOOST);
+}
+
+
+sensor_clock_profile_enum sensor_clock_get_profile()
+{
+	return SENSOR_CLOCK_PROFILE_BOOST;
+}
+
+
+bool sensor_clock_find_profile(const char *name, sensor_clock_profile_enum *profile)
+{
+	bool result = false;
+
+	for (uint8_t n = 0; n < SENSOR_CLOCK_PROFILE_COUNT && result == false; n++)
+	{
+		if (strcasecmp(name, hal_sim_clock_profiles[n].name) == 0)
+		{
+			*profile = (sensor_clock_profile_enum)n;
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+
+bool sensor_clock_get_stats(sensor_clock_profile_enum profile, sensor_clock_stats_struct *stats)
+{
+	bool result = (profile < SENSOR_CLOCK_PROFILE_COUNT);
+
+	if (result == true)
+	{
+		*stats = hal_sim_clock_profiles[profile];
+		stats->residency_ms = (profile == SENSOR_CLOCK_PROFILE_BOOST) ? HAL_GetTick() : 0;
+	}
+
+	return result;
+}
+
+
+uint32_t sensor_clock_get_average_current_uA()
+{
+	return hal_sim_clock_profiles[SENSOR_CLOCK_PROFILE_BOOST].current_uA;
+}
+
+
+/******************************************************************************
+ * @brief the simulated I2C bus has no timing register
+*/
+uint32_t sensor_clock_get_i2c_timing(uint32_t i2c_clock_hz)
+{
+	(void)i2c_clock_hz;
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * hal_sim_console_uart.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  console_uart.c programs the USART2 divider, auto baud detection and the
+ *  RX interrupt through the CMSIS registers, which have no host model. This
+ *  stands in for it: the console answers through HAL_UART_Transmit() (see
+ *  hal_sim_uart_set_output()), received bytes are handed to
+ *  console_receive_byte() by the host program. The line rate is fixed.
+ */
+
+#include "hal_sim.h"
+
+#include "console/console_uart.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void hal_sim_console_uart_write(const char *text, uint16_t length);
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool console_uart_initialize(const console_command_struct *commands, uint8_t command_count)
+{
+	console_initialize(commands, command_count, &hal_sim_console_uart_write);
+
+	return true;
+}
+
+
+bool console_uart_set_baud(uint32_t baud)
+{
+	return (baud == CONSOLE_UART_DEFAULT_BAUD);
+}
+
+
+bool console_uart_auto_baud()
+{
+	return false;
+}
+
+
+bool console_uart_reconfigure()
+{
+	return true;
+}
+
+
+uint32_t console_uart_get_baud()
+{
+	return CONSOLE_UART_DEFAULT_BAUD;
+}
+
+
+uint8_t console_uart_get_oversampling()
+{
+	return 16;
+}
+
+
+int32_t console_uart_get_baud_error_ppm(uint32_t baud, uint8_t *oversampling)
+{
+	(void)baud;
+
+	*oversampling = 16;
+	return 0;
+}
+
+
+/******************************************************************************
+ * @brief there is no loopback on the host, no rate is tested
+*/
+uint8_t console_uart_self_test(console_uart_test_struct *results, uint8_t max_count)
+{
+	(void)results;
+	(void)max_count;
+
+	return 0;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static void hal_sim_console_uart_write(const char *text, uint16_t length)
+{
+	HAL_UART_Transmit(&huart2, (const uint8_t *)text, length, HAL_MAX_DELAY);
+}
@@ -0,0 +1,55 @@
+/*
+ * hal_sim_memory.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  sensor_memory.c reads FLASH_ACR and the linker symbols of the stack and
+ *  heap, which have no host model. This stands in for it: the accelerator
+ *  setting is only kept, every address is in "host" memory and no stack or
+ *  heap usage is reported.
+ */
+
+#include "common/sensor_memory.h"
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static sensor_memory_accelerator_struct hal_sim_memory_accelerator = {true, true, true};
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+void sensor_memory_set_accelerator(const sensor_memory_accelerator_struct *accelerator)
+{
+	hal_sim_memory_accelerator = *accelerator;
+}
+
+
+void sensor_memory_get_accelerator(sensor_memory_accelerator_struct *accelerator)
+{
+	*accelerator = hal_sim_memory_accelerator;
+}
+
+
+const char *sensor_memory_get_region(const void *address)
+{
+	(void)address;
+
+	return "host";
+}
+
+
+void sensor_memory_get_usage(sensor_memory_usage_struct *usage)
+{
+	*usage = (sensor_memory_usage_struct){0};
+}
+
+
+bool sensor_memory_check_headroom()
+{
+	return true;
+}
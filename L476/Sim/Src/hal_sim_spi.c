@@ -0,0 +1,52 @@
+/*
+ * hal_sim_spi.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  sensor_spi.c drives SPI2 and its DMA channels through the CMSIS registers,
+ *  which have no host model. This stands in for it: no device answers on the
+ *  simulated SPI bus, every call fails like a missing sensor.
+ */
+
+#include "common/sensor_spi.h"
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool sensor_spi_initialize()
+{
+	return false;
+}
+
+
+bool sensor_spi_initialize_device(const sensor_spi_device_struct *device)
+{
+	(void)device;
+
+	return false;
+}
+
+
+bool sensor_spi_read_registers(const sensor_spi_device_struct *device, const uint8_t register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	(void)device;
+	(void)register_address;
+	(void)data_buffer;
+	(void)data_length;
+
+	return false;
+}
+
+
+bool sensor_spi_write_registers(const sensor_spi_device_struct *device, const uint8_t register_address, uint8_t *data_buffer, const uint16_t data_length)
+{
+	(void)device;
+	(void)register_address;
+	(void)data_buffer;
+	(void)data_length;
+
+	return false;
+}
@@ -0,0 +1,199 @@
+/*
+ * hal_sim_vl6180x.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <string.h>
+
+#include "hal_sim.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+#define HAL_SIM_VL6180X_REGISTER_COUNT		(0x300)		// last register is INTERLEAVED_MODE_ENABLE 0x2A3
+
+#define HAL_SIM_VL6180X_MODEL_ID			(0x000)
+#define HAL_SIM_VL6180X_INTERRUPT_CLEAR		(0x015)
+#define HAL_SIM_VL6180X_FRESH_OUT_OF_RESET	(0x016)
+#define HAL_SIM_VL6180X_SYSRANGE_START		(0x018)
+#define HAL_SIM_VL6180X_INTERMEASUREMENT	(0x01B)
+#define HAL_SIM_VL6180X_CROSSTALK_HEIGHT	(0x021)
+#define HAL_SIM_VL6180X_RANGE_STATUS		(0x04D)
+#define HAL_SIM_VL6180X_INTERRUPT_STATUS	(0x04F)
+#define HAL_SIM_VL6180X_RANGE_VAL			(0x062)
+
+#define HAL_SIM_VL6180X_MODEL_ID_VALUE		(0xB4)
+#define HAL_SIM_VL6180X_DEVICE_READY		(0x01)
+#define HAL_SIM_VL6180X_NEW_SAMPLE_READY	(0x04)
+#define HAL_SIM_VL6180X_INTERRUPT_RANGE		(0x07)
+
+// continuous mode: the device is busy (not ready) this long before each sample
+#define HAL_SIM_VL6180X_MEASUREMENT_MS		(5)
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static HAL_StatusTypeDef hal_sim_vl6180x_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef hal_sim_vl6180x_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length);
+static void hal_sim_vl6180x_start(uint8_t value);
+static void hal_sim_vl6180x_update();
+static void hal_sim_vl6180x_latch_sample();
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static uint8_t hal_sim_vl6180x_registers[HAL_SIM_VL6180X_REGISTER_COUNT];
+
+static uint8_t hal_sim_vl6180x_raw_range = 100;
+static uint8_t hal_sim_vl6180x_error_code = 0;
+
+static bool hal_sim_vl6180x_is_continuous = false;
+static uint32_t hal_sim_vl6180x_next_sample_ms;
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool hal_sim_vl6180x_attach(uint16_t device_address)
+{
+	memset(hal_sim_vl6180x_registers, 0, sizeof(hal_sim_vl6180x_registers));
+
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_MODEL_ID] = HAL_SIM_VL6180X_MODEL_ID_VALUE;
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_FRESH_OUT_OF_RESET] = 0x01;
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_INTERMEASUREMENT] = 0xFF;
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_CROSSTALK_HEIGHT] = 0x14;
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_RANGE_STATUS] = HAL_SIM_VL6180X_DEVICE_READY;
+	hal_sim_vl6180x_is_continuous = false;
+
+	return hal_sim_i2c_attach(device_address, &hal_sim_vl6180x_read, &hal_sim_vl6180x_write);
+}
+
+
+/******************************************************************************
+ * @brief RESULT_RANGE_VAL and the RESULT_RANGE_STATUS error code (bits 7:4)
+ * 		  of the following samples
+*/
+void hal_sim_vl6180x_set_range(uint8_t raw_range, uint8_t error_code)
+{
+	hal_sim_vl6180x_raw_range = raw_range;
+	hal_sim_vl6180x_error_code = error_code;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static HAL_StatusTypeDef hal_sim_vl6180x_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	HAL_StatusTypeDef result = (memory_address + data_length <= sizeof(hal_sim_vl6180x_registers)) ? HAL_OK : HAL_ERROR;
+
+	if (result == HAL_OK)
+	{
+		hal_sim_vl6180x_update();
+		memcpy(data_buffer, &hal_sim_vl6180x_registers[memory_address], data_length);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief every register is stored at its full 16 bit address, SYSRANGE_START
+ * 		  and SYSTEM_INTERRUPT_CLEAR act instead of being stored
+*/
+static HAL_StatusTypeDef hal_sim_vl6180x_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length)
+{
+	HAL_StatusTypeDef result = (memory_address + data_length <= sizeof(hal_sim_vl6180x_registers)) ? HAL_OK : HAL_ERROR;
+
+	if (result == HAL_OK && memory_address == HAL_SIM_VL6180X_SYSRANGE_START)
+	{
+		hal_sim_vl6180x_start(data_buffer[0]);
+	}
+	else if (result == HAL_OK && memory_address == HAL_SIM_VL6180X_INTERRUPT_CLEAR)
+	{
+		if ((data_buffer[0] & 0x01) != 0)
+		{
+			hal_sim_vl6180x_registers[HAL_SIM_VL6180X_INTERRUPT_STATUS] &= ~HAL_SIM_VL6180X_INTERRUPT_RANGE;
+		}
+	}
+	else if (result == HAL_OK)
+	{
+		memcpy(&hal_sim_vl6180x_registers[memory_address], data_buffer, data_length);
+	}
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief bit 0 starts a single shot or halts continuous mode, with bit 1 it
+ * 		  toggles continuous mode.
+ * 		  A single shot completes immediately, continuous samples follow
+ * 		  the SYSRANGE_INTERMEASUREMENT_PERIOD on the simulated tick.
+*/
+static void hal_sim_vl6180x_start(uint8_t value)
+{
+	if ((value & 0x01) == 0)
+	{
+		// nothing to start
+	}
+	else if ((value & 0x02) == 0 && hal_sim_vl6180x_is_continuous == true)
+	{
+		// AN4545 2.1: 0x01 halts continuous mode
+		hal_sim_vl6180x_is_continuous = false;
+	}
+	else if ((value & 0x02) == 0)
+	{
+		hal_sim_vl6180x_latch_sample();
+	}
+	else
+	{
+		hal_sim_vl6180x_is_continuous = !hal_sim_vl6180x_is_continuous;
+		hal_sim_vl6180x_next_sample_ms = HAL_GetTick() + (hal_sim_vl6180x_registers[HAL_SIM_VL6180X_INTERMEASUREMENT] + 1) * 10;
+	}
+
+	hal_sim_vl6180x_update();
+}
+
+
+/******************************************************************************
+ * @brief latches due continuous samples and updates device ready, which is
+ * 		  cleared while a continuous measurement is in progress
+*/
+static void hal_sim_vl6180x_update()
+{
+	uint32_t period_ms = (hal_sim_vl6180x_registers[HAL_SIM_VL6180X_INTERMEASUREMENT] + 1) * 10;
+	bool is_measuring = false;
+
+	if (hal_sim_vl6180x_is_continuous == true && (int32_t)(HAL_GetTick() - hal_sim_vl6180x_next_sample_ms) >= 0)
+	{
+		hal_sim_vl6180x_latch_sample();
+		hal_sim_vl6180x_next_sample_ms += period_ms * ((HAL_GetTick() - hal_sim_vl6180x_next_sample_ms) / period_ms + 1);
+	}
+
+	if (hal_sim_vl6180x_is_continuous == true)
+	{
+		is_measuring = (hal_sim_vl6180x_next_sample_ms - HAL_GetTick() <= HAL_SIM_VL6180X_MEASUREMENT_MS);
+	}
+
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_RANGE_STATUS] &= ~HAL_SIM_VL6180X_DEVICE_READY;
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_RANGE_STATUS] |= (is_measuring == true) ? 0 : HAL_SIM_VL6180X_DEVICE_READY;
+}
+
+
+static void hal_sim_vl6180x_latch_sample()
+{
+	uint8_t *status = &hal_sim_vl6180x_registers[HAL_SIM_VL6180X_RANGE_STATUS];
+	uint8_t *interrupt_status = &hal_sim_vl6180x_registers[HAL_SIM_VL6180X_INTERRUPT_STATUS];
+
+	*status = (uint8_t)(hal_sim_vl6180x_error_code << 4) | (*status & HAL_SIM_VL6180X_DEVICE_READY);
+	*interrupt_status = (*interrupt_status & ~HAL_SIM_VL6180X_INTERRUPT_RANGE) | HAL_SIM_VL6180X_NEW_SAMPLE_READY;
+	hal_sim_vl6180x_registers[HAL_SIM_VL6180X_RANGE_VAL] = hal_sim_vl6180x_raw_range;
+}
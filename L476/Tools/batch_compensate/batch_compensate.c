@@ -0,0 +1,422 @@
+/*
+ * batch_compensate.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCH_COMPENSATE_X86	(1)
+#else
+#define BATCH_COMPENSATE_X86	(0)
+#endif
+
+#include "batch_compensate.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+
+// chunk boundaries stay multiples of the AVX2 lane count
+#define BATCH_COMPENSATE_LANES		(8)
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	pthread_t thread;
+	uint32_t start;
+	uint32_t end;
+	const uint8_t *bursts;
+	const void *parameters;		// coefficients or configuration
+	void *batch;
+	bool is_avx2;
+}batch_compensate_worker_struct;
+
+typedef void *(batch_compensate_worker_function)(void *worker);
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static bool batch_compensate_run(batch_compensate_worker_function *function, const void *parameters, void *batch, uint32_t count,
+								 const uint8_t *bursts, uint32_t thread_count, bool is_avx2);
+static void *batch_compensate_bmp280_worker(void *worker);
+static void batch_compensate_bmp280_temperature(const batch_compensate_bmp280_coefficients_struct *c, batch_compensate_bmp280_struct *batch,
+												uint32_t start, uint32_t end);
+#if BATCH_COMPENSATE_X86
+static void batch_compensate_bmp280_temperature_avx2(const batch_compensate_bmp280_coefficients_struct *c, batch_compensate_bmp280_struct *batch,
+													 uint32_t start, uint32_t end);
+#endif
+static void batch_compensate_bmp280_pressure(const batch_compensate_bmp280_coefficients_struct *c, batch_compensate_bmp280_struct *batch,
+											 uint32_t start, uint32_t end);
+static void *batch_compensate_vl6180x_worker(void *worker);
+
+
+//=============================================================================
+//	client functions
+//=============================================================================
+
+bool batch_compensate_has_avx2()
+{
+#if BATCH_COMPENSATE_X86
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+
+/******************************************************************************
+ * @brief trimming from the PROM bytes 0x88..0x9F, parsed and folded like
+ * 		  bmp280_read_trimming_parameters() and bmp280_prepare_coefficients()
+*/
+void batch_compensate_bmp280_load_prom(batch_compensate_bmp280_coefficients_struct *coefficients, const uint8_t prom[BATCH_COMPENSATE_BMP280_PROM_LENGTH])
+{
+	int32_t dig[12];
+
+	for (uint8_t n = 0; n < 12; n++)
+	{
+		uint16_t value = (uint16_t)((prom[n * 2 + 1] << 8) | prom[n * 2]);
+
+		// dig_T1 and dig_P1 are unsigned
+		dig[n] = (n == 0 || n == 3) ? (int32_t)value : (int32_t)(int16_t)value;
+	}
+
+	*coefficients = (batch_compensate_bmp280_coefficients_struct)
+	{
+		.T1 = dig[0],
+		.T1_x2 = dig[0] * 2,
+		.T2 = dig[1],
+		.T3 = dig[2],
+		.P6 = dig[8],
+		.P5_17 = (int64_t)dig[7] * (1LL << 17),
+		.P4_35 = (int64_t)dig[6] * (1LL << 35),
+		.P3 = dig[5],
+		.P2_12 = (int64_t)dig[4] * (1LL << 12),
+		.P1 = dig[3],
+		.P1_47 = (int64_t)dig[3] * (1LL << 47),
+		.P9 = dig[11],
+		.P8 = dig[10],
+		.P7_4 = (int64_t)dig[9] * (1LL << 4),
+	};
+}
+
+
+bool batch_compensate_bmp280_allocate(batch_compensate_bmp280_struct *batch, uint32_t count)
+{
+	// whole AVX2 vectors, the tail lanes are computed and ignored
+	size_t length = ((size_t)count + BATCH_COMPENSATE_LANES - 1) / BATCH_COMPENSATE_LANES * BATCH_COMPENSATE_LANES;
+
+	memset(batch, 0, sizeof(*batch));
+	batch->count = count;
+	batch->adc_T = calloc(length, sizeof(int32_t));
+	batch->adc_P = calloc(length, sizeof(int32_t));
+	batch->t_fine = calloc(length, sizeof(int32_t));
+	batch->Temperature_100 = calloc(length, sizeof(int32_t));
+	batch->Pressure_256 = calloc(length, sizeof(uint32_t));
+	batch->is_valid = calloc(length, sizeof(uint8_t));
+
+	if (batch->adc_T == NULL || batch->adc_P == NULL || batch->t_fine == NULL || batch->Temperature_100 == NULL ||
+		batch->Pressure_256 == NULL || batch->is_valid == NULL)
+	{
+		batch_compensate_bmp280_free(batch);
+		return false;
+	}
+
+	return true;
+}
+
+
+void batch_compensate_bmp280_free(batch_compensate_bmp280_struct *batch)
+{
+	free(batch->adc_T);
+	free(batch->adc_P);
+	free(batch->t_fine);
+	free(batch->Temperature_100);
+	free(batch->Pressure_256);
+	free(batch->is_valid);
+	memset(batch, 0, sizeof(*batch));
+}
+
+
+/******************************************************************************
+ * @brief unpack and compensate batch->count bursts
+ * 
+ * @param[in] bursts batch->count * BATCH_COMPENSATE_BMP280_BURST_LENGTH bytes
+ * @param[in] thread_count 0 or 1 runs in the calling thread
+ * @param[in] isa BATCH_COMPENSATE_ISA_AVX2 fails without CPU support
+ * @param[out] false if a thread could not be started or AVX2 is missing
+*/
+bool batch_compensate_bmp280(const batch_compensate_bmp280_coefficients_struct *coefficients, batch_compensate_bmp280_struct *batch,
+							 const uint8_t *bursts, uint32_t thread_count, batch_compensate_isa_enum isa)
+{
+	bool is_avx2 = (isa != BATCH_COMPENSATE_ISA_SCALAR) && batch_compensate_has_avx2();
+
+	if (isa == BATCH_COMPENSATE_ISA_AVX2 && is_avx2 == false)
+	{
+		return false;
+	}
+
+	return batch_compensate_run(&batch_compensate_bmp280_worker, coefficients, batch, batch->count, bursts, thread_count, is_avx2);
+}
+
+
+bool batch_compensate_vl6180x_allocate(batch_compensate_vl6180x_struct *batch, uint32_t count)
+{
+	memset(batch, 0, sizeof(*batch));
+	batch->count = count;
+	batch->raw_range = calloc(count + 1, sizeof(uint8_t));
+	batch->als_count = calloc(count + 1, sizeof(uint16_t));
+	batch->error_flag = calloc(count + 1, sizeof(uint8_t));
+	batch->distance_mm = calloc(count + 1, sizeof(uint16_t));
+	batch->lux_100 = calloc(count + 1, sizeof(uint32_t));
+
+	if (batch->raw_range == NULL || batch->als_count == NULL || batch->error_flag == NULL || batch->distance_mm == NULL || batch->lux_100 == NULL)
+	{
+		batch_compensate_vl6180x_free(batch);
+		return false;
+	}
+
+	return true;
+}
+
+
+void batch_compensate_vl6180x_free(batch_compensate_vl6180x_struct *batch)
+{
+	free(batch->raw_range);
+	free(batch->als_count);
+	free(batch->error_flag);
+	free(batch->distance_mm);
+	free(batch->lux_100);
+	memset(batch, 0, sizeof(*batch));
+}
+
+
+/******************************************************************************
+ * @brief unpack and convert batch->count result bursts, scalar only: the
+ * 		  ALS conversion is a 64 bit division
+ * 
+ * @param[in] bursts batch->count * BATCH_COMPENSATE_VL6180X_BURST_LENGTH bytes
+ * @param[out] false for an invalid configuration or if a thread could not be
+ * 			   started
+*/
+bool batch_compensate_vl6180x(const batch_compensate_vl6180x_configuration_struct *configuration, batch_compensate_vl6180x_struct *batch,
+							  const uint8_t *bursts, uint32_t thread_count)
+{
+	if (configuration->als_integration_period_ms == 0 || configuration->als_integration_period_ms > VL6180X_ALS_INTEGRATION_PERIOD_MAX_MS ||
+		(uint8_t)configuration->als_gain > VL6180X_ALS_GAIN_40 ||
+		configuration->scaling < VL6180X_RANGE_SCALING_1X || configuration->scaling > VL6180X_RANGE_SCALING_3X)
+	{
+		return false;
+	}
+
+	return batch_compensate_run(&batch_compensate_vl6180x_worker, configuration, batch, batch->count, bursts, thread_count, false);
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief split [0, count) into one chunk per thread, the last chunk runs in
+ * 		  the calling thread
+*/
+static bool batch_compensate_run(batch_compensate_worker_function *function, const void *parameters, void *batch, uint32_t count,
+								 const uint8_t *bursts, uint32_t thread_count, bool is_avx2)
+{
+	batch_compensate_worker_struct workers[BATCH_COMPENSATE_MAX_THREADS];
+	uint32_t chunk;
+	uint32_t started = 0;
+	bool result = true;
+
+	thread_count = (thread_count == 0) ? 1 : (thread_count > BATCH_COMPENSATE_MAX_THREADS) ? BATCH_COMPENSATE_MAX_THREADS : thread_count;
+	chunk = (count / thread_count + BATCH_COMPENSATE_LANES - 1) / BATCH_COMPENSATE_LANES * BATCH_COMPENSATE_LANES;
+
+	for (uint32_t n = 0; n < thread_count; n++)
+	{
+		uint32_t start = (n * chunk < count) ? n * chunk : count;
+
+		workers[n] = (batch_compensate_worker_struct){0, start, (n + 1 == thread_count || start + chunk > count) ? count : start + chunk,
+													  bursts, parameters, batch, is_avx2};
+	}
+
+	for (uint32_t n = 0; n + 1 < thread_count && result == true; n++)
+	{
+		result = (pthread_create(&workers[n].thread, NULL, function, &workers[n]) == 0);
+		started += (result == true) ? 1 : 0;
+	}
+
+	if (result == true)
+	{
+		function(&workers[thread_count - 1]);
+	}
+
+	for (uint32_t n = 0; n < started; n++)
+	{
+		pthread_join(workers[n].thread, NULL);
+	}
+
+	return result;
+}
+
+
+static void *batch_compensate_bmp280_worker(void *worker)
+{
+	batch_compensate_worker_struct *w = worker;
+	batch_compensate_bmp280_struct *batch = w->batch;
+
+	// structure of arrays, 20 bit ADC values
+	for (uint32_t n = w->start; n < w->end; n++)
+	{
+		const uint8_t *burst = &w->bursts[(size_t)n * BATCH_COMPENSATE_BMP280_BURST_LENGTH];
+
+		batch->adc_P[n] = (int32_t)((burst[0] << 12) | (burst[1] << 4) | (burst[2] >> 4));
+		batch->adc_T[n] = (int32_t)((burst[3] << 12) | (burst[4] << 4) | (burst[5] >> 4));
+	}
+
+#if BATCH_COMPENSATE_X86
+	if (w->is_avx2 == true)
+	{
+		batch_compensate_bmp280_temperature_avx2(w->parameters, batch, w->start, w->end);
+	}
+	else
+#endif
+	{
+		batch_compensate_bmp280_temperature(w->parameters, batch, w->start, w->end);
+	}
+
+	batch_compensate_bmp280_pressure(w->parameters, batch, w->start, w->end);
+
+	return NULL;
+}
+
+
+/******************************************************************************
+ * @brief bmp280_calculate_Temperature_100(), t_fine kept for the pressure
+*/
+static void batch_compensate_bmp280_temperature(const batch_compensate_bmp280_coefficients_struct *c, batch_compensate_bmp280_struct *batch,
+												uint32_t start, uint32_t end)
+{
+	for (uint32_t n = start; n < end; n++)
+	{
+		int32_t adc_T = batch->adc_T[n];
+		int32_t t_delta = (adc_T >> 4) - c->T1;
+		int32_t t_fine = ((((adc_T >> 3) - c->T1_x2) * c->T2) >> 11) + ((((t_delta * t_delta) >> 12) * c->T3) >> 14);
+
+		batch->t_fine[n] = t_fine;
+		batch->Temperature_100[n] = (t_fine * 5 + 128) >> 8;
+	}
+}
+
+
+#if BATCH_COMPENSATE_X86
+/******************************************************************************
+ * @brief 8 samples per iteration, every step is a 32 bit operation of the
+ * 		  scalar formula so the results are identical
+*/
+__attribute__((target("avx2")))
+static void batch_compensate_bmp280_temperature_avx2(const batch_compensate_bmp280_coefficients_struct *c, batch_compensate_bmp280_struct *batch,
+													 uint32_t start, uint32_t end)
+{
+	const __m256i T1 = _mm256_set1_epi32(c->T1);
+	const __m256i T1_x2 = _mm256_set1_epi32(c->T1_x2);
+	const __m256i T2 = _mm256_set1_epi32(c->T2);
+	const __m256i T3 = _mm256_set1_epi32(c->T3);
+	const __m256i five = _mm256_set1_epi32(5);
+	const __m256i rounding = _mm256_set1_epi32(128);
+
+	// start is a multiple of 8, the arrays are padded to whole vectors
+	for (uint32_t n = start; n < end; n += BATCH_COMPENSATE_LANES)
+	{
+		__m256i adc_T = _mm256_loadu_si256((const __m256i *)&batch->adc_T[n]);
+		__m256i t_delta = _mm256_sub_epi32(_mm256_srai_epi32(adc_T, 4), T1);
+		__m256i t_var1 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(_mm256_srai_epi32(adc_T, 3), T1_x2), T2), 11);
+		__m256i t_var2 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(t_delta, t_delta), 12), T3), 14);
+		__m256i t_fine = _mm256_add_epi32(t_var1, t_var2);
+
+		_mm256_storeu_si256((__m256i *)&batch->t_fine[n], t_fine);
+		_mm256_storeu_si256((__m256i *)&batch->Temperature_100[n],
+							_mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(t_fine, five), rounding), 8));
+	}
+}
+#endif
+
+
+/******************************************************************************
+ * @brief bmp280_calculate_Pressure_256(), the t_fine terms are reused while
+ * 		  consecutive samples have the same t_fine (slow temperature drift)
+*/
+static void batch_compensate_bmp280_pressure(const batch_compensate_bmp280_coefficients_struct *c, batch_compensate_bmp280_struct *batch,
+											 uint32_t start, uint32_t end)
+{
+	int32_t last_t_fine = 0;
+	int64_t p_var1 = 0;
+	int64_t p_var2 = 0;
+
+	for (uint32_t n = start; n < end; n++)
+	{
+		int32_t t_fine = batch->t_fine[n];
+
+		if (n == start || t_fine != last_t_fine)
+		{
+			int64_t x = ((int64_t)t_fine) - 128000;
+			int64_t x2 = x * x;
+
+			p_var2 = x2 * c->P6 + x * c->P5_17 + c->P4_35;
+			p_var1 = (c->P1_47 + (((x2 * c->P3) >> 8) + x * c->P2_12) * c->P1) >> 33;
+			last_t_fine = t_fine;
+		}
+
+		batch->is_valid[n] = (p_var1 != 0);
+		if (p_var1 != 0)
+		{
+			int64_t p_fine = 1048576 - batch->adc_P[n];
+
+			p_fine = (((p_fine << 31) - p_var2) * 3125) / p_var1;
+			p_fine = ((p_fine + ((c->P9 * (p_fine >> 13) * (p_fine >> 13)) >> 25) + ((c->P8 * p_fine) >> 19)) >> 8) + c->P7_4;
+			batch->Pressure_256[n] = (uint32_t)p_fine;
+		}
+		else
+		{
+			batch->Pressure_256[n] = 0;
+		}
+	}
+}
+
+
+/******************************************************************************
+ * @brief vl6180x_get_combined_measurement_result() without the bus
+*/
+static void *batch_compensate_vl6180x_worker(void *worker)
+{
+	static const uint16_t gain_100_table[] = VL6180X_ALS_GAIN_100_TABLE;
+
+	batch_compensate_worker_struct *w = worker;
+	const batch_compensate_vl6180x_configuration_struct *configuration = w->parameters;
+	batch_compensate_vl6180x_struct *batch = w->batch;
+	uint32_t denominator = (uint32_t)gain_100_table[configuration->als_gain] * configuration->als_integration_period_ms;
+
+	for (uint32_t n = w->start; n < w->end; n++)
+	{
+		const uint8_t *burst = &w->bursts[(size_t)n * BATCH_COMPENSATE_VL6180X_BURST_LENGTH];
+
+		batch->raw_range[n] = burst[VL6180X_RESULT_BURST_OFFSET_RANGE_VAL];
+		batch->als_count[n] = (uint16_t)((burst[VL6180X_RESULT_BURST_OFFSET_ALS_VAL] << 8) | burst[VL6180X_RESULT_BURST_OFFSET_ALS_VAL + 1]);
+		batch->error_flag[n] = (burst[VL6180X_RESULT_BURST_OFFSET_RANGE_STATUS] & VL6180X_REGISTER_RESULT_RANGE_STATUS_MASK_ERROR_CODE)
+							 | ((burst[VL6180X_RESULT_BURST_OFFSET_ALS_STATUS] & VL6180X_REGISTER_RESULT_ALS_STATUS_MASK_ERROR_CODE) >> 4);
+		batch->distance_mm[n] = (uint16_t)batch->raw_range[n] * (uint16_t)configuration->scaling;
+		batch->lux_100[n] = (uint32_t)(((uint64_t)batch->als_count[n] * VL6180X_ALS_LUX_RESOLUTION_100 * VL6180X_ALS_REFERENCE_INTEGRATION_MS * 100) / denominator);
+	}
+
+	return NULL;
+}
@@ -0,0 +1,107 @@
+/*
+ * batch_compensate.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ */
+
+#ifndef BATCH_COMPENSATE_H_
+#define BATCH_COMPENSATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bmp280/bmp280_definitions.h"
+#include "vl6180x/vl6180x_definitions.h"
+
+//=============================================================================
+//	offline batch compensation
+//=============================================================================
+// Host side conversion of recorded raw frames into physical values, bit-exact
+// with the firmware:
+//
+// BMP280   6 byte bursts from 0xF7 (press_msb..temp_xlsb) plus the 24 byte
+//          trimming PROM from 0x88, same results as bmp280_compensate()
+// VL6180X  VL6180X_RESULT_BURST_LENGTH byte bursts from RESULT_RANGE_STATUS,
+//          range scaled like the driver, ALS as vl6180x_convert_als_to_lux_100()
+//
+// Frames are unpacked into a structure of arrays and processed in chunks by
+// up to BATCH_COMPENSATE_MAX_THREADS threads. The BMP280 temperature stage
+// runs 8 samples per AVX2 instruction where the CPU has it; the pressure
+// stage stays scalar (AVX2 has no 64 bit multiply, shift or divide) but
+// reuses the t_fine dependent terms while the temperature does not change.
+
+#define BATCH_COMPENSATE_MAX_THREADS			(64)
+#define BATCH_COMPENSATE_BMP280_PROM_LENGTH		(24)	// dig_T1..dig_P9
+#define BATCH_COMPENSATE_BMP280_BURST_LENGTH	(BMP280_LENGTH_MEASUREMENT_DATA)
+#define BATCH_COMPENSATE_VL6180X_BURST_LENGTH	(VL6180X_RESULT_BURST_LENGTH)
+
+typedef enum
+{
+	BATCH_COMPENSATE_ISA_AUTO = 0,		// AVX2 if the CPU supports it
+	BATCH_COMPENSATE_ISA_SCALAR,
+	BATCH_COMPENSATE_ISA_AVX2,
+}batch_compensate_isa_enum;
+
+// trimming products folded like bmp280_prepare_coefficients()
+typedef struct
+{
+	int32_t T1;
+	int32_t T1_x2;
+	int32_t T2;
+	int32_t T3;
+	int64_t P6;
+	int64_t P5_17;
+	int64_t P4_35;
+	int64_t P3;
+	int64_t P2_12;
+	int64_t P1;
+	int64_t P1_47;
+	int64_t P9;
+	int64_t P8;
+	int64_t P7_4;
+}batch_compensate_bmp280_coefficients_struct;
+
+// structure of arrays, `count` entries each
+typedef struct
+{
+	uint32_t count;
+	int32_t *adc_T;
+	int32_t *adc_P;
+	int32_t *t_fine;
+	int32_t *Temperature_100;
+	uint32_t *Pressure_256;
+	uint8_t *is_valid;			// false where the pressure divisor was zero
+}batch_compensate_bmp280_struct;
+
+typedef struct
+{
+	vl6180x_range_scaling_enum scaling;
+	vl6180x_als_gain_enum als_gain;
+	uint16_t als_integration_period_ms;
+}batch_compensate_vl6180x_configuration_struct;
+
+typedef struct
+{
+	uint32_t count;
+	uint8_t *raw_range;
+	uint16_t *als_count;
+	uint8_t *error_flag;		// range error code in upper nibble, ALS in lower nibble
+	uint16_t *distance_mm;
+	uint32_t *lux_100;
+}batch_compensate_vl6180x_struct;
+
+bool batch_compensate_has_avx2();
+
+void batch_compensate_bmp280_load_prom(batch_compensate_bmp280_coefficients_struct *coefficients, const uint8_t prom[BATCH_COMPENSATE_BMP280_PROM_LENGTH]);
+bool batch_compensate_bmp280_allocate(batch_compensate_bmp280_struct *batch, uint32_t count);
+void batch_compensate_bmp280_free(batch_compensate_bmp280_struct *batch);
+bool batch_compensate_bmp280(const batch_compensate_bmp280_coefficients_struct *coefficients, batch_compensate_bmp280_struct *batch,
+							 const uint8_t *bursts, uint32_t thread_count, batch_compensate_isa_enum isa);
+
+bool batch_compensate_vl6180x_allocate(batch_compensate_vl6180x_struct *batch, uint32_t count);
+void batch_compensate_vl6180x_free(batch_compensate_vl6180x_struct *batch);
+bool batch_compensate_vl6180x(const batch_compensate_vl6180x_configuration_struct *configuration, batch_compensate_vl6180x_struct *batch,
+							  const uint8_t *bursts, uint32_t thread_count);
+
+#endif /* BATCH_COMPENSATE_H_ */
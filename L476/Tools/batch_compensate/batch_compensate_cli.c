@@ -0,0 +1,524 @@
+/*
+ * batch_compensate_cli.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Command line front end of batch_compensate.h for recorded raw sensor logs
+ *
+ *  build: cmake -S ../.. -B build && cmake --build build --target batch_compensate_cli
+ *
+ *  usage: batch_compensate bmp280 <prom.bin> <bursts.bin> [options]
+ *         batch_compensate vl6180x <bursts.bin> [--scaling 1|2|3] [--gain <code>] [--period <ms>] [options]
+ *         batch_compensate generate <count> <prom.bin> <bursts.bin>
+ *
+ *  options: -o <file.csv>  write one line per sample
+ *           -j <threads>   default: online CPUs
+ *           --scalar       no AVX2
+ *           --verify       compare every sample with the firmware driver
+ *           --bench        ns/sample for scalar, AVX2 and all threads
+ *
+ *  files: prom.bin     24 bytes read from BMP280 0x88 (dig_T1..dig_P9)
+ *         bursts.bin   BMP280: 6 byte bursts from 0xF7, VL6180X: 22 byte
+ *                      bursts from RESULT_RANGE_STATUS, back to back
+ *  generate writes the datasheet example PROM and <count> bursts spread over
+ *  -40..85 degC and 300..1100 hPa.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "batch_compensate.h"
+
+#include "bmp280/bmp280.h"
+#include "vl6180x/vl6180x.h"
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	const char *output_path;
+	uint32_t thread_count;
+	batch_compensate_isa_enum isa;
+	bool is_verify;
+	bool is_bench;
+	batch_compensate_vl6180x_configuration_struct vl6180x;
+}batch_compensate_cli_options_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static int batch_compensate_cli_bmp280(const char *prom_path, const char *bursts_path, const batch_compensate_cli_options_struct *options);
+static int batch_compensate_cli_vl6180x(const char *bursts_path, const batch_compensate_cli_options_struct *options);
+static int batch_compensate_cli_generate(uint32_t count, const char *prom_path, const char *bursts_path);
+static uint32_t batch_compensate_cli_verify_bmp280(const uint8_t *prom, const uint8_t *bursts, const batch_compensate_bmp280_struct *batch);
+static uint32_t batch_compensate_cli_verify_vl6180x(const batch_compensate_vl6180x_configuration_struct *configuration, const batch_compensate_vl6180x_struct *batch);
+static bool batch_compensate_cli_prom_read(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static bool batch_compensate_cli_prom_write(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static bool batch_compensate_cli_register_ignore(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length);
+static bool batch_compensate_cli_sleep(const uint32_t sleep_ms);
+static uint8_t *batch_compensate_cli_load(const char *path, size_t *length);
+static bool batch_compensate_cli_parse_options(int argc, char *argv[], int first, batch_compensate_cli_options_struct *options);
+static double batch_compensate_cli_now_ns();
+static void batch_compensate_cli_report(const char *name, uint32_t count, double elapsed_ns, uint32_t thread_count);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+
+// BMP280 register file behind the driver in --verify
+static uint8_t batch_compensate_cli_registers[256];
+
+
+//=============================================================================
+//	main
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	batch_compensate_cli_options_struct options =
+	{
+		.thread_count = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN),
+		.vl6180x = {VL6180X_RANGE_SCALING_1X, VL6180X_ALS_GAIN_1, 100},
+	};
+
+	if (argc >= 4 && strcmp(argv[1], "bmp280") == 0 && batch_compensate_cli_parse_options(argc, argv, 4, &options) == true)
+	{
+		return batch_compensate_cli_bmp280(argv[2], argv[3], &options);
+	}
+	if (argc >= 3 && strcmp(argv[1], "vl6180x") == 0 && batch_compensate_cli_parse_options(argc, argv, 3, &options) == true)
+	{
+		return batch_compensate_cli_vl6180x(argv[2], &options);
+	}
+	if (argc == 5 && strcmp(argv[1], "generate") == 0)
+	{
+		return batch_compensate_cli_generate((uint32_t)strtoul(argv[2], NULL, 0), argv[3], argv[4]);
+	}
+
+	fprintf(stderr, "usage: %s bmp280 <prom.bin> <bursts.bin> [options]\n"
+					"       %s vl6180x <bursts.bin> [--scaling 1|2|3] [--gain <code>] [--period <ms>] [options]\n"
+					"       %s generate <count> <prom.bin> <bursts.bin>\n"
+					"options: -o <file.csv> -j <threads> --scalar --verify --bench\n", argv[0], argv[0], argv[0]);
+	return 1;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static int batch_compensate_cli_bmp280(const char *prom_path, const char *bursts_path, const batch_compensate_cli_options_struct *options)
+{
+	batch_compensate_bmp280_coefficients_struct coefficients;
+	batch_compensate_bmp280_struct batch;
+	size_t prom_length;
+	size_t bursts_length;
+	uint8_t *prom = batch_compensate_cli_load(prom_path, &prom_length);
+	uint8_t *bursts = batch_compensate_cli_load(bursts_path, &bursts_length);
+	uint32_t count = (uint32_t)(bursts_length / BATCH_COMPENSATE_BMP280_BURST_LENGTH);
+	int result = 0;
+
+	if (prom == NULL || bursts == NULL || prom_length < BATCH_COMPENSATE_BMP280_PROM_LENGTH)
+	{
+		fprintf(stderr, "%s: at least %u bytes expected\n", prom_path, (unsigned int)BATCH_COMPENSATE_BMP280_PROM_LENGTH);
+		return 1;
+	}
+	if (batch_compensate_bmp280_allocate(&batch, count) == false)
+	{
+		fprintf(stderr, "out of memory for %lu samples\n", (unsigned long)count);
+		return 1;
+	}
+
+	batch_compensate_bmp280_load_prom(&coefficients, prom);
+
+	if (options->is_bench == true)
+	{
+		static const struct { const char *name; batch_compensate_isa_enum isa; bool is_threaded; } runs[] =
+		{
+			{"scalar", BATCH_COMPENSATE_ISA_SCALAR, false}, {"avx2", BATCH_COMPENSATE_ISA_AVX2, false},
+			{"scalar threads", BATCH_COMPENSATE_ISA_SCALAR, true}, {"avx2 threads", BATCH_COMPENSATE_ISA_AVX2, true},
+		};
+
+		// first touch of the output pages out of the timed runs
+		batch_compensate_bmp280(&coefficients, &batch, bursts, 1, BATCH_COMPENSATE_ISA_SCALAR);
+
+		for (uint8_t n = 0; n < sizeof(runs) / sizeof(runs[0]); n++)
+		{
+			uint32_t thread_count = (runs[n].is_threaded == true) ? options->thread_count : 1;
+			double start = batch_compensate_cli_now_ns();
+
+			if (batch_compensate_bmp280(&coefficients, &batch, bursts, thread_count, runs[n].isa) == true)
+			{
+				batch_compensate_cli_report(runs[n].name, count, batch_compensate_cli_now_ns() - start, thread_count);
+			}
+		}
+	}
+
+	double start = batch_compensate_cli_now_ns();
+
+	if (batch_compensate_bmp280(&coefficients, &batch, bursts, options->thread_count, options->isa) == false)
+	{
+		fprintf(stderr, "compensation failed\n");
+		result = 1;
+	}
+	else if (options->is_bench == false)
+	{
+		batch_compensate_cli_report((options->isa == BATCH_COMPENSATE_ISA_SCALAR || batch_compensate_has_avx2() == false) ? "scalar" : "avx2",
+									count, batch_compensate_cli_now_ns() - start, options->thread_count);
+	}
+
+	if (result == 0 && options->is_verify == true)
+	{
+		uint32_t mismatch_count = batch_compensate_cli_verify_bmp280(prom, bursts, &batch);
+
+		fprintf(stderr, "verify: %lu of %lu samples differ from bmp280_compensate()\n", (unsigned long)mismatch_count, (unsigned long)count);
+		result = (mismatch_count == 0) ? 0 : 1;
+	}
+
+	if (result == 0 && options->output_path != NULL)
+	{
+		FILE *output = fopen(options->output_path, "w");
+
+		if (output == NULL)
+		{
+			perror(options->output_path);
+			result = 1;
+		}
+		else
+		{
+			fprintf(output, "index,temperature_100,pressure_256,valid\n");
+			for (uint32_t n = 0; n < count; n++)
+			{
+				fprintf(output, "%lu,%ld,%lu,%u\n", (unsigned long)n, (long)batch.Temperature_100[n], (unsigned long)batch.Pressure_256[n],
+						(unsigned int)batch.is_valid[n]);
+			}
+			fclose(output);
+		}
+	}
+
+	batch_compensate_bmp280_free(&batch);
+	free(prom);
+	free(bursts);
+
+	return result;
+}
+
+
+static int batch_compensate_cli_vl6180x(const char *bursts_path, const batch_compensate_cli_options_struct *options)
+{
+	batch_compensate_vl6180x_struct batch;
+	size_t bursts_length;
+	uint8_t *bursts = batch_compensate_cli_load(bursts_path, &bursts_length);
+	uint32_t count = (uint32_t)(bursts_length / BATCH_COMPENSATE_VL6180X_BURST_LENGTH);
+	int result = 0;
+
+	if (bursts == NULL || batch_compensate_vl6180x_allocate(&batch, count) == false)
+	{
+		free(bursts);
+		return 1;
+	}
+
+	double start = batch_compensate_cli_now_ns();
+
+	if (batch_compensate_vl6180x(&options->vl6180x, &batch, bursts, options->thread_count) == false)
+	{
+		fprintf(stderr, "invalid configuration or thread start failed\n");
+		result = 1;
+	}
+	else
+	{
+		batch_compensate_cli_report("scalar", count, batch_compensate_cli_now_ns() - start, options->thread_count);
+	}
+
+	if (result == 0 && options->is_verify == true)
+	{
+		uint32_t mismatch_count = batch_compensate_cli_verify_vl6180x(&options->vl6180x, &batch);
+
+		fprintf(stderr, "verify: %lu of %lu samples differ from vl6180x_convert_als_to_lux_100()\n", (unsigned long)mismatch_count, (unsigned long)count);
+		result = (mismatch_count == 0) ? 0 : 1;
+	}
+
+	if (result == 0 && options->output_path != NULL)
+	{
+		FILE *output = fopen(options->output_path, "w");
+
+		if (output == NULL)
+		{
+			perror(options->output_path);
+			result = 1;
+		}
+		else
+		{
+			fprintf(output, "index,distance_mm,lux_100,error_flag\n");
+			for (uint32_t n = 0; n < count; n++)
+			{
+				fprintf(output, "%lu,%u,%lu,0x%02X\n", (unsigned long)n, (unsigned int)batch.distance_mm[n], (unsigned long)batch.lux_100[n],
+						(unsigned int)batch.error_flag[n]);
+			}
+			fclose(output);
+		}
+	}
+
+	batch_compensate_vl6180x_free(&batch);
+	free(bursts);
+
+	return result;
+}
+
+
+/******************************************************************************
+ * @brief datasheet example PROM, adc_T and adc_P from a fixed seed over the
+ * 		  operating range
+*/
+static int batch_compensate_cli_generate(uint32_t count, const char *prom_path, const char *bursts_path)
+{
+	static const uint16_t trimming[12] =
+	{
+		27504, 26435, (uint16_t)-1000, 36477, (uint16_t)-10685, 3024, 2855, 140, (uint16_t)-7, 15500, (uint16_t)-14600, 6000,
+	};
+	FILE *prom = fopen(prom_path, "wb");
+	FILE *bursts = fopen(bursts_path, "wb");
+	uint32_t random = 12345;
+	uint32_t adc_T = 519888;
+
+	if (prom == NULL || bursts == NULL)
+	{
+		perror((prom == NULL) ? prom_path : bursts_path);
+		return 1;
+	}
+
+	for (uint8_t n = 0; n < 12; n++)
+	{
+		fputc(trimming[n] & 0xFF, prom);
+		fputc(trimming[n] >> 8, prom);
+	}
+
+	for (uint32_t n = 0; n < count; n++)
+	{
+		random = random * 1664525 + 1013904223;
+
+		// temperature drifts, one new step every 64 samples like a real log
+		if ((n % 64) == 0)
+		{
+			adc_T = 400000 + ((random >> 8) % 260000);
+		}
+		uint32_t adc_P = 250000 + ((random >> 4) % 450000);
+		uint8_t burst[BATCH_COMPENSATE_BMP280_BURST_LENGTH] =
+		{
+			(uint8_t)(adc_P >> 12), (uint8_t)(adc_P >> 4), (uint8_t)(adc_P << 4),
+			(uint8_t)(adc_T >> 12), (uint8_t)(adc_T >> 4), (uint8_t)(adc_T << 4),
+		};
+
+		fwrite(burst, sizeof(burst), 1, bursts);
+	}
+
+	fclose(prom);
+	fclose(bursts);
+
+	return 0;
+}
+
+
+/******************************************************************************
+ * @brief the firmware driver reads the PROM through bmp280_initialize() from
+ * 		  a register file and compensates every burst
+ * 
+ * @param[out] samples whose temperature, pressure or validity differ
+*/
+static uint32_t batch_compensate_cli_verify_bmp280(const uint8_t *prom, const uint8_t *bursts, const batch_compensate_bmp280_struct *batch)
+{
+	uint32_t mismatch_count = 0;
+	int32_t Temperature_100;
+	uint32_t Pressure_256;
+
+	memcpy(&batch_compensate_cli_registers[BMP280_ADDRESS_CALIBRATION_START], prom, BATCH_COMPENSATE_BMP280_PROM_LENGTH);
+	batch_compensate_cli_registers[BMP280_ADDRESS_ID] = BMP280_VALUE_ID;
+	if (bmp280_initialize(&batch_compensate_cli_prom_read, &batch_compensate_cli_prom_write, &batch_compensate_cli_sleep) == false)
+	{
+		return batch->count;
+	}
+
+	for (uint32_t n = 0; n < batch->count; n++)
+	{
+		bool is_valid = bmp280_compensate((uint8_t *)&bursts[(size_t)n * BATCH_COMPENSATE_BMP280_BURST_LENGTH], &Temperature_100, &Pressure_256);
+
+		if (is_valid != (bool)batch->is_valid[n] || Temperature_100 != batch->Temperature_100[n] ||
+			(is_valid == true && Pressure_256 != batch->Pressure_256[n]))
+		{
+			mismatch_count++;
+		}
+	}
+
+	return mismatch_count;
+}
+
+
+/******************************************************************************
+ * @brief vl6180x_initialize() fails on the ID check but keeps the
+ * 		  callbacks, enough for vl6180x_set_als_configuration()
+*/
+static uint32_t batch_compensate_cli_verify_vl6180x(const batch_compensate_vl6180x_configuration_struct *configuration, const batch_compensate_vl6180x_struct *batch)
+{
+	uint32_t mismatch_count = 0;
+
+	vl6180x_initialize(&batch_compensate_cli_register_ignore, &batch_compensate_cli_register_ignore, &batch_compensate_cli_sleep);
+	(void)vl6180x_set_als_configuration(configuration->als_gain, configuration->als_integration_period_ms);
+
+	for (uint32_t n = 0; n < batch->count; n++)
+	{
+		if (vl6180x_convert_als_to_lux_100(batch->als_count[n]) != batch->lux_100[n] ||
+			(uint16_t)batch->raw_range[n] * (uint16_t)configuration->scaling != batch->distance_mm[n])
+		{
+			mismatch_count++;
+		}
+	}
+
+	return mismatch_count;
+}
+
+
+static bool batch_compensate_cli_prom_read(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	bool result = (memory_address + data_length <= sizeof(batch_compensate_cli_registers));
+
+	if (result == true)
+	{
+		memcpy(data_buffer, &batch_compensate_cli_registers[memory_address], data_length);
+	}
+
+	return result;
+}
+
+
+static bool batch_compensate_cli_prom_write(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	(void)memory_address;
+	(void)data_buffer;
+	(void)data_length;
+
+	return true;
+}
+
+
+static bool batch_compensate_cli_register_ignore(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	(void)register_address;
+	(void)data_buffer;
+	(void)data_length;
+
+	return true;
+}
+
+
+static bool batch_compensate_cli_sleep(const uint32_t sleep_ms)
+{
+	(void)sleep_ms;
+
+	return true;
+}
+
+
+static uint8_t *batch_compensate_cli_load(const char *path, size_t *length)
+{
+	FILE *file = fopen(path, "rb");
+	uint8_t *data = NULL;
+	long size;
+
+	if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0)
+	{
+		perror(path);
+	}
+	else
+	{
+		data = malloc((size_t)size + 1);
+		if (data != NULL && fread(data, 1, (size_t)size, file) != (size_t)size)
+		{
+			perror(path);
+			free(data);
+			data = NULL;
+		}
+		*length = (size_t)size;
+	}
+
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+
+	return data;
+}
+
+
+static bool batch_compensate_cli_parse_options(int argc, char *argv[], int first, batch_compensate_cli_options_struct *options)
+{
+	bool result = true;
+
+	for (int n = first; n < argc && result == true; n++)
+	{
+		bool has_value = (n + 1 < argc);
+
+		if (strcmp(argv[n], "-o") == 0 && has_value)
+		{
+			options->output_path = argv[++n];
+		}
+		else if (strcmp(argv[n], "-j") == 0 && has_value)
+		{
+			options->thread_count = (uint32_t)strtoul(argv[++n], NULL, 0);
+		}
+		else if (strcmp(argv[n], "--scaling") == 0 && has_value)
+		{
+			options->vl6180x.scaling = (vl6180x_range_scaling_enum)strtoul(argv[++n], NULL, 0);
+		}
+		else if (strcmp(argv[n], "--gain") == 0 && has_value)
+		{
+			options->vl6180x.als_gain = (vl6180x_als_gain_enum)strtoul(argv[++n], NULL, 0);
+		}
+		else if (strcmp(argv[n], "--period") == 0 && has_value)
+		{
+			options->vl6180x.als_integration_period_ms = (uint16_t)strtoul(argv[++n], NULL, 0);
+		}
+		else if (strcmp(argv[n], "--scalar") == 0)
+		{
+			options->isa = BATCH_COMPENSATE_ISA_SCALAR;
+		}
+		else if (strcmp(argv[n], "--verify") == 0)
+		{
+			options->is_verify = true;
+		}
+		else if (strcmp(argv[n], "--bench") == 0)
+		{
+			options->is_bench = true;
+		}
+		else
+		{
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+
+static double batch_compensate_cli_now_ns()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+
+static void batch_compensate_cli_report(const char *name, uint32_t count, double elapsed_ns, uint32_t thread_count)
+{
+	fprintf(stderr, "%-15s %lu samples, %2lu threads, %8.2f ms, %6.2f ns/sample, %7.1f Msamples/s\n", name, (unsigned long)count,
+			(unsigned long)thread_count, elapsed_ns / 1e6, (count > 0) ? elapsed_ns / count : 0.0, (elapsed_ns > 0) ? count * 1e3 / elapsed_ns : 0.0);
+}
@@ -0,0 +1,421 @@
+/*
+ * bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Host micro-benchmarks of the Sensors/ code against the simulated HAL (Sim/)
+ *
+ *  build: cmake -S ../.. -B build && cmake --build build --target bench
+ *
+ *  usage: sensor_bench [--json <file>]
+ *         prints one line per benchmark, --json also writes the results as
+ *         JSON for regression tracking, e.g.
+ *         {"suite": "filter", "name": "median5", "unit": "ns", "per_item": 21.52, "items": 1024, "checksum": 12345}
+ *
+ *  suites: compensation  BMP280 T + P compensation variants of
+ *                        bmp280_benchmark.c, followed by their exhaustive
+ *                        error against the 64 bit reference
+ *          filter        filter_benchmark_run() stages
+ *          protocol      register bursts through sensor_i2c and the simulated
+ *                        bus, with and without deferred traces, the full
+ *                        BMP280 sample path and the sample line formatter
+ *
+ *  checks (exit code 1 on failure): register address width of sensor_i2c,
+ *  BMP280 compensation exactness, formatter output against sprintf()
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal_sim.h"
+
+#include "bmp280/bmp280.h"
+#include "bmp280/bmp280_benchmark.h"
+#include "bmp280/bmp280_definitions.h"
+#include "common/sensor_cycles.h"
+#include "common/sensor_format_benchmark.h"
+#include "common/sensor_i2c.h"
+#include "common/sensor_log.h"
+#include "filter/filter_benchmark.h"
+#include "vl6180x/vl6180x.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+#define BENCH_PROTOCOL_COUNT		(4096)
+#define BENCH_REPEAT_COUNT			(5)		// best of, against scheduler noise
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	const char *suite;
+	const char *name;
+	uint64_t total_ticks;
+	uint32_t item_count;
+	int64_t checksum;
+}bench_result_struct;
+
+typedef void (bench_function)(bench_result_struct *result);
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void bench_compensation(bench_result_struct results[BMP280_BENCHMARK_COUNT]);
+static void bench_protocol_burst(bench_result_struct *result);
+static void bench_protocol_burst_traced(bench_result_struct *result);
+static void bench_protocol_sample(bench_result_struct *result);
+static bool bench_bmp280_read(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static bool bench_bmp280_write(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static bool bench_bmp280_sleep(const uint32_t sleep_ms);
+static bool bench_check_register_addressing();
+static bool bench_vl6180x_read(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length);
+static bool bench_vl6180x_write(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length);
+static void bench_run(bench_result_struct *result, const char *suite, const char *name, bench_function *function);
+static void bench_report(const bench_result_struct *results, uint32_t result_count,
+						 const bmp280_benchmark_exactness_struct exactness[BMP280_BENCHMARK_COUNT], FILE *json);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static const sensor_i2c_device_struct bench_bmp280_device =
+{
+	.name = "BMP280",
+	.i2c_handle = &hi2c3,
+	.device_address = BMP280_I2C_DEVICE_ADDRESS,
+	.address_width = SENSOR_I2C_ADDRESS_WIDTH_8BIT,
+};
+
+static const sensor_i2c_device_struct bench_vl6180x_device =
+{
+	.name = "VL6180X",
+	.i2c_handle = &hi2c3,
+	.device_address = VL6180X_I2C_DEVICE_ADDRESS,
+	.address_width = SENSOR_I2C_ADDRESS_WIDTH_16BIT,
+};
+
+
+//=============================================================================
+//	main
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	bench_result_struct results[32];
+	uint32_t result_count = 0;
+	FILE *json = NULL;
+
+	if (argc == 3 && strcmp(argv[1], "--json") == 0)
+	{
+		json = fopen(argv[2], "w");
+		if (json == NULL)
+		{
+			perror(argv[2]);
+			return 1;
+		}
+	}
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: %s [--json <file>]\n", argv[0]);
+		return 1;
+	}
+
+	// traces off unless a benchmark wants them, UART output discarded
+	sensor_log_level = SENSOR_LOG_LEVEL_ERROR;
+	hal_sim_uart_set_output(NULL);
+	hal_sim_bmp280_attach(BMP280_I2C_DEVICE_ADDRESS);
+	hal_sim_vl6180x_attach(VL6180X_I2C_DEVICE_ADDRESS);
+	sensor_cycles_initialize();
+
+	if (bench_check_register_addressing() == false)
+	{
+		return 1;
+	}
+
+	bench_compensation(&results[result_count]);
+	result_count += BMP280_BENCHMARK_COUNT;
+
+	bmp280_benchmark_exactness_struct exactness[BMP280_BENCHMARK_COUNT];
+
+	bmp280_benchmark_check_exactness(exactness, BMP280_BENCHMARK_PRESSURE_STEP);
+	if (exactness[BMP280_BENCHMARK_PRECOMPUTED].mismatch_count != 0)
+	{
+		fprintf(stderr, "bmp280: precomputed compensation differs in %lu samples\n", (unsigned long)exactness[BMP280_BENCHMARK_PRECOMPUTED].mismatch_count);
+		return 1;
+	}
+
+	filter_benchmark_result_struct filter_results[FILTER_BENCHMARK_STAGE_COUNT];
+
+	filter_benchmark_run(filter_results);
+	for (uint8_t n = 0; n < FILTER_BENCHMARK_STAGE_COUNT; n++)
+	{
+		results[result_count++] = (bench_result_struct){"filter", filter_results[n].name, filter_results[n].total_ticks,
+														filter_results[n].sample_count, filter_results[n].checksum};
+	}
+
+	bench_run(&results[result_count++], "protocol", "i2c_burst", &bench_protocol_burst);
+	bench_run(&results[result_count++], "protocol", "i2c_burst_traced", &bench_protocol_burst_traced);
+	bench_run(&results[result_count++], "protocol", "bmp280_sample", &bench_protocol_sample);
+
+	sensor_format_benchmark_result_struct format_results[SENSOR_FORMAT_BENCHMARK_COUNT];
+
+	sensor_format_benchmark_run(format_results);
+	for (uint8_t n = 0; n < SENSOR_FORMAT_BENCHMARK_COUNT; n++)
+	{
+		results[result_count++] = (bench_result_struct){"protocol", format_results[n].name, format_results[n].total_ticks,
+														format_results[n].line_count, format_results[n].character_count};
+	}
+	if (format_results[SENSOR_FORMAT_BENCHMARK_FORMATTER].mismatch_count != 0)
+	{
+		fprintf(stderr, "sensor_format: %lu lines differ from sprintf()\n", (unsigned long)format_results[SENSOR_FORMAT_BENCHMARK_FORMATTER].mismatch_count);
+		return 1;
+	}
+
+	bench_report(results, result_count, exactness, json);
+	if (json != NULL)
+	{
+		fclose(json);
+	}
+
+	return 0;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief best of BENCH_REPEAT_COUNT bmp280_benchmark_run() per variant
+*/
+static void bench_compensation(bench_result_struct results[BMP280_BENCHMARK_COUNT])
+{
+	bmp280_benchmark_result_struct runs[BMP280_BENCHMARK_COUNT];
+
+	for (uint8_t n = 0; n < BENCH_REPEAT_COUNT; n++)
+	{
+		bmp280_benchmark_run(runs);
+		for (uint8_t variant = 0; variant < BMP280_BENCHMARK_COUNT; variant++)
+		{
+			if (n == 0 || runs[variant].total_ticks < results[variant].total_ticks)
+			{
+				results[variant] = (bench_result_struct){"compensation", runs[variant].name, runs[variant].total_ticks,
+														 runs[variant].sample_count, runs[variant].checksum};
+			}
+		}
+	}
+}
+
+
+static void bench_protocol_burst(bench_result_struct *result)
+{
+	uint8_t data[BMP280_LENGTH_MEASUREMENT_DATA];
+	uint32_t start = sensor_cycles_now();
+
+	for (uint32_t n = 0; n < BENCH_PROTOCOL_COUNT; n++)
+	{
+		sensor_i2c_read_registers(&bench_bmp280_device, BMP280_ADDRESS_MEASUREMENT_DATA_START, data, sizeof(data));
+		result->checksum += data[n % sizeof(data)];
+	}
+	result->total_ticks = sensor_cycles_now() - start;
+	result->item_count = BENCH_PROTOCOL_COUNT;
+}
+
+
+/******************************************************************************
+ * @brief same bursts at TRACE level, the difference is the cost of one
+ * 		  deferred trace frame
+*/
+static void bench_protocol_burst_traced(bench_result_struct *result)
+{
+	sensor_log_level = SENSOR_LOG_LEVEL_TRACE;
+	bench_protocol_burst(result);
+	sensor_log_level = SENSOR_LOG_LEVEL_ERROR;
+}
+
+
+/******************************************************************************
+ * @brief driver path of one sample: status, burst and compensation
+*/
+static void bench_protocol_sample(bench_result_struct *result)
+{
+	double temperature;
+	double pressure;
+	uint32_t start;
+
+	bmp280_initialize(&bench_bmp280_read, &bench_bmp280_write, &bench_bmp280_sleep);
+
+	start = sensor_cycles_now();
+	for (uint32_t n = 0; n < BENCH_PROTOCOL_COUNT; n++)
+	{
+		hal_sim_bmp280_set_adc(519888 + (n & 0xFF), 415148 + (n & 0x3FF));
+		bmp280_get_temperature_and_pressure(&temperature, &pressure);
+		result->checksum += (int64_t)pressure;
+	}
+	result->total_ticks = sensor_cycles_now() - start;
+	result->item_count = BENCH_PROTOCOL_COUNT;
+}
+
+
+static bool bench_bmp280_read(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	return sensor_i2c_read_registers(&bench_bmp280_device, memory_address, data_buffer, data_length);
+}
+
+
+static bool bench_bmp280_write(const uint8_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	return sensor_i2c_write_registers(&bench_bmp280_device, memory_address, data_buffer, data_length);
+}
+
+
+static bool bench_bmp280_sleep(const uint32_t sleep_ms)
+{
+	HAL_Delay(sleep_ms);
+	return true;
+}
+
+
+/******************************************************************************
+ * @brief 16 bit registers must reach the VL6180X model at their full address
+ * 		  and not alias the low byte, an 8 bit device must never see an
+ * 		  address above 0xFF (the bus would send only its low byte)
+ * 
+ * @param[out] true if all checks pass
+*/
+static bool bench_check_register_addressing()
+{
+	// vl6180x_initialize(): SR03 settings 0x0207, 0x01A7 and readout averaging 0x010A
+	static const struct
+	{
+		uint16_t register_address;
+		uint8_t value;
+	}writes[] = {{0x0207, 0x01}, {0x01A7, 0x1F}, {0x010A, 0x30}};
+
+	bool result = true;
+	uint8_t aliases[sizeof(writes) / sizeof(writes[0])];
+	uint8_t data;
+
+	for (uint8_t n = 0; n < sizeof(writes) / sizeof(writes[0]) && result == true; n++)
+	{
+		result = sensor_i2c_read_registers(&bench_vl6180x_device, writes[n].register_address & 0xFF, &aliases[n], 1);
+	}
+
+	if (result == true)
+	{
+		result = vl6180x_initialize(&bench_vl6180x_read, &bench_vl6180x_write, &bench_bmp280_sleep);
+	}
+
+	for (uint8_t n = 0; n < sizeof(writes) / sizeof(writes[0]) && result == true; n++)
+	{
+		result = sensor_i2c_read_registers(&bench_vl6180x_device, writes[n].register_address, &data, 1) && data == writes[n].value;
+		if (result == true)
+		{
+			result = sensor_i2c_read_registers(&bench_vl6180x_device, writes[n].register_address & 0xFF, &data, 1) && data == aliases[n];
+		}
+		if (result == false)
+		{
+			fprintf(stderr, "sensor_i2c: VL6180X register 0x%04x not written at its 16 bit address\n", writes[n].register_address);
+		}
+	}
+
+	// BMP280 ID register 0xD0 as alias of 0x1D0, ctrl_meas 0xF4 of 0x1F4
+	if (result == true)
+	{
+		data = 0;
+		result = (sensor_i2c_read_registers(&bench_bmp280_device, 0x1D0, &data, 1) == false && data == 0);
+		result = result && (sensor_i2c_write_registers(&bench_bmp280_device, 0x1F4, &data, 1) == false);
+		if (result == false)
+		{
+			fprintf(stderr, "sensor_i2c: register address above 0xFF accepted for the 8 bit BMP280\n");
+		}
+	}
+
+	return result;
+}
+
+
+static bool bench_vl6180x_read(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	return sensor_i2c_read_registers(&bench_vl6180x_device, register_address, data_buffer, data_length);
+}
+
+
+static bool bench_vl6180x_write(const vl6180x_register_address_enum register_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	return sensor_i2c_write_registers(&bench_vl6180x_device, register_address, data_buffer, data_length);
+}
+
+
+/******************************************************************************
+ * @brief best of BENCH_REPEAT_COUNT runs
+*/
+static void bench_run(bench_result_struct *result, const char *suite, const char *name, bench_function *function)
+{
+	for (uint8_t n = 0; n < BENCH_REPEAT_COUNT; n++)
+	{
+		bench_result_struct run = {suite, name, 0, 0, 0};
+
+		function(&run);
+		if (n == 0 || run.total_ticks < result->total_ticks)
+		{
+			*result = run;
+		}
+	}
+}
+
+
+/******************************************************************************
+ * @brief timing table, then the compensation error table; the JSON array
+ * 		  holds both, exactness entries with "suite": "exactness"
+*/
+static void bench_report(const bench_result_struct *results, uint32_t result_count,
+						 const bmp280_benchmark_exactness_struct exactness[BMP280_BENCHMARK_COUNT], FILE *json)
+{
+	if (json != NULL)
+	{
+		fprintf(json, "[\n");
+	}
+
+	for (uint32_t n = 0; n < result_count; n++)
+	{
+		double per_item = (double)results[n].total_ticks / results[n].item_count;
+
+		printf("%-13s %-20s %10.2f %s/item  (%lu items)\n", results[n].suite, results[n].name, per_item, SENSOR_CYCLES_UNIT,
+			   (unsigned long)results[n].item_count);
+		if (json != NULL)
+		{
+			fprintf(json, "  {\"suite\": \"%s\", \"name\": \"%s\", \"unit\": \"%s\", \"per_item\": %.2f, \"items\": %lu, \"checksum\": %lld},\n",
+					results[n].suite, results[n].name, SENSOR_CYCLES_UNIT, per_item, (unsigned long)results[n].item_count,
+					(long long)results[n].checksum);
+		}
+	}
+
+	printf("\n%-13s %-20s %10s %10s %10s %10s\n", "exactness", "", "samples", "mismatch", "max T/100", "max P/256");
+	for (uint8_t n = 0; n < BMP280_BENCHMARK_COUNT; n++)
+	{
+		printf("%-13s %-20s %10lu %10lu %10lu %10lu\n", "exactness", exactness[n].name, (unsigned long)exactness[n].sample_count,
+			   (unsigned long)exactness[n].mismatch_count, (unsigned long)exactness[n].max_temperature_error_100,
+			   (unsigned long)exactness[n].max_pressure_error_256);
+		if (json != NULL)
+		{
+			fprintf(json, "  {\"suite\": \"exactness\", \"name\": \"%s\", \"items\": %lu, \"mismatches\": %lu, \"max_temperature_error_100\": %lu, \"max_pressure_error_256\": %lu}%s\n",
+					exactness[n].name, (unsigned long)exactness[n].sample_count, (unsigned long)exactness[n].mismatch_count,
+					(unsigned long)exactness[n].max_temperature_error_100, (unsigned long)exactness[n].max_pressure_error_256,
+					(n + 1 < BMP280_BENCHMARK_COUNT) ? "," : "");
+		}
+	}
+
+	if (json != NULL)
+	{
+		fprintf(json, "]\n");
+	}
+}
@@ -0,0 +1,169 @@
+/*
+ * console_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Host stand-in for the USART2 console: the firmware command table
+ *  (Sensors/console/console_commands.c) on the sensor registry, with the
+ *  simulated BMP280 and VL6180X on the simulated I2C bus. Commands reach the
+ *  drivers' set_config/get_config exactly as on the board, so terminal
+ *  programs, scripts and console changes can be tried without one.
+ *  Clock, baud and memory commands answer from the Sim stand-ins.
+ *
+ *  The loop is acquisition_loop() with a 1 ms virtual tick per pass. The log
+ *  level starts at "error", "log info" shows the samples.
+ *
+ *  build: cmake --build build --target console_host
+ *
+ *  usage: console_host              open a PTY and print its name, connect with
+ *                                   e.g. "screen /dev/pts/N" or "picocom /dev/pts/N"
+ *         console_host --stdio      read commands from stdin, answer on stdout
+ *                                   (echo "sensors" | console_host --stdio)
+ */
+
+#define _XOPEN_SOURCE 600
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "hal_sim.h"
+
+#include "bmp280/bmp280_definitions.h"
+#include "common/sensor_format.h"
+#include "common/sensor_log.h"
+#include "common/sensor_registry.h"
+#include "console/console.h"
+#include "console/console_commands.h"
+#include "vl6180x/vl6180x_definitions.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static void console_host_print_sample(const sensor_driver_struct *driver, const sensor_sample_struct *sample);
+
+
+//=============================================================================
+//	main
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	int input_fd = STDIN_FILENO;
+	FILE *output = stdout;
+	struct pollfd input = {0};
+	uint8_t byte;
+	bool is_open = true;
+
+	if (argc > 1 && strcmp(argv[1], "--stdio") != 0)
+	{
+		fprintf(stderr, "usage: %s [--stdio]\n", argv[0]);
+		return 1;
+	}
+
+	if (argc == 1)
+	{
+		int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+		int slave_fd = -1;
+		struct termios settings;
+
+		if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0)
+		{
+			perror("posix_openpt");
+			return 1;
+		}
+
+		// raw like the UART, otherwise the boot output is echoed back as input.
+		// The slave stays open so the PTY survives terminal programs reconnecting.
+		slave_fd = open(ptsname(master_fd), O_RDWR | O_NOCTTY);
+		if (slave_fd < 0 || tcgetattr(slave_fd, &settings) != 0)
+		{
+			perror("open pts");
+			return 1;
+		}
+		settings.c_iflag &= ~(tcflag_t)(ICRNL | INLCR | IGNCR | IXON);
+		settings.c_oflag &= ~(tcflag_t)OPOST;
+		settings.c_lflag &= ~(tcflag_t)(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+		tcsetattr(slave_fd, TCSANOW, &settings);
+
+		printf("console on %s\n", ptsname(master_fd));
+		fflush(stdout);
+
+		input_fd = master_fd;
+		output = fdopen(master_fd, "w");
+		if (output == NULL)
+		{
+			perror("fdopen");
+			return 1;
+		}
+		setvbuf(output, NULL, _IONBF, 0);
+	}
+	hal_sim_uart_set_output(output);
+
+	// register trace frames and sample lines off, see "log"
+	sensor_log_level = SENSOR_LOG_LEVEL_ERROR;
+
+	hal_sim_bmp280_attach(BMP280_I2C_DEVICE_ADDRESS);
+	hal_sim_vl6180x_attach(VL6180X_I2C_DEVICE_ADDRESS);
+	sensor_registry_probe();
+	console_commands_initialize();
+
+	input.fd = input_fd;
+	input.events = POLLIN;
+
+	while (is_open == true)
+	{
+		// one byte at a time, the same path the RX interrupt takes on the target
+		if (poll(&input, 1, 1) > 0)
+		{
+			is_open = (read(input_fd, &byte, 1) == 1);
+			if (is_open == true)
+			{
+				console_receive_byte(byte);
+			}
+		}
+
+		sensor_registry_service(&console_host_print_sample);
+		console_process();
+		fflush(output);
+
+		hal_sim_advance_ms(1);
+	}
+
+	return 0;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief sample line of acquisition_print_sample() in main.c
+*/
+static void console_host_print_sample(const sensor_driver_struct *driver, const sensor_sample_struct *sample)
+{
+	char line[64];
+	sensor_format_struct format;
+
+	if (SENSOR_LOG_ENABLED(SENSOR_LOG_LEVEL_INFO))
+	{
+		sensor_format_initialize(&format, line, sizeof(line));
+		sensor_format_text(&format, driver->name);
+		sensor_format_text(&format, ": ");
+		sensor_format_int(&format, sample->value, 0);
+		sensor_format_char(&format, ' ');
+		sensor_format_text(&format, driver->unit);
+		sensor_format_text(&format, " @ ");
+		sensor_format_uint(&format, sample->timestamp_ms, 0);
+		sensor_format_text(&format, " ms\r\n");
+		HAL_UART_Transmit(&huart2, (const uint8_t *)line, format.length, HAL_MAX_DELAY);
+	}
+}
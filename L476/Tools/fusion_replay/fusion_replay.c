@@ -0,0 +1,236 @@
+/*
+ * fusion_replay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Host replay harness for Sensors/filter/fusion.c
+ *
+ *  build: gcc -O2 -I../../Sensors fusion_replay.c ../../Sensors/filter/fusion.c -lm -o fusion_replay
+ *
+ *  usage: fusion_replay <trace.csv>     replay a recorded trace and score it
+ *         fusion_replay --generate      write a synthetic trace to stdout
+ *
+ *  trace format, one sample per line ('#' starts a comment):
+ *         time_ms,source,value_mm,truth_mm
+ *         source:   T = VL6180X distance, B = BMP280 altitude delta
+ *         value_mm: measured value, empty or "nan" for an invalid sample
+ *         truth_mm: reference height above surface, empty if unknown
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "filter/fusion.h"
+#include "common/sensor_cycles.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+
+// filter tuning used for replay, matches the firmware defaults
+#define FUSION_REPLAY_HEIGHT_PROCESS_NOISE_UM2_PER_MS (50000)        // (0.22 mm)^2 per ms
+#define FUSION_REPLAY_OFFSET_PROCESS_NOISE_UM2_PER_MS (25000)        // barometer drift
+#define FUSION_REPLAY_DISTANCE_NOISE_UM2              (4000000)      // (2 mm)^2
+#define FUSION_REPLAY_ALTITUDE_NOISE_UM2              (22500000000)  // (150 mm)^2
+
+// VL6180X range at 1x scaling
+#define FUSION_REPLAY_TOF_MAX_MM (200.0)
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	double squared_error_sum;
+	double max_error;
+	uint32_t count;
+}fusion_replay_score_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static int fusion_replay_generate();
+static int fusion_replay_run(const char *path);
+static void fusion_replay_score(fusion_replay_score_struct *score, double estimate_mm, double truth_mm);
+static void fusion_replay_print_score(const char *name, const fusion_replay_score_struct *score);
+static double fusion_replay_noise(double sigma);
+
+
+int main(int argc, char **argv)
+{
+	int result = 1;
+
+	if (argc == 2 && strcmp(argv[1], "--generate") == 0)
+	{
+		result = fusion_replay_generate();
+	}
+	else if (argc == 2)
+	{
+		result = fusion_replay_run(argv[1]);
+	}
+	else
+	{
+		fprintf(stderr, "usage: %s <trace.csv> | --generate\n", argv[0]);
+	}
+
+	return result;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief synthetic trace: target moves out of ToF range and back.
+ * 		  ToF at 50 Hz, barometer at 25 Hz with a slow drift.
+*/
+static int fusion_replay_generate()
+{
+	printf("# time_ms,source,value_mm,truth_mm\n");
+
+	for (uint32_t time_ms = 0; time_ms < 60000; time_ms += 20)
+	{
+		double t = time_ms / 1000.0;
+		double truth_mm = 120.0 + 150.0 * sin(t * 0.2);
+		double drift_mm = 5.0 * t;
+
+		if (truth_mm < FUSION_REPLAY_TOF_MAX_MM)
+		{
+			printf("%u,T,%.1f,%.3f\n", time_ms, truth_mm + fusion_replay_noise(2.0), truth_mm);
+		}
+		else
+		{
+			printf("%u,T,nan,%.3f\n", time_ms, truth_mm);
+		}
+
+		if (time_ms % 40 == 0)
+		{
+			printf("%u,B,%.1f,%.3f\n", time_ms, 1000.0 + truth_mm + drift_mm + fusion_replay_noise(150.0), truth_mm);
+		}
+	}
+
+	return 0;
+}
+
+
+/******************************************************************************
+ * @brief replay a trace through the fusion filter and score the estimate
+ * 		  against the truth column. The last valid ToF sample is scored as
+ * 		  baseline.
+*/
+static int fusion_replay_run(const char *path)
+{
+	FILE *trace = fopen(path, "r");
+	char line[256];
+	fusion_struct fusion;
+	fusion_replay_score_struct fused_score = {0};
+	fusion_replay_score_struct tof_score = {0};
+	uint32_t previous_time_ms = 0;
+	uint64_t update_ticks = 0;
+	uint32_t update_count = 0;
+	double last_tof_mm = NAN;
+
+	if (trace == NULL)
+	{
+		perror(path);
+		return 1;
+	}
+
+	fusion_initialize(&fusion, FUSION_REPLAY_HEIGHT_PROCESS_NOISE_UM2_PER_MS, FUSION_REPLAY_OFFSET_PROCESS_NOISE_UM2_PER_MS, FUSION_REPLAY_DISTANCE_NOISE_UM2, FUSION_REPLAY_ALTITUDE_NOISE_UM2);
+
+	while (fgets(line, sizeof(line), trace) != NULL)
+	{
+		uint32_t time_ms;
+		char source;
+		char value[32] = "";
+		char truth[32] = "";
+
+		if (line[0] == '#' || sscanf(line, "%u,%c,%31[^,\n],%31[^,\n]", &time_ms, &source, value, truth) < 2)
+		{
+			continue;
+		}
+
+		double value_mm = (value[0] == '\0') ? NAN : strtod(value, NULL);
+		double truth_mm = (truth[0] == '\0') ? NAN : strtod(truth, NULL);
+
+		uint32_t start = sensor_cycles_now();
+
+		fusion_predict(&fusion, time_ms - previous_time_ms);
+		if (isnan(value_mm) == false && source == 'T')
+		{
+			fusion_update_distance(&fusion, (int32_t)(value_mm * 1000), 255);
+		}
+		else if (isnan(value_mm) == false && source == 'B')
+		{
+			fusion_update_altitude(&fusion, (int32_t)(value_mm * 1000));
+		}
+		fusion_estimate_struct estimate = fusion_get_estimate(&fusion);
+
+		update_ticks += sensor_cycles_now() - start;
+		update_count++;
+		previous_time_ms = time_ms;
+
+		if (source == 'T' && isnan(value_mm) == false)
+		{
+			last_tof_mm = value_mm;
+		}
+
+		if (isnan(truth_mm) == false)
+		{
+			fusion_replay_score(&fused_score, estimate.height_um / 1000.0, truth_mm);
+			if (isnan(last_tof_mm) == false)
+			{
+				fusion_replay_score(&tof_score, last_tof_mm, truth_mm);
+			}
+		}
+	}
+
+	fclose(trace);
+
+	fusion_replay_print_score("fused", &fused_score);
+	fusion_replay_print_score("tof_hold", &tof_score);
+	printf("update_time_%s=%.1f\n", SENSOR_CYCLES_UNIT, update_count ? (double)update_ticks / update_count : 0.0);
+
+	return 0;
+}
+
+
+static void fusion_replay_score(fusion_replay_score_struct *score, double estimate_mm, double truth_mm)
+{
+	double error = fabs(estimate_mm - truth_mm);
+
+	score->squared_error_sum += error * error;
+	score->max_error = (error > score->max_error) ? error : score->max_error;
+	score->count++;
+}
+
+
+static void fusion_replay_print_score(const char *name, const fusion_replay_score_struct *score)
+{
+	double rmse = score->count ? sqrt(score->squared_error_sum / score->count) : 0.0;
+
+	printf("%s: samples=%u rmse_mm=%.3f max_error_mm=%.3f\n", name, score->count, rmse, score->max_error);
+}
+
+
+/******************************************************************************
+ * @brief gaussian noise (Box-Muller), fixed seed for reproducible traces
+*/
+static double fusion_replay_noise(double sigma)
+{
+	static uint32_t random = 1;
+
+	random = random * 1664525 + 1013904223;
+	double u1 = ((random >> 8) + 1.0) / 16777217.0;
+	random = random * 1664525 + 1013904223;
+	double u2 = ((random >> 8) + 1.0) / 16777217.0;
+
+	return sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
@@ -0,0 +1,835 @@
+/*
+ * i2c_replay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Host replay of register traces recorded by Sensors/common/sensor_record.h
+ *
+ *  build: cmake -S ../.. -B build && cmake --build build --target i2c_replay
+ *
+ *  usage: i2c_replay extract <console.log> <trace.bin>
+ *         i2c_replay list <trace.bin>
+ *         i2c_replay run <trace.bin> [--strict] [--repeat <n>] [-o <samples.csv>]
+ *         i2c_replay record <ms> <trace.bin>
+ *         i2c_replay check [<ms>]
+ *
+ *  extract  collect the "rec" lines of a "record dump" from a console log
+ *  list     print one line per transaction
+ *  run      replay the trace through the firmware acquisition path at full
+ *           speed: sensor_registry_probe(), then sensor_registry_service()
+ *           passes as in acquisition_loop(), the drivers unchanged down to
+ *           HAL_I2C_Mem_Read/Write. The simulated bus answers every transfer
+ *           with the next recorded transaction of that device with the same
+ *           direction, register and length. Recorded transactions the host
+ *           sequence does not ask for are skipped, with --strict every skip
+ *           fails the run. Written data that differs from the recording
+ *           counts as a mismatch. -o writes the samples the registry
+ *           delivers as time_ms,sensor,value.
+ *  record   record an acquisition_loop() session of the simulated BMP280
+ *           and VL6180X (Sim/) on the host, <ms> of virtual time
+ *  check    record <ms> (default 2000) like "record", replay that trace with
+ *           --strict and compare the delivered samples with the recorded
+ *           session
+ *
+ *  The trace must include the sensor probing and initialization (trimming,
+ *  scaling), so record on the board with SENSOR_RECORD_AT_BOOT=1. Exit code
+ *  1 on any divergence or mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal_sim.h"
+
+#include "bmp280/bmp280_definitions.h"
+#include "common/sensor_cycles.h"
+#include "common/sensor_log.h"
+#include "common/sensor_record.h"
+#include "common/sensor_registry.h"
+#include "vl6180x/vl6180x_definitions.h"
+
+
+//=============================================================================
+//	defines
+//=============================================================================
+#define I2C_REPLAY_CHECK_DURATION_MS	(2000)
+#define I2C_REPLAY_STALL_MS				(1000)		// no transfer asked for although the trace goes on
+
+
+//=============================================================================
+//	types
+//=============================================================================
+typedef struct
+{
+	uint32_t time_us;			// since the first transaction
+	uint8_t device;
+	bool is_write;
+	bool is_failed;
+	uint16_t register_address;
+	uint8_t length;
+	const uint8_t *data;		// NULL for a failed transaction
+}i2c_replay_transaction_struct;
+
+typedef struct
+{
+	uint32_t served_count;
+	uint32_t skipped_count;
+	uint32_t mismatch_count;	// written data differs
+	uint32_t divergence_count;	// request without a recorded counterpart, or no request although the trace goes on
+	uint32_t unserved_count;	// left in the trace at the end of the replay
+}i2c_replay_stats_struct;
+
+typedef struct
+{
+	const sensor_driver_struct *driver;
+	uint32_t timestamp_ms;
+	int32_t value;
+}i2c_replay_sample_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static int i2c_replay_extract(const char *log_path, const char *trace_path);
+static int i2c_replay_list(const char *trace_path);
+static int i2c_replay_run(const char *trace_path, bool is_strict, uint32_t repeat_count, const char *samples_path);
+static int i2c_replay_record(uint32_t duration_ms, const char *trace_path);
+static int i2c_replay_check(uint32_t duration_ms);
+static bool i2c_replay_acquire(uint32_t duration_ms);
+static void i2c_replay_pass(FILE *samples);
+static bool i2c_replay_report();
+static bool i2c_replay_load(const char *trace_path);
+static bool i2c_replay_index(const char *name, uint32_t size);
+static bool i2c_replay_get_next_time(uint32_t *time_us);
+static bool i2c_replay_has_remaining(uint8_t device);
+static const i2c_replay_transaction_struct *i2c_replay_serve(uint8_t device, bool is_write, uint16_t register_address, uint16_t data_length);
+static HAL_StatusTypeDef i2c_replay_read(uint8_t device, uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef i2c_replay_write(uint8_t device, uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef i2c_replay_bmp280_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef i2c_replay_bmp280_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef i2c_replay_vl6180x_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length);
+static HAL_StatusTypeDef i2c_replay_vl6180x_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length);
+static void i2c_replay_collect(const sensor_driver_struct *driver, const sensor_sample_struct *sample);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static const char *const i2c_replay_device_names[SENSOR_RECORD_DEVICE_COUNT] = {"BMP280", "VL6180X"};
+
+static uint8_t *i2c_replay_trace;
+static i2c_replay_transaction_struct *i2c_replay_transactions;
+static uint32_t i2c_replay_transaction_count;
+
+// replay state, one cursor per device
+static uint32_t i2c_replay_cursor[SENSOR_RECORD_DEVICE_COUNT];
+static bool i2c_replay_is_strict = false;
+static bool i2c_replay_is_trace_end;
+static uint32_t i2c_replay_start_tick_ms;
+static i2c_replay_stats_struct i2c_replay_stats;
+
+// samples handed to the registry handler, optionally also written as CSV
+static i2c_replay_sample_struct *i2c_replay_samples;
+static uint32_t i2c_replay_sample_count;
+static uint32_t i2c_replay_sample_capacity;
+static FILE *i2c_replay_samples_file;
+
+
+//=============================================================================
+//	main
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	// driver output off, UART traffic discarded
+	sensor_log_level = SENSOR_LOG_LEVEL_OFF;
+	hal_sim_uart_set_output(NULL);
+
+	if (argc == 4 && strcmp(argv[1], "extract") == 0)
+	{
+		return i2c_replay_extract(argv[2], argv[3]);
+	}
+	if (argc == 3 && strcmp(argv[1], "list") == 0)
+	{
+		return i2c_replay_list(argv[2]);
+	}
+	if (argc == 4 && strcmp(argv[1], "record") == 0)
+	{
+		return i2c_replay_record((uint32_t)strtoul(argv[2], NULL, 0), argv[3]);
+	}
+	if ((argc == 2 || argc == 3) && strcmp(argv[1], "check") == 0)
+	{
+		return i2c_replay_check((argc == 3) ? (uint32_t)strtoul(argv[2], NULL, 0) : I2C_REPLAY_CHECK_DURATION_MS);
+	}
+	if (argc >= 3 && strcmp(argv[1], "run") == 0)
+	{
+		bool is_strict = false;
+		uint32_t repeat_count = 1;
+		const char *samples_path = NULL;
+		bool is_valid = true;
+
+		for (int n = 3; n < argc && is_valid == true; n++)
+		{
+			if (strcmp(argv[n], "--strict") == 0)
+			{
+				is_strict = true;
+			}
+			else if (strcmp(argv[n], "--repeat") == 0 && n + 1 < argc)
+			{
+				repeat_count = (uint32_t)strtoul(argv[++n], NULL, 0);
+			}
+			else if (strcmp(argv[n], "-o") == 0 && n + 1 < argc)
+			{
+				samples_path = argv[++n];
+			}
+			else
+			{
+				is_valid = false;
+			}
+		}
+		if (is_valid == true)
+		{
+			return i2c_replay_run(argv[2], is_strict, (repeat_count == 0) ? 1 : repeat_count, samples_path);
+		}
+	}
+
+	fprintf(stderr, "usage: %s extract <console.log> <trace.bin>\n"
+					"       %s list <trace.bin>\n"
+					"       %s run <trace.bin> [--strict] [--repeat <n>] [-o <samples.csv>]\n"
+					"       %s record <ms> <trace.bin>\n"
+					"       %s check [<ms>]\n", argv[0], argv[0], argv[0], argv[0], argv[0]);
+	return 1;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief hex payload of every "rec " line up to "rec end <length>", the
+ * 		  length checks that no line was lost on the UART
+*/
+static int i2c_replay_extract(const char *log_path, const char *trace_path)
+{
+	FILE *log = fopen(log_path, "r");
+	FILE *trace;
+	char line[256];
+	unsigned long expected_length = 0;
+	unsigned long length = 0;
+	bool is_complete = false;
+
+	if (log == NULL)
+	{
+		perror(log_path);
+		return 1;
+	}
+	trace = fopen(trace_path, "wb");
+	if (trace == NULL)
+	{
+		perror(trace_path);
+		fclose(log);
+		return 1;
+	}
+
+	while (is_complete == false && fgets(line, sizeof(line), log) != NULL)
+	{
+		char *text = strstr(line, "rec ");
+
+		if (text == NULL)
+		{
+			continue;
+		}
+		text += 4;
+
+		if (sscanf(text, "end %lu", &expected_length) == 1)
+		{
+			is_complete = true;
+			continue;
+		}
+
+		// a new dump in the same log starts over, "49324352" is the hex of "I2CR"
+		if (strncmp(text, "49324352", 8) == 0)
+		{
+			fseek(trace, 0, SEEK_SET);
+			length = 0;
+		}
+
+		for (unsigned int byte; sscanf(text, "%2x", &byte) == 1; text += 2)
+		{
+			fputc((int)byte, trace);
+			length++;
+		}
+	}
+
+	fclose(log);
+	fclose(trace);
+
+	if (is_complete == false || length != expected_length)
+	{
+		fprintf(stderr, "%s: incomplete dump, %lu of %lu bytes\n", log_path, length, expected_length);
+		return 1;
+	}
+	printf("%lu bytes\n", length);
+
+	return 0;
+}
+
+
+static int i2c_replay_list(const char *trace_path)
+{
+	if (i2c_replay_load(trace_path) == false)
+	{
+		return 1;
+	}
+
+	for (uint32_t n = 0; n < i2c_replay_transaction_count; n++)
+	{
+		const i2c_replay_transaction_struct *t = &i2c_replay_transactions[n];
+
+		printf("%10lu us %-7s %s 0x%03X %3u", (unsigned long)t->time_us, i2c_replay_device_names[t->device], t->is_write ? "W" : "R",
+			   (unsigned int)t->register_address, (unsigned int)t->length);
+		for (uint16_t k = 0; t->data != NULL && k < t->length; k++)
+		{
+			printf(" %02X", (unsigned int)t->data[k]);
+		}
+		printf("%s\n", t->is_failed ? " failed" : "");
+	}
+
+	return 0;
+}
+
+
+/******************************************************************************
+ * @brief replay `repeat_count` times, samples are written on the first pass
+ * 		  and the fastest pass is reported against the recorded duration
+*/
+static int i2c_replay_run(const char *trace_path, bool is_strict, uint32_t repeat_count, const char *samples_path)
+{
+	FILE *samples = NULL;
+	uint32_t best_ns = 0;
+	uint32_t duration_us;
+	bool result;
+
+	if (i2c_replay_load(trace_path) == false)
+	{
+		return 1;
+	}
+	if (samples_path != NULL && (samples = fopen(samples_path, "w")) == NULL)
+	{
+		perror(samples_path);
+		return 1;
+	}
+
+	i2c_replay_is_strict = is_strict;
+	duration_us = (i2c_replay_transaction_count > 0) ? i2c_replay_transactions[i2c_replay_transaction_count - 1].time_us : 0;
+
+	for (uint32_t n = 0; n < repeat_count; n++)
+	{
+		uint32_t start = sensor_cycles_now();
+
+		i2c_replay_pass((n == 0) ? samples : NULL);
+
+		uint32_t elapsed_ns = sensor_cycles_now() - start;
+		best_ns = (n == 0 || elapsed_ns < best_ns) ? elapsed_ns : best_ns;
+	}
+
+	if (samples != NULL)
+	{
+		fclose(samples);
+	}
+
+	result = i2c_replay_report();
+	printf("recorded %.3f s, replayed in %.3f ms, %.0fx real time\n", duration_us / 1e6, best_ns / 1e6,
+		   (best_ns > 0) ? duration_us * 1e3 / best_ns : 0.0);
+
+	return (result == true) ? 0 : 1;
+}
+
+
+static int i2c_replay_record(uint32_t duration_ms, const char *trace_path)
+{
+	FILE *trace = fopen(trace_path, "wb");
+	uint32_t length;
+	const uint8_t *buffer;
+	bool result;
+
+	if (trace == NULL)
+	{
+		perror(trace_path);
+		return 1;
+	}
+
+	result = i2c_replay_acquire(duration_ms);
+
+	buffer = sensor_record_get_buffer(&length);
+	fwrite(buffer, 1, length, trace);
+	fclose(trace);
+
+	return (result == true) ? 0 : 1;
+}
+
+
+/******************************************************************************
+ * @brief round trip of an acquisition_loop() trace: the strict replay must
+ * 		  serve every transaction in order and the registry must deliver the
+ * 		  same samples as in the recorded session
+*/
+static int i2c_replay_check(uint32_t duration_ms)
+{
+	i2c_replay_sample_struct *recorded;
+	uint32_t recorded_count;
+	uint32_t replayed_cursor[SENSOR_RECORD_DEVICE_COUNT] = {0};
+	uint32_t difference_count = 0;
+	const uint8_t *buffer;
+	uint32_t length;
+	bool result = i2c_replay_acquire(duration_ms);
+
+	recorded = i2c_replay_samples;
+	recorded_count = i2c_replay_sample_count;
+	i2c_replay_samples = NULL;
+	i2c_replay_sample_count = 0;
+	i2c_replay_sample_capacity = 0;
+
+	if (result == true)
+	{
+		buffer = sensor_record_get_buffer(&length);
+		i2c_replay_trace = malloc(length);
+		result = (i2c_replay_trace != NULL);
+	}
+	if (result == true)
+	{
+		memcpy(i2c_replay_trace, buffer, length);
+		result = i2c_replay_index("check", length);
+	}
+	if (result == true)
+	{
+		i2c_replay_is_strict = true;
+		i2c_replay_pass(NULL);
+		result = i2c_replay_report();
+	}
+
+	// in order per sensor, the sensors may interleave differently by a pass
+	for (uint32_t n = 0; n < recorded_count; n++)
+	{
+		uint8_t index = 0;
+		uint32_t *k = &replayed_cursor[0];
+
+		if (sensor_registry_find(recorded[n].driver->name, &index) == true && index < SENSOR_RECORD_DEVICE_COUNT)
+		{
+			k = &replayed_cursor[index];
+		}
+		while (*k < i2c_replay_sample_count && i2c_replay_samples[*k].driver != recorded[n].driver)
+		{
+			(*k)++;
+		}
+		if (*k == i2c_replay_sample_count || i2c_replay_samples[(*k)++].value != recorded[n].value)
+		{
+			difference_count++;
+		}
+	}
+
+	printf("%lu samples recorded, %lu replayed, %lu differ\n", (unsigned long)recorded_count, (unsigned long)i2c_replay_sample_count,
+		   (unsigned long)difference_count);
+	free(recorded);
+
+	return (result == true && recorded_count > 0 && recorded_count == i2c_replay_sample_count && difference_count == 0) ? 0 : 1;
+}
+
+
+/******************************************************************************
+ * @brief acquisition_loop() with SENSOR_RECORD_AT_BOOT on the simulated
+ * 		  sensors: recording starts before the probe, then one
+ * 		  sensor_registry_service() pass per millisecond while the simulated
+ * 		  pressure and range drift. Every 16th range is a range error.
+ * 
+ * @param[out] true if both sensors were found and nothing was dropped
+*/
+static bool i2c_replay_acquire(uint32_t duration_ms)
+{
+	uint8_t sensor_count;
+	sensor_record_stats_struct stats;
+
+	hal_sim_i2c_detach_all();
+	hal_sim_bmp280_attach(BMP280_I2C_DEVICE_ADDRESS);
+	hal_sim_vl6180x_attach(VL6180X_I2C_DEVICE_ADDRESS);
+	i2c_replay_sample_count = 0;
+	i2c_replay_samples_file = NULL;
+
+	sensor_record_start();
+	sensor_count = sensor_registry_probe();
+
+	for (uint32_t ms = 0; ms < duration_ms && sensor_count > 0; ms++)
+	{
+		hal_sim_bmp280_set_adc(519888 + (ms / 10) % 4096, 415148 + (ms * 7 / 10) % 8192);
+		hal_sim_vl6180x_set_range((uint8_t)(20 + (ms / 100) % 150), ((ms / 100) % 16 == 15) ? 0x0B : 0);
+		sensor_registry_service(&i2c_replay_collect);
+		hal_sim_advance_ms(1);
+	}
+
+	sensor_record_stop();
+	sensor_record_get_stats(&stats);
+
+	printf("%u sensors, %lu samples, %lu transactions, %lu bytes, %lu dropped\n", (unsigned int)sensor_count,
+		   (unsigned long)i2c_replay_sample_count, (unsigned long)stats.transaction_count, (unsigned long)stats.length,
+		   (unsigned long)stats.dropped_count);
+
+	return (sensor_count == SENSOR_RECORD_DEVICE_COUNT && stats.dropped_count == 0);
+}
+
+
+/******************************************************************************
+ * @brief one replay of the whole trace through acquisition_loop()'s calls:
+ * 		  the recorded devices answer on the simulated bus, the registry
+ * 		  probes them and is serviced until the trace is used up. Between
+ * 		  passes that asked for nothing the tick moves on to the next
+ * 		  recorded transaction.
+*/
+static void i2c_replay_pass(FILE *samples)
+{
+	uint32_t next_time_us;
+
+	memset(i2c_replay_cursor, 0, sizeof(i2c_replay_cursor));
+	memset(&i2c_replay_stats, 0, sizeof(i2c_replay_stats));
+	i2c_replay_is_trace_end = false;
+	i2c_replay_sample_count = 0;
+	i2c_replay_samples_file = samples;
+	i2c_replay_start_tick_ms = HAL_GetTick();
+
+	hal_sim_i2c_detach_all();
+	hal_sim_i2c_attach(BMP280_I2C_DEVICE_ADDRESS, &i2c_replay_bmp280_read, &i2c_replay_bmp280_write);
+	hal_sim_i2c_attach(VL6180X_I2C_DEVICE_ADDRESS, &i2c_replay_vl6180x_read, &i2c_replay_vl6180x_write);
+
+	if (samples != NULL)
+	{
+		fprintf(samples, "time_ms,sensor,value\n");
+	}
+
+	sensor_registry_probe();
+
+	while (i2c_replay_is_trace_end == false && i2c_replay_stats.divergence_count == 0 && i2c_replay_get_next_time(&next_time_us) == true)
+	{
+		uint32_t served_count = i2c_replay_stats.served_count;
+		uint32_t next_tick_ms = i2c_replay_start_tick_ms + next_time_us / 1000;
+
+		sensor_registry_service(&i2c_replay_collect);
+
+		if (i2c_replay_stats.served_count != served_count)
+		{
+			continue;
+		}
+
+		if ((int32_t)(next_tick_ms - HAL_GetTick()) > 0)
+		{
+			hal_sim_advance_ms(next_tick_ms - HAL_GetTick());
+		}
+		else if (HAL_GetTick() - next_tick_ms < I2C_REPLAY_STALL_MS)
+		{
+			hal_sim_advance_ms(1);
+		}
+		else
+		{
+			i2c_replay_stats.divergence_count++;
+		}
+	}
+
+	for (uint32_t n = 0; n < i2c_replay_transaction_count; n++)
+	{
+		i2c_replay_stats.unserved_count += (n >= i2c_replay_cursor[i2c_replay_transactions[n].device]) ? 1 : 0;
+	}
+}
+
+
+/******************************************************************************
+ * @brief replay and registry statistics of the last pass
+ * 
+ * @param[out] true if the replay followed the trace (strict: without skips)
+*/
+static bool i2c_replay_report()
+{
+	i2c_replay_stats_struct *stats = &i2c_replay_stats;
+	sensor_registry_stats_struct sensor_stats;
+
+	printf("%lu transactions, %lu served, %lu skipped, %lu unserved, %lu mismatches, %lu divergences\n",
+		   (unsigned long)i2c_replay_transaction_count, (unsigned long)stats->served_count, (unsigned long)stats->skipped_count,
+		   (unsigned long)stats->unserved_count, (unsigned long)stats->mismatch_count, (unsigned long)stats->divergence_count);
+	for (uint8_t n = 0; sensor_registry_get_stats(n, &sensor_stats) == true; n++)
+	{
+		printf("%-7s %lu samples, %lu invalid, %lu not ready, %lu errors\n", sensor_registry_get_driver(n)->name,
+			   (unsigned long)sensor_stats.sample_count, (unsigned long)sensor_stats.invalid_count,
+			   (unsigned long)sensor_stats.not_ready_count, (unsigned long)sensor_stats.error_count);
+	}
+
+	return (stats->mismatch_count == 0 && stats->divergence_count == 0 &&
+			(i2c_replay_is_strict == false || (stats->skipped_count == 0 && stats->unserved_count == 0)));
+}
+
+
+/******************************************************************************
+ * @brief read a trace file into i2c_replay_trace and index it
+*/
+static bool i2c_replay_load(const char *trace_path)
+{
+	FILE *file = fopen(trace_path, "rb");
+	long size;
+	bool result = (file != NULL);
+
+	if (result == true)
+	{
+		result = (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= SENSOR_RECORD_HEADER_LENGTH && fseek(file, 0, SEEK_SET) == 0);
+	}
+	if (result == true)
+	{
+		i2c_replay_trace = malloc((size_t)size);
+		result = (i2c_replay_trace != NULL && fread(i2c_replay_trace, 1, (size_t)size, file) == (size_t)size);
+	}
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+	if (result == false)
+	{
+		perror(trace_path);
+		return false;
+	}
+
+	return i2c_replay_index(trace_path, (uint32_t)size);
+}
+
+
+/******************************************************************************
+ * @brief index the `size` bytes in i2c_replay_trace, the data stays there
+*/
+static bool i2c_replay_index(const char *name, uint32_t size)
+{
+	uint32_t offset = SENSOR_RECORD_HEADER_LENGTH;
+	uint32_t time_us = 0;
+	bool result = true;
+
+	if (size < SENSOR_RECORD_HEADER_LENGTH || memcmp(i2c_replay_trace, SENSOR_RECORD_MAGIC, 4) != 0 || i2c_replay_trace[4] != SENSOR_RECORD_VERSION)
+	{
+		fprintf(stderr, "%s: not a version %u register trace\n", name, (unsigned int)SENSOR_RECORD_VERSION);
+		return false;
+	}
+
+	// at least 5 bytes per transaction
+	i2c_replay_transactions = malloc(sizeof(i2c_replay_transaction_struct) * (size / 5 + 1));
+	if (i2c_replay_transactions == NULL)
+	{
+		perror(name);
+		return false;
+	}
+
+	i2c_replay_transaction_count = 0;
+	while (result == true && offset < size)
+	{
+		i2c_replay_transaction_struct *t = &i2c_replay_transactions[i2c_replay_transaction_count];
+		uint8_t flags = i2c_replay_trace[offset++];
+		uint32_t delta_us = 0;
+		uint8_t shift = 0;
+		uint8_t byte;
+
+		do
+		{
+			byte = (offset < size) ? i2c_replay_trace[offset++] : 0;
+			delta_us |= (uint32_t)(byte & 0x7F) << shift;
+			shift += 7;
+		}
+		while ((byte & 0x80) != 0 && shift < 35);
+
+		time_us += delta_us;
+		t->time_us = time_us;
+		t->device = flags & SENSOR_RECORD_FLAG_DEVICE_MASK;
+		t->is_write = (flags & SENSOR_RECORD_FLAG_WRITE) != 0;
+		t->is_failed = (flags & SENSOR_RECORD_FLAG_FAILED) != 0;
+		result = (offset + 3 <= size && t->device < SENSOR_RECORD_DEVICE_COUNT);
+		if (result == true)
+		{
+			t->register_address = (uint16_t)(i2c_replay_trace[offset] | (i2c_replay_trace[offset + 1] << 8));
+			t->length = i2c_replay_trace[offset + 2];
+			t->data = (t->is_failed == true) ? NULL : &i2c_replay_trace[offset + 3];
+			offset += 3 + ((t->is_failed == true) ? 0 : t->length);
+			result = (offset <= size);
+		}
+		i2c_replay_transaction_count += (result == true) ? 1 : 0;
+	}
+
+	if (result == false)
+	{
+		fprintf(stderr, "%s: truncated after %lu transactions\n", name, (unsigned long)i2c_replay_transaction_count);
+	}
+
+	return result;
+}
+
+
+// time of the first transaction not served yet
+static bool i2c_replay_get_next_time(uint32_t *time_us)
+{
+	for (uint32_t n = 0; n < i2c_replay_transaction_count; n++)
+	{
+		if (n >= i2c_replay_cursor[i2c_replay_transactions[n].device])
+		{
+			*time_us = i2c_replay_transactions[n].time_us;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+// recorded transactions of the device after its cursor
+static bool i2c_replay_has_remaining(uint8_t device)
+{
+	for (uint32_t n = i2c_replay_cursor[device]; n < i2c_replay_transaction_count; n++)
+	{
+		if (i2c_replay_transactions[n].device == device)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/******************************************************************************
+ * @brief find the recorded counterpart of one driver transfer and move the
+ * 		  device's cursor past it. The virtual tick follows the recorded
+ * 		  time, so tick based driver logic sees the recorded timing. A
+ * 		  device without any recorded transaction does not answer (probe:
+ * 		  not found), one whose transactions are used up ends the replay.
+ *
+ * @param[out] the recorded transaction, NULL without a matching one
+*/
+static const i2c_replay_transaction_struct *i2c_replay_serve(uint8_t device, bool is_write, uint16_t register_address, uint16_t data_length)
+{
+	uint32_t skipped_count = 0;
+	uint32_t n;
+
+	if (i2c_replay_has_remaining(device) == false)
+	{
+		i2c_replay_is_trace_end |= (i2c_replay_cursor[device] > 0);
+		return NULL;
+	}
+
+	for (n = i2c_replay_cursor[device]; n < i2c_replay_transaction_count; n++)
+	{
+		const i2c_replay_transaction_struct *t = &i2c_replay_transactions[n];
+
+		if (t->device != device)
+		{
+			continue;
+		}
+		if (t->is_write == is_write && t->register_address == register_address && t->length == data_length)
+		{
+			break;
+		}
+		if (i2c_replay_is_strict == true)
+		{
+			n = i2c_replay_transaction_count;
+			break;
+		}
+		skipped_count++;
+	}
+
+	if (n >= i2c_replay_transaction_count)
+	{
+		i2c_replay_stats.divergence_count++;
+		return NULL;
+	}
+
+	const i2c_replay_transaction_struct *t = &i2c_replay_transactions[n];
+	uint32_t tick_ms = i2c_replay_start_tick_ms + t->time_us / 1000;
+
+	if ((int32_t)(tick_ms - HAL_GetTick()) > 0)
+	{
+		hal_sim_advance_ms(tick_ms - HAL_GetTick());
+	}
+
+	i2c_replay_cursor[device] = n + 1;
+	i2c_replay_stats.served_count++;
+	i2c_replay_stats.skipped_count += skipped_count;
+
+	return t;
+}
+
+
+static HAL_StatusTypeDef i2c_replay_read(uint8_t device, uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	const i2c_replay_transaction_struct *t = i2c_replay_serve(device, false, memory_address, data_length);
+
+	if (t != NULL && t->is_failed == false)
+	{
+		memcpy(data_buffer, t->data, data_length);
+	}
+
+	return (t != NULL && t->is_failed == false) ? HAL_OK : HAL_ERROR;
+}
+
+
+static HAL_StatusTypeDef i2c_replay_write(uint8_t device, uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length)
+{
+	const i2c_replay_transaction_struct *t = i2c_replay_serve(device, true, memory_address, data_length);
+
+	if (t != NULL && t->is_failed == false && memcmp(data_buffer, t->data, data_length) != 0)
+	{
+		i2c_replay_stats.mismatch_count++;
+	}
+
+	return (t != NULL && t->is_failed == false) ? HAL_OK : HAL_ERROR;
+}
+
+
+static HAL_StatusTypeDef i2c_replay_bmp280_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	return i2c_replay_read(SENSOR_RECORD_DEVICE_BMP280, memory_address, data_buffer, data_length);
+}
+
+
+static HAL_StatusTypeDef i2c_replay_bmp280_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length)
+{
+	return i2c_replay_write(SENSOR_RECORD_DEVICE_BMP280, memory_address, data_buffer, data_length);
+}
+
+
+static HAL_StatusTypeDef i2c_replay_vl6180x_read(uint16_t memory_address, uint8_t *data_buffer, uint16_t data_length)
+{
+	return i2c_replay_read(SENSOR_RECORD_DEVICE_VL6180X, memory_address, data_buffer, data_length);
+}
+
+
+static HAL_StatusTypeDef i2c_replay_vl6180x_write(uint16_t memory_address, const uint8_t *data_buffer, uint16_t data_length)
+{
+	return i2c_replay_write(SENSOR_RECORD_DEVICE_VL6180X, memory_address, data_buffer, data_length);
+}
+
+
+/******************************************************************************
+ * @brief sensor_registry_sample_handler, keeps every sample for the check
+*/
+static void i2c_replay_collect(const sensor_driver_struct *driver, const sensor_sample_struct *sample)
+{
+	if (i2c_replay_sample_count == i2c_replay_sample_capacity)
+	{
+		uint32_t capacity = (i2c_replay_sample_capacity == 0) ? 256 : i2c_replay_sample_capacity * 2;
+		i2c_replay_sample_struct *samples = realloc(i2c_replay_samples, sizeof(i2c_replay_sample_struct) * capacity);
+
+		if (samples == NULL)
+		{
+			return;
+		}
+		i2c_replay_samples = samples;
+		i2c_replay_sample_capacity = capacity;
+	}
+
+	i2c_replay_samples[i2c_replay_sample_count++] = (i2c_replay_sample_struct){driver, sample->timestamp_ms, sample->value};
+
+	if (i2c_replay_samples_file != NULL)
+	{
+		fprintf(i2c_replay_samples_file, "%lu,%s,%ld\n", (unsigned long)sample->timestamp_ms, driver->name, (long)sample->value);
+	}
+}
@@ -0,0 +1,352 @@
+/*
+ * trace_decode.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Host side of the deferred trace logging (Sensors/common/sensor_trace.h)
+ *
+ *  build: gcc -O2 -I../../Sensors trace_decode.c -o trace_decode
+ *
+ *  usage: trace_decode <firmware.elf> [capture]
+ *         trace_decode <firmware.elf> --list
+ *         decode a UART capture (default stdin) to text, console text passes
+ *         through unchanged, e.g.
+ *         picocom -b 115200 /dev/ttyACM0 | trace_decode Debug/L476.elf
+ *         --list prints the trace IDs with their format strings
+ *
+ *  The ELF must be the one flashed, IDs are addresses in its .sensor_trace
+ *  section and "%s" arguments addresses in its flash image. Only the
+ *  firmware (ELF32) is decodable: its linker script puts .sensor_trace at
+ *  address 0, host builds link it above 16 bits and position independent.
+ */
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/sensor_trace.h"
+
+
+//=============================================================================
+//	types
+//=============================================================================
+
+// allocated section with file contents, for "%s" arguments
+typedef struct
+{
+	uint32_t address;
+	uint32_t size;
+	const uint8_t *data;
+}trace_decode_section_struct;
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static int trace_decode_load(const char *path);
+static const char *trace_decode_get_string(uint32_t address);
+static void trace_decode_print(const char *format, const uint32_t *arguments, uint8_t argument_count);
+static int trace_decode_read(FILE *capture, uint8_t *data, size_t length);
+
+
+//=============================================================================
+//	variables
+//=============================================================================
+static uint8_t *trace_decode_elf = NULL;
+static trace_decode_section_struct trace_decode_formats = {0};
+static trace_decode_section_struct trace_decode_sections[64];
+static size_t trace_decode_section_count = 0;
+
+
+//=============================================================================
+//	main
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	FILE *capture = stdin;
+	int byte;
+	uint8_t header[3];
+	uint8_t payload[SENSOR_TRACE_MAX_ARGUMENTS * 4];
+	uint32_t arguments[SENSOR_TRACE_MAX_ARGUMENTS];
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <firmware.elf> [capture]\n       %s <firmware.elf> --list\n", argv[0], argv[0]);
+		return 1;
+	}
+	if (trace_decode_load(argv[1]) != 0)
+	{
+		return 1;
+	}
+
+	if (argc > 2 && strcmp(argv[2], "--list") == 0)
+	{
+		for (uint32_t offset = 0; offset < trace_decode_formats.size; offset += (uint32_t)strlen((const char *)&trace_decode_formats.data[offset]) + 1)
+		{
+			if (trace_decode_formats.data[offset] != '\0')
+			{
+				printf("%5lu  %s", (unsigned long)(trace_decode_formats.address + offset), (const char *)&trace_decode_formats.data[offset]);
+			}
+		}
+		return 0;
+	}
+
+	if (argc > 2 && (capture = fopen(argv[2], "rb")) == NULL)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	while ((byte = fgetc(capture)) != EOF)
+	{
+		if (byte != SENSOR_TRACE_FRAME_START)
+		{
+			putchar(byte);
+			continue;
+		}
+
+		// ID (LE16), argument count, arguments (LE32)
+		if (trace_decode_read(capture, header, sizeof(header)) != 0 || header[2] > SENSOR_TRACE_MAX_ARGUMENTS ||
+			trace_decode_read(capture, payload, (size_t)header[2] * 4) != 0)
+		{
+			fprintf(stderr, "truncated or corrupt trace frame\n");
+			continue;
+		}
+
+		uint32_t id = (uint32_t)header[0] | ((uint32_t)header[1] << 8);
+
+		for (uint8_t n = 0; n < header[2]; n++)
+		{
+			arguments[n] = (uint32_t)payload[n * 4] | ((uint32_t)payload[n * 4 + 1] << 8) |
+						   ((uint32_t)payload[n * 4 + 2] << 16) | ((uint32_t)payload[n * 4 + 3] << 24);
+		}
+
+		if (id >= trace_decode_formats.address && id - trace_decode_formats.address < trace_decode_formats.size)
+		{
+			trace_decode_print((const char *)&trace_decode_formats.data[id - trace_decode_formats.address], arguments, header[2]);
+		}
+		else
+		{
+			printf("<unknown trace ID %lu>\n", (unsigned long)id);
+		}
+		fflush(stdout);
+	}
+
+	return 0;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+/******************************************************************************
+ * @brief read the firmware ELF, keep .sensor_trace and every allocated
+ * 		  section with contents
+*/
+static int trace_decode_load(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	long size;
+
+	if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < (long)sizeof(Elf32_Ehdr))
+	{
+		perror(path);
+		return -1;
+	}
+	trace_decode_elf = malloc((size_t)size);
+	rewind(file);
+	if (trace_decode_elf == NULL || fread(trace_decode_elf, 1, (size_t)size, file) != (size_t)size)
+	{
+		perror(path);
+		return -1;
+	}
+	fclose(file);
+
+	if (memcmp(trace_decode_elf, ELFMAG, SELFMAG) != 0)
+	{
+		fprintf(stderr, "%s: not an ELF file\n", path);
+		return -1;
+	}
+	// 16 bit IDs and 32 bit "%s" addresses only resolve in the firmware image
+	if (trace_decode_elf[EI_CLASS] != ELFCLASS32)
+	{
+		fprintf(stderr, "%s: not a 32 bit firmware ELF, host builds are not decodable\n", path);
+		return -1;
+	}
+
+	const Elf32_Ehdr *elf_header = (const Elf32_Ehdr *)trace_decode_elf;
+	uint64_t section_offset = elf_header->e_shoff;
+	uint16_t section_count = elf_header->e_shnum;
+	uint16_t name_index = elf_header->e_shstrndx;
+	size_t header_size = sizeof(Elf32_Shdr);
+	uint64_t names_offset = 0;
+
+	if (section_offset + (uint64_t)section_count * header_size > (uint64_t)size || name_index >= section_count)
+	{
+		fprintf(stderr, "%s: corrupt section headers\n", path);
+		return -1;
+	}
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (uint16_t n = 0; n < section_count; n++)
+		{
+			const Elf32_Shdr *header = (const Elf32_Shdr *)(trace_decode_elf + section_offset + n * header_size);
+			trace_decode_section_struct section =
+			{
+				.address = header->sh_addr,
+				.size = header->sh_size,
+				.data = trace_decode_elf + header->sh_offset,
+			};
+
+			if (header->sh_type == SHT_NOBITS || (uint64_t)header->sh_offset + header->sh_size > (uint64_t)size)
+			{
+				continue;
+			}
+
+			// section names first, they are needed to find .sensor_trace
+			if (pass == 0 && n == name_index)
+			{
+				names_offset = (uint64_t)(section.data - trace_decode_elf);
+			}
+			else if (pass == 1 && strcmp((const char *)trace_decode_elf + names_offset + header->sh_name, ".sensor_trace") == 0)
+			{
+				trace_decode_formats = section;
+			}
+			else if (pass == 1 && (header->sh_flags & SHF_ALLOC) != 0 && trace_decode_section_count < sizeof(trace_decode_sections) / sizeof(trace_decode_sections[0]))
+			{
+				trace_decode_sections[trace_decode_section_count++] = section;
+			}
+		}
+	}
+
+	if (trace_decode_formats.size == 0)
+	{
+		fprintf(stderr, "%s: no .sensor_trace section\n", path);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static const char *trace_decode_get_string(uint32_t address)
+{
+	for (size_t n = 0; n < trace_decode_section_count; n++)
+	{
+		const trace_decode_section_struct *section = &trace_decode_sections[n];
+
+		if (address >= section->address && address - section->address < section->size &&
+			memchr(section->data + (address - section->address), '\0', section->size - (address - section->address)) != NULL)
+		{
+			return (const char *)section->data + (address - section->address);
+		}
+	}
+
+	return NULL;
+}
+
+
+/******************************************************************************
+ * @brief printf with the 32 bit arguments of a frame, length modifiers in the
+ * 		  format are replaced since every argument arrived as 32 bits
+*/
+static void trace_decode_print(const char *format, const uint32_t *arguments, uint8_t argument_count)
+{
+	uint8_t argument = 0;
+
+	while (*format != '\0')
+	{
+		char specification[32] = "%";
+		size_t length = 1;
+
+		if (*format != '%')
+		{
+			putchar(*format++);
+			continue;
+		}
+		format++;
+
+		// flags, width, precision
+		while (*format != '\0' && strchr("-+ #0123456789.", *format) != NULL && length < sizeof(specification) - 3)
+		{
+			specification[length++] = *format++;
+		}
+		while (*format != '\0' && strchr("hlLqjzt", *format) != NULL)
+		{
+			format++;
+		}
+
+		char conversion = *format;
+
+		if (conversion == '\0')
+		{
+			break;
+		}
+		format++;
+
+		if (conversion == '%')
+		{
+			putchar('%');
+			continue;
+		}
+		if (argument >= argument_count)
+		{
+			printf("<missing>");
+			continue;
+		}
+
+		uint32_t value = arguments[argument++];
+
+		switch (conversion)
+		{
+			case 'd':
+			case 'i':
+				specification[length++] = 'l';
+				specification[length++] = conversion;
+				printf(specification, (long)(int32_t)value);
+				break;
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+				specification[length++] = 'l';
+				specification[length++] = conversion;
+				printf(specification, (unsigned long)value);
+				break;
+			case 'c':
+				specification[length++] = 'c';
+				printf(specification, (int)value);
+				break;
+			case 's':
+			{
+				const char *text = trace_decode_get_string(value);
+
+				if (text != NULL)
+				{
+					specification[length++] = 's';
+					printf(specification, text);
+				}
+				else
+				{
+					printf("<0x%08lx>", (unsigned long)value);
+				}
+				break;
+			}
+			default:
+				printf("<0x%08lx>", (unsigned long)value);
+				break;
+		}
+	}
+}
+
+
+static int trace_decode_read(FILE *capture, uint8_t *data, size_t length)
+{
+	return (fread(data, 1, length, capture) == length) ? 0 : -1;
+}
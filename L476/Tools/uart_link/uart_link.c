@@ -0,0 +1,201 @@
+/*
+ * uart_link.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Aniel
+ *
+ *  Host side of the console line rate switch (Sensors/console/console_uart.h)
+ *
+ *  build: gcc -O2 -I../../Sensors uart_link.c -o uart_link
+ *
+ *  usage: uart_link <tty> <rate> [current rate]
+ *         uart_link <tty> auto <rate> [current rate]
+ *         switch the board and the tty to <rate>, current rate defaults to
+ *         115200, e.g.
+ *         uart_link /dev/ttyACM0 921600 && picocom -b 921600 /dev/ttyACM0
+ *         with "auto" the board measures <rate> from the sync byte instead
+ *         of parsing it
+ *
+ *  The tty is left at the new rate on success and at the old one otherwise.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "console/console_uart.h"
+
+
+//=============================================================================
+//	static function declerations
+//=============================================================================
+static speed_t uart_link_get_speed(uint32_t baud);
+static int uart_link_set_speed(int fd, uint32_t baud);
+static int uart_link_wait_for(int fd, const char *text, uint32_t timeout_ms);
+static uint32_t uart_link_now_ms();
+
+
+//=============================================================================
+//	main
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	const char *device = (argc > 2) ? argv[1] : NULL;
+	int is_auto = (argc > 2) && (strcmp(argv[2], "auto") == 0);
+	uint32_t baud;
+	uint32_t current_baud = CONSOLE_UART_DEFAULT_BAUD;
+	char command[32];
+	char answer[32];
+	int fd;
+
+	if (device == NULL || (is_auto && argc < 4))
+	{
+		fprintf(stderr, "usage: %s <tty> <rate> [current rate]\n       %s <tty> auto <rate> [current rate]\n", argv[0], argv[0]);
+		return 1;
+	}
+
+	baud = (uint32_t)strtoul(argv[is_auto ? 3 : 2], NULL, 0);
+	if (argc > (is_auto ? 4 : 3))
+	{
+		current_baud = (uint32_t)strtoul(argv[is_auto ? 4 : 3], NULL, 0);
+	}
+	if (uart_link_get_speed(baud) == B0 || uart_link_get_speed(current_baud) == B0)
+	{
+		fprintf(stderr, "unsupported rate\n");
+		return 1;
+	}
+
+	fd = open(device, O_RDWR | O_NOCTTY);
+	if (fd < 0 || uart_link_set_speed(fd, current_baud) != 0)
+	{
+		perror(device);
+		return 1;
+	}
+
+	// a leading CR terminates whatever is in the board's line buffer
+	if (is_auto)
+	{
+		snprintf(command, sizeof(command), "\rbaud auto\r");
+		snprintf(answer, sizeof(answer), "baud auto switch");
+	}
+	else
+	{
+		snprintf(command, sizeof(command), "\rbaud %lu\r", (unsigned long)baud);
+		snprintf(answer, sizeof(answer), "baud %lu switch", (unsigned long)baud);
+	}
+	tcflush(fd, TCIOFLUSH);
+	if (write(fd, command, strlen(command)) != (ssize_t)strlen(command) || uart_link_wait_for(fd, answer, 500) != 0)
+	{
+		fprintf(stderr, "no answer at %lu baud\n", (unsigned long)current_baud);
+		return 1;
+	}
+
+	// same order as the board: switch, then repeat the sync byte until answered
+	tcdrain(fd);
+	uart_link_set_speed(fd, baud);
+
+	uint32_t start_ms = uart_link_now_ms();
+	int result = -1;
+	uint8_t sync = CONSOLE_UART_SYNC_BYTE;
+
+	while (result != 0 && uart_link_now_ms() - start_ms < CONSOLE_UART_SYNC_TIMEOUT_MS)
+	{
+		if (write(fd, &sync, 1) != 1)
+		{
+			break;
+		}
+		result = uart_link_wait_for(fd, " ok", CONSOLE_UART_SYNC_INTERVAL_MS);
+	}
+
+	if (result != 0)
+	{
+		uart_link_set_speed(fd, current_baud);
+		fprintf(stderr, "switch to %lu baud failed, board stays at %lu baud\n", (unsigned long)baud, (unsigned long)current_baud);
+		return 1;
+	}
+
+	printf("%lu baud\n", (unsigned long)baud);
+	close(fd);
+
+	return 0;
+}
+
+
+//=============================================================================
+//	static functions
+//=============================================================================
+
+static speed_t uart_link_get_speed(uint32_t baud)
+{
+	switch (baud)
+	{
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		case 460800:	return B460800;
+		case 921600:	return B921600;
+		case 1000000:	return B1000000;
+		case 1500000:	return B1500000;
+		case 2000000:	return B2000000;
+		default:		return B0;
+	}
+}
+
+
+static int uart_link_set_speed(int fd, uint32_t baud)
+{
+	struct termios tty;
+	int result = tcgetattr(fd, &tty);
+
+	if (result == 0)
+	{
+		cfmakeraw(&tty);
+		tty.c_cc[VMIN] = 0;
+		tty.c_cc[VTIME] = 0;
+		cfsetispeed(&tty, uart_link_get_speed(baud));
+		cfsetospeed(&tty, uart_link_get_speed(baud));
+		result = tcsetattr(fd, TCSADRAIN, &tty);
+	}
+
+	return result;
+}
+
+
+// 0 once `text` was seen in the input, -1 on timeout
+static int uart_link_wait_for(int fd, const char *text, uint32_t timeout_ms)
+{
+	uint32_t start_ms = uart_link_now_ms();
+	size_t length = strlen(text);
+	size_t matched = 0;
+	char byte;
+
+	while (matched < length && uart_link_now_ms() - start_ms < timeout_ms)
+	{
+		if (read(fd, &byte, 1) == 1)
+		{
+			matched = (byte == text[matched]) ? matched + 1 : (byte == text[0]) ? 1 : 0;
+		}
+		else
+		{
+			usleep(1000);
+		}
+	}
+
+	return (matched == length) ? 0 : -1;
+}
+
+
+static uint32_t uart_link_now_ms()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
@@ -0,0 +1,5 @@
+# Included by CMake after its per-language defaults (CMAKE_USER_MAKE_RULES_OVERRIDE
+# in arm-none-eabi.cmake), settings in the toolchain file itself are overwritten.
+
+set(CMAKE_C_OUTPUT_EXTENSION .o)
+set(CMAKE_ASM_OUTPUT_EXTENSION .o)
@@ -0,0 +1,36 @@
+# Toolchain file for the firmware build, e.g.
+#   cmake -S . -B build-arm -DCMAKE_TOOLCHAIN_FILE=cmake/arm-none-eabi.cmake -DCMAKE_BUILD_TYPE=Debug
+# The GNU Arm toolchain (STM32CubeIDE ships one) must be on PATH or its bin
+# directory given with -DARM_TOOLCHAIN_PATH=...
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(ARM_TOOLCHAIN_PATH "" CACHE PATH "bin directory of arm-none-eabi-gcc, empty for PATH")
+if(ARM_TOOLCHAIN_PATH)
+	set(ARM_TOOLCHAIN_PREFIX "${ARM_TOOLCHAIN_PATH}/arm-none-eabi-")
+else()
+	set(ARM_TOOLCHAIN_PREFIX "arm-none-eabi-")
+endif()
+
+set(CMAKE_C_COMPILER "${ARM_TOOLCHAIN_PREFIX}gcc")
+set(CMAKE_ASM_COMPILER "${ARM_TOOLCHAIN_PREFIX}gcc")
+set(CMAKE_OBJCOPY "${ARM_TOOLCHAIN_PREFIX}objcopy")
+set(CMAKE_SIZE "${ARM_TOOLCHAIN_PREFIX}size")
+
+# .o objects like the STM32CubeIDE build (Generic defaults to .obj),
+# STM32L476RGTX_FLASH.ld selects the interrupt handlers by object name
+set(CMAKE_USER_MAKE_RULES_OVERRIDE "${CMAKE_CURRENT_LIST_DIR}/arm-none-eabi-rules.cmake")
+
+# no executables can run during the compiler checks
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+# STM32L476RG: Cortex-M4 with single precision FPU, hard-float ABI
+set(ARM_CPU_FLAGS "-mcpu=cortex-m4 -mthumb -mfpu=fpv4-sp-d16 -mfloat-abi=hard")
+set(CMAKE_C_FLAGS_INIT "${ARM_CPU_FLAGS}")
+set(CMAKE_ASM_FLAGS_INIT "${ARM_CPU_FLAGS} -x assembler-with-cpp")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "${ARM_CPU_FLAGS} --specs=nano.specs --specs=nosys.specs")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
@@ -0,0 +1,22 @@
+# Prints the arm-none-eabi-size difference of two firmware images, run by the
+# printf_float_size target:
+#   cmake -DSIZE=<size tool> -DBASE=<elf> -DOTHER=<elf> -DLABEL=<text> -P cmake/size_delta.cmake
+
+foreach(image BASE OTHER)
+	execute_process(COMMAND ${SIZE} ${${image}} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+	# Berkeley format: text data bss dec hex filename
+	if(NOT result EQUAL 0 OR NOT output MATCHES "\n[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)")
+		message(FATAL_ERROR "${SIZE} ${${image}} failed:\n${output}")
+	endif()
+	set(${image}_TEXT ${CMAKE_MATCH_1})
+	set(${image}_DATA ${CMAKE_MATCH_2})
+	set(${image}_BSS ${CMAKE_MATCH_3})
+endforeach()
+
+math(EXPR TEXT_DELTA "${OTHER_TEXT} - ${BASE_TEXT}")
+math(EXPR DATA_DELTA "${OTHER_DATA} - ${BASE_DATA}")
+math(EXPR BSS_DELTA "${OTHER_BSS} - ${BASE_BSS}")
+math(EXPR FLASH_DELTA "${TEXT_DELTA} + ${DATA_DELTA}")
+
+message("${LABEL}: text ${BASE_TEXT} -> ${OTHER_TEXT} (${TEXT_DELTA}), data ${BASE_DATA} -> ${OTHER_DATA} (${DATA_DELTA}), "
+	"bss ${BASE_BSS} -> ${OTHER_BSS} (${BSS_DELTA}), flash ${FLASH_DELTA} bytes")